@@ -0,0 +1,104 @@
+#include "execution_engine.hpp"
+#include "interpreter.hpp"
+#include "io/headless_backend.hpp"
+
+#include "cxxopts.hpp"
+#include <SDL_log.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace std::literals::string_literals;
+
+namespace
+{
+	// Register only loop, so the benchmark measures loop overhead rather than any single instruction
+	constexpr auto default_program = std::array<uint8_t, 12>{
+		0x60, 0x05, // LD V0, 0x05
+		0x71, 0x01, // ADD V1, 0x01
+		0x82, 0x14, // ADD V2, V1
+		0x83, 0x25, // SUB V3, V2
+		0x84, 0x36, // SHR V4, V3
+		0x12, 0x02  // JP 0x202
+	};
+
+	constexpr auto batch_sizes = std::array<size_t, 7>{1, 4, 16, 64, 256, 1024, 4096};
+
+	[[nodiscard]] auto set_up_options()
+	{
+		auto opts = cxxopts::Options("chip8-cpp-batch-size-bench"s,
+			"Measures headless instructions per second for different batch sizes"s);
+
+		opts.add_options()
+			("h, help"s, "Show help screen"s)
+			("r, rom"s, "Path to chip8 rom file (built-in register loop if not set)"s, cxxopts::value<std::string>())
+			("i, instructions"s, "Number of instructions per measurement"s,
+				cxxopts::value<size_t>()->default_value("20000000"s))
+			("e, engine"s, "Execution engine (interpreter, threaded, specialized, jit)"s,
+				cxxopts::value<std::string>()->default_value("interpreter"s));
+
+		return opts;
+	}
+
+	[[nodiscard]] auto write_default_rom()
+	{
+		const auto path = std::filesystem::temp_directory_path() / "chip8_cpp_batch_size_bench.ch8";
+		auto writer = std::ofstream(path, std::ios_base::binary | std::ios_base::trunc);
+		writer.write(reinterpret_cast<const char*>(default_program.data()), default_program.size());
+		return path;
+	}
+
+	[[nodiscard]] double measure(const std::filesystem::path& rom_path, chip8::execution_engine engine,
+		size_t batch_size, size_t instruction_count)
+	{
+		auto backend = chip8::headless_backend();
+		auto interpreter = chip8::interpreter(rom_path, backend, 0ns, engine);
+		interpreter.set_batch_size(batch_size);
+
+		const auto start_time = std::chrono::steady_clock::now();
+		const auto executed = interpreter.run(instruction_count);
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time);
+		return executed / elapsed.count();
+	}
+}
+
+int main(int argc, char* argv[]) try
+{
+	auto options = set_up_options();
+	const auto parse_result = options.parse(argc, argv);
+	if (parse_result.count("help"))
+	{
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, options.help().c_str());
+		return EXIT_SUCCESS;
+	}
+
+	const auto engine_name = parse_result["engine"].as<std::string>();
+	const auto engine = chip8::parse_execution_engine_name(engine_name);
+	if (!engine)
+		throw std::invalid_argument("Unknown execution engine "s + engine_name);
+
+	const auto is_default_rom = (parse_result.count("rom") == 0);
+	const auto rom_path = is_default_rom ? write_default_rom() : std::filesystem::path{parse_result["rom"].as<std::string>()};
+	const auto instruction_count = parse_result["instructions"].as<size_t>();
+
+	// Batch size of one processes events, timers and clock after every instruction, as without batching
+	const auto unbatched_ips = measure(rom_path, *engine, 1, instruction_count);
+	for (const auto batch_size : batch_sizes)
+	{
+		const auto ips = (batch_size == 1) ? unbatched_ips : measure(rom_path, *engine, batch_size, instruction_count);
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Batch size %5zu: %12.0f instructions per second (%.2fx)",
+			batch_size, ips, ips / unbatched_ips);
+	}
+
+	if (is_default_rom)
+		std::filesystem::remove(rom_path);
+
+	return EXIT_SUCCESS;
+}
+catch(std::exception& e)
+{
+	SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Unhandled exception: %s", e.what());
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+#include "aot/code_analysis.hpp"
+
+#include "instructions.hpp"
+#include "opcode_handlers.hpp"
+
+#include <algorithm>
+
+using namespace chip8;
+
+namespace
+{
+	[[nodiscard]] constexpr bool is_in_memory(size_t address) noexcept
+	{
+		return address + 2 <= constants::mem_size;
+	}
+}
+
+aot::code_analysis aot::analyse_code(const memory_t& mem)
+{
+	auto analysis = code_analysis{};
+	auto pending = std::vector<uint16_t>{constants::code_start};
+	analysis.leaders[constants::code_start] = true;
+
+	const auto add_successor = [&analysis, &pending](size_t address, bool is_leader)
+	{
+		if (!is_in_memory(address))
+			return;
+
+		if (is_leader)
+			analysis.leaders[address] = true;
+
+		if (!analysis.reachable[address])
+			pending.push_back(uint16_t(address));
+	};
+
+	while (!pending.empty())
+	{
+		const auto address = pending.back();
+		pending.pop_back();
+		if (analysis.reachable[address])
+			continue;
+
+		analysis.reachable[address] = true;
+		const auto instr = opcode_handlers::decode(instructions::fetch(mem, address));
+		const auto next = size_t{address} + 2;
+
+		switch (instr.op)
+		{
+			case opcode::jp:
+				add_successor(instr.nnn, true);
+				break;
+
+			case opcode::call:
+				add_successor(instr.nnn, true);
+				add_successor(next, true);
+				break;
+
+			case opcode::se_reg_byte:
+			case opcode::sne_reg_byte:
+			case opcode::se_reg_reg:
+			case opcode::sne_reg_reg:
+			case opcode::skp_reg:
+			case opcode::sknp_reg:
+				add_successor(next, true);
+				add_successor(next + 2, true);
+				break;
+
+			case opcode::jp_v0_addr:
+				analysis.dynamic_jumps.push_back(address);
+				break;
+
+			// Returns go back past a call, which already is a leader
+			case opcode::ret:
+			case opcode::illegal:
+				break;
+
+			default:
+				add_successor(next, false);
+				break;
+		}
+	}
+
+	std::ranges::sort(analysis.dynamic_jumps);
+	return analysis;
+}
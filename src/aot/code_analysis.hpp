@@ -0,0 +1,29 @@
+#ifndef AOT_CODE_ANALYSIS_HPP
+#define AOT_CODE_ANALYSIS_HPP
+
+#include "constants.hpp"
+#include "types.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace chip8::aot
+{
+	/*	Instructions reachable from code start by following fall through, skips, jumps and calls.
+	 *	Bits are set for the first byte of an instruction. Leaders are addresses where a basic block has to
+	 *	start: code start, jump, call and skip targets and instructions following a control transfer.
+	 *	Targets of JP V0, addr depend on V0, so those instructions are only recorded as dynamic jumps.
+	 */
+	struct code_analysis
+	{
+		std::bitset<constants::mem_size> reachable;
+		std::bitset<constants::mem_size> leaders;
+		std::vector<uint16_t> dynamic_jumps;
+	};
+
+	// Analyses memory as it is right after loading a rom, code written at runtime is not visible here
+	[[nodiscard]] code_analysis analyse_code(const memory_t& mem);
+}
+
+#endif /* AOT_CODE_ANALYSIS_HPP */
@@ -0,0 +1,222 @@
+#include "aot/code_generator.hpp"
+
+#include "aot/code_analysis.hpp"
+#include "aot/program.hpp"
+#include "instructions.hpp"
+#include "opcode_handlers.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using namespace chip8;
+using namespace std::literals::string_literals;
+
+namespace
+{
+	[[nodiscard]] std::string hex(size_t value, int digit_count = 1)
+	{
+		auto str = std::ostringstream{"0x"s, std::ios::ate};
+		str << std::uppercase << std::hex << std::setfill('0') << std::setw(digit_count) << value;
+		return str.str();
+	}
+
+	[[nodiscard]] std::string byte_literal(std::byte value)
+	{
+		return "std::byte{"s + hex(std::to_integer<size_t>(value), 2) + "}"s;
+	}
+
+	[[nodiscard]] std::string call_x_y(std::string_view operation, const decoded_instruction& instr)
+	{
+		return "instructions::"s + std::string(operation) + "(regs, "s + std::to_string(instr.x) + ", "s +
+			std::to_string(instr.y) + ");"s;
+	}
+
+	[[nodiscard]] std::string call_x_kk(std::string_view operation, const decoded_instruction& instr)
+	{
+		return "instructions::"s + std::string(operation) + "(regs, "s + std::to_string(instr.x) + ", "s +
+			byte_literal(instr.kk) + ");"s;
+	}
+
+	[[nodiscard]] std::string call_x(std::string_view operation, const decoded_instruction& instr)
+	{
+		return "instructions::"s + std::string(operation) + "(regs, "s + std::to_string(instr.x) + ");"s;
+	}
+
+	// Instructions that only touch registers and fall through to the next instruction
+	[[nodiscard]] std::string translate_regular(const decoded_instruction& instr)
+	{
+		switch (instr.op)
+		{
+			case opcode::ld_reg_byte: return call_x_kk("ld_reg_byte", instr);
+			case opcode::add_reg_byte: return call_x_kk("add_reg_byte", instr);
+			case opcode::ld_reg_reg: return call_x_y("ld_reg_reg", instr);
+			case opcode::or_reg_reg: return call_x_y("or_reg_reg", instr);
+			case opcode::and_reg_reg: return call_x_y("and_reg_reg", instr);
+			case opcode::xor_reg_reg: return call_x_y("xor_reg_reg", instr);
+			case opcode::add_reg_reg: return call_x_y("add_reg_reg", instr);
+			case opcode::sub_reg_reg: return call_x_y("sub_reg_reg", instr);
+			case opcode::shr_reg_reg: return call_x("shr_reg_reg", instr);
+			case opcode::subn_reg_reg: return call_x_y("subn_reg_reg", instr);
+			case opcode::shl_reg_reg: return call_x("shl_reg_reg", instr);
+			case opcode::ld_i_addr: return "instructions::ld_i_addr(regs, "s + hex(instr.nnn) + ");"s;
+			case opcode::add_i_reg: return call_x("add_i_reg", instr);
+			case opcode::ld_f_reg: return call_x("ld_f_reg", instr);
+			default: return {};
+		}
+	}
+
+	// Instructions that end a block, PC is left where interpreter handlers would leave it. Statements are
+	// separated by new lines. CALL and RET are left for the interpreter, which faults on stack overflow and
+	// underflow
+	[[nodiscard]] std::string translate_terminator(const decoded_instruction& instr, uint16_t address)
+	{
+		const auto set_pc = "regs.pc = "s + hex(address) + ";\n"s;
+		switch (instr.op)
+		{
+			case opcode::jp:
+				return (instr.nnn == address) ? std::string{} : "instructions::jp(regs, "s + hex(instr.nnn) + ");"s;
+			case opcode::se_reg_byte: return set_pc + call_x_kk("se_reg_byte", instr) + "\nregs.pc += 2;"s;
+			case opcode::sne_reg_byte: return set_pc + call_x_kk("sne_reg_byte", instr) + "\nregs.pc += 2;"s;
+			case opcode::se_reg_reg: return set_pc + call_x_y("se_reg_reg", instr) + "\nregs.pc += 2;"s;
+			case opcode::sne_reg_reg: return set_pc + call_x_y("sne_reg_reg", instr) + "\nregs.pc += 2;"s;
+			default: return {};
+		}
+	}
+
+	void append_statements(std::string& body, std::string_view statements)
+	{
+		auto lines = std::istringstream{std::string(statements)};
+		for (auto line = std::string{}; std::getline(lines, line);)
+			body += "\t\t"s + line + "\n"s;
+	}
+
+	[[nodiscard]] bool is_translatable(const decoded_instruction& instr, uint16_t address)
+	{
+		return !translate_regular(instr).empty() || !translate_terminator(instr, address).empty();
+	}
+
+	struct block_source
+	{
+		uint16_t start_address;
+		uint16_t end_address;
+		uint16_t instruction_count;
+		std::string body;
+	};
+
+	[[nodiscard]] block_source translate_block(const memory_t& mem, const aot::code_analysis& analysis,
+		uint16_t start_address, size_t code_end)
+	{
+		auto block = block_source{start_address, start_address, 0, {}};
+		while (block.instruction_count < aot::max_block_instructions && block.end_address + size_t{2} <= code_end)
+		{
+			const auto address = block.end_address;
+			if (address != start_address && analysis.leaders[address])
+				break;
+
+			const auto instr = opcode_handlers::decode(instructions::fetch(mem, address));
+			if (const auto regular = translate_regular(instr); !regular.empty())
+			{
+				append_statements(block.body, regular);
+				block.end_address += 2;
+				++block.instruction_count;
+				continue;
+			}
+
+			if (const auto terminator = translate_terminator(instr, address); !terminator.empty())
+			{
+				append_statements(block.body, terminator);
+				block.end_address += 2;
+				++block.instruction_count;
+				return block;
+			}
+
+			break;
+		}
+
+		// Block falls through to an instruction it doesn't contain
+		append_statements(block.body, "regs.pc = "s + hex(block.end_address) + ";"s);
+		return block;
+	}
+
+	[[nodiscard]] std::string function_name(uint16_t address)
+	{
+		return "block_"s + hex(address);
+	}
+}
+
+aot::generated_program aot::generate_program(std::string_view name, std::span<const std::byte> rom)
+{
+	auto mem = memory_t{};
+	if (rom.size() > constants::mem_size - constants::code_start)
+		throw std::invalid_argument("Rom "s + std::string(name) + " does not fit into memory"s);
+
+	std::ranges::copy(rom, mem.begin() + constants::code_start);
+	const auto analysis = analyse_code(mem);
+	const auto code_end = constants::code_start + rom.size();
+
+	auto result = generated_program{{}, 0, analysis.reachable.count(), 0, analysis.dynamic_jumps.size()};
+	auto blocks = std::vector<block_source>{};
+
+	// Blocks start at leaders and after instructions left for the interpreter
+	for (auto address = size_t{constants::code_start}; address + 2 <= code_end; ++address)
+	{
+		if (!analysis.reachable[address])
+			continue;
+
+		const auto is_after_untranslated = address >= 2 && analysis.reachable[address - 2] &&
+			!is_translatable(opcode_handlers::decode(instructions::fetch(mem, uint16_t(address - 2))),
+				uint16_t(address - 2));
+		if (!analysis.leaders[address] && !is_after_untranslated)
+			continue;
+
+		auto block = translate_block(mem, analysis, uint16_t(address), code_end);
+		if (block.instruction_count == 0)
+			continue;
+
+		result.translated_instruction_count += block.instruction_count;
+		blocks.push_back(std::move(block));
+	}
+
+	result.block_count = blocks.size();
+
+	auto source = std::ostringstream{};
+	source << "// Generated by chip8-cpp-aot from " << name << ", do not edit\n"
+		"#include \"aot/program.hpp\"\n"
+		"#include \"instructions.hpp\"\n\n"
+		"#include <array>\n\n"
+		"using namespace chip8;\n\n"
+		"namespace\n{\n";
+
+	source << "\t// Reachable instructions: " << result.reachable_instruction_count << ", translated: " <<
+		result.translated_instruction_count << "\n";
+	for (const auto address : analysis.dynamic_jumps)
+		source << "\t// JP V0, addr at " << hex(address) << " is left for the interpreter\n";
+
+	source << "\tconstexpr auto rom = std::array<std::byte, " << rom.size() << ">{";
+	for (size_t idx = 0; idx < rom.size(); ++idx)
+		source << ((idx % 12 == 0) ? "\n\t\t" : " ") << byte_literal(rom[idx]) << ",";
+	source << "\n\t};\n\n";
+
+	for (const auto& block : blocks)
+	{
+		source << "\tvoid " << function_name(block.start_address) <<
+			"(registers& regs, [[maybe_unused]] stack_t& stack)\n\t{\n";
+
+		source << block.body << "\t}\n\n";
+	}
+
+	source << "\tconstexpr auto blocks = std::array<aot::block, " << blocks.size() << ">{{\n";
+	for (const auto& block : blocks)
+		source << "\t\t{" << hex(block.start_address) << ", " << hex(block.end_address) << ", " <<
+			block.instruction_count << ", &" << function_name(block.start_address) << "},\n";
+	source << "\t}};\n\n";
+
+	source << "\tconstexpr auto program = aot::program{\"" << name << "\", rom, blocks};\n"
+		"\t[[maybe_unused]] const auto is_registered = aot::register_program(program);\n"
+		"}\n";
+
+	result.source = source.str();
+	return result;
+}
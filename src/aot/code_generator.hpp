@@ -0,0 +1,29 @@
+#ifndef AOT_CODE_GENERATOR_HPP
+#define AOT_CODE_GENERATOR_HPP
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace chip8::aot
+{
+	struct generated_program
+	{
+		std::string source;
+		size_t block_count;
+		size_t reachable_instruction_count;
+		size_t translated_instruction_count;
+		size_t dynamic_jump_count;
+	};
+
+	/*	Generates a C++ translation unit that registers rom as an aot::program under name.
+	 *	Every reachable basic block becomes a function calling handlers from instructions.hpp. A block ends
+	 *	after JP, CALL, RET or SE/SNE, before the next leader and before any instruction which has to go
+	 *	through the interpreter (display, keyboard, timer, memory, RND and JP V0 instructions).
+	 *	Jumps to themselves are left for the interpreter too, so it can recognise them as idle loops.
+	 */
+	[[nodiscard]] generated_program generate_program(std::string_view name, std::span<const std::byte> rom);
+}
+
+#endif /* AOT_CODE_GENERATOR_HPP */
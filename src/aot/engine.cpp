@@ -0,0 +1,51 @@
+#include "aot/engine.hpp"
+
+#include "block_invalidation.hpp"
+
+using namespace chip8;
+using namespace chip8::aot;
+
+engine::engine(const program& program) noexcept :
+	m_program{program}
+{
+	this->invalidate_all();
+}
+
+size_t engine::execute(registers& regs, stack_t& stack, size_t tick_budget) const
+{
+	if (regs.pc >= this->m_blocks.size())
+		return 0;
+
+	const auto* entry = this->m_blocks[regs.pc];
+	if (!entry || entry->instruction_count > tick_budget)
+		return 0;
+
+	entry->code(regs, stack);
+	return entry->instruction_count;
+}
+
+void engine::invalidate(uint16_t address, size_t byte_count) noexcept
+{
+	const auto range = find_overlapping_block_starts(this->m_translated_bytes, address, byte_count,
+		max_block_instructions);
+
+	for (auto idx = range.first; idx < range.last; ++idx)
+	{
+		auto& entry = this->m_blocks[idx];
+		if (entry && entry->end_address > address)
+			entry = nullptr;
+	}
+}
+
+void engine::invalidate_all() noexcept
+{
+	this->m_blocks.fill(nullptr);
+	this->m_translated_bytes.reset();
+
+	for (const auto& block : this->m_program.blocks)
+	{
+		this->m_blocks[block.start_address] = &block;
+		for (auto idx = size_t{block.start_address}; idx < block.end_address; ++idx)
+			this->m_translated_bytes[idx] = true;
+	}
+}
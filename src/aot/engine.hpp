@@ -0,0 +1,41 @@
+#ifndef AOT_ENGINE_HPP
+#define AOT_ENGINE_HPP
+
+#include "aot/program.hpp"
+#include "constants.hpp"
+#include "registers.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8::aot
+{
+	/*	Executes blocks of a program translated ahead of time.
+	 *	Blocks are dropped once memory they were translated from is written to, addresses without a block
+	 *	and instructions that weren't translated are left for the interpreter.
+	 */
+	struct engine
+	{
+		explicit engine(const program& program) noexcept;
+
+		// Executes a single block at current PC. Returns number of executed instructions, zero means that
+		// the instruction at PC has to be executed by the interpreter, which is also the case for blocks
+		// longer than tick_budget
+		[[nodiscard]] size_t execute(registers& regs, stack_t& stack, size_t tick_budget) const;
+
+		void invalidate(uint16_t address, size_t byte_count) noexcept;
+
+		// Restores every block of the program, memory has to hold the program's rom again
+		void invalidate_all() noexcept;
+
+	private:
+		const program& m_program;
+		std::array<const block*, constants::mem_size> m_blocks;
+		std::bitset<constants::mem_size> m_translated_bytes;
+	};
+}
+
+#endif /* AOT_ENGINE_HPP */
@@ -0,0 +1,101 @@
+#include "aot/code_generator.hpp"
+
+#include "cxxopts.hpp"
+#include <SDL_log.h>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::literals::string_literals;
+
+namespace
+{
+	[[nodiscard]] auto set_up_options()
+	{
+		auto opts = cxxopts::Options("chip8-cpp-aot"s, "Translates a chip8 rom into a C++ source file"s);
+
+		opts.add_options()
+			("h, help"s, "Show help screen"s)
+			("r, rom"s, "Path to chip8 (*.ch8) rom file"s, cxxopts::value<std::string>())
+			("o, output"s, "Path to generated C++ source file"s, cxxopts::value<std::string>())
+			("n, name"s, "Program name (rom file name when not given)"s, cxxopts::value<std::string>())
+			("d, debug"s, "Enable debug strings"s, cxxopts::value<bool>());
+
+		return opts;
+	}
+
+	[[nodiscard]] std::vector<std::byte> read_rom(const std::filesystem::path& rom_path)
+	{
+		auto reader = std::ifstream(rom_path, std::ios::binary);
+		if (!reader)
+			throw std::runtime_error("Unable to open file "s + rom_path.string() + " for reading"s);
+
+		auto rom = std::vector<std::byte>{};
+		std::transform(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>(),
+			std::back_inserter(rom), [](char value)
+			{
+				return std::byte(value);
+			});
+
+		return rom;
+	}
+
+	// Name ends up in a string literal of generated code, so only a safe subset of characters is kept
+	[[nodiscard]] std::string sanitize_name(std::string name)
+	{
+		std::ranges::replace_if(name, [](char value)
+		{
+			return !std::isalnum(static_cast<unsigned char>(value)) && value != '-' && value != '.';
+		}, '_');
+
+		return name;
+	}
+}
+
+int main(int argc, char* argv[]) try
+{
+	auto options = set_up_options();
+	const auto parse_result = options.parse(argc, argv);
+	if (parse_result.count("help"))
+	{
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, options.help().c_str());
+		return EXIT_SUCCESS;
+	}
+
+	if (parse_result["debug"].count())
+		SDL_LogSetAllPriority(SDL_LOG_PRIORITY_DEBUG);
+
+	if (!parse_result["rom"].count() || !parse_result["output"].count())
+	{
+		SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "No rom or output provided. Please use '-r/--rom' and "
+			"'-o/--output' arguments");
+		return EXIT_FAILURE;
+	}
+
+	const auto rom_path = std::filesystem::path(parse_result["rom"].as<std::string>());
+	const auto output_path = std::filesystem::path(parse_result["output"].as<std::string>());
+	const auto name = sanitize_name(parse_result["name"].count() ? parse_result["name"].as<std::string>() :
+		rom_path.filename().string());
+
+	const auto generated = chip8::aot::generate_program(name, read_rom(rom_path));
+
+	auto writer = std::ofstream(output_path);
+	if (!(writer << generated.source))
+		throw std::runtime_error("Unable to write "s + output_path.string());
+
+	SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "%s: %zu blocks, %zu of %zu reachable instructions translated, "
+		"%zu dynamic jumps", name.c_str(), generated.block_count, generated.translated_instruction_count,
+		generated.reachable_instruction_count, generated.dynamic_jump_count);
+
+	return EXIT_SUCCESS;
+}
+catch(std::exception& e)
+{
+	SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Unhandled exception: %s", e.what());
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,49 @@
+#include "aot/program.hpp"
+
+#include "constants.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace chip8;
+
+namespace
+{
+	[[nodiscard]] std::vector<const aot::program*>& get_registry()
+	{
+		// Function local, so it is constructed before the first static initializer registers a program
+		static auto registry = std::vector<const aot::program*>{};
+		return registry;
+	}
+
+	[[nodiscard]] bool is_loaded(const aot::program& program, const memory_t& mem) noexcept
+	{
+		const auto code = std::span(mem).first(constants::mem_size).subspan(constants::code_start);
+		if (program.rom.size() > code.size())
+			return false;
+
+		// Anything after the rom has to be zero, otherwise a longer rom starting the same way was loaded
+		return std::ranges::equal(program.rom, code.first(program.rom.size())) &&
+			std::ranges::all_of(code.subspan(program.rom.size()), [](std::byte value)
+			{
+				return value == std::byte{0x00};
+			});
+	}
+}
+
+bool aot::register_program(const program& program)
+{
+	get_registry().push_back(&program);
+	return true;
+}
+
+const aot::program* aot::find_program(const memory_t& mem) noexcept
+{
+	const auto& registry = get_registry();
+	const auto found = std::ranges::find_if(registry, [&mem](const program* program)
+	{
+		return is_loaded(*program, mem);
+	});
+
+	return (found != registry.end()) ? *found : nullptr;
+}
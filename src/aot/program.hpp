@@ -0,0 +1,46 @@
+#ifndef AOT_PROGRAM_HPP
+#define AOT_PROGRAM_HPP
+
+#include "registers.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace chip8::aot
+{
+	using block_function = void (*)(registers&, stack_t&);
+
+	// Translator never emits longer blocks, which bounds how far back a memory write has to look for them
+	static constexpr auto max_block_instructions = uint16_t{64};
+
+	// Basic block translated to C++, covering instructions in [start_address, end_address)
+	struct block
+	{
+		uint16_t start_address;
+		uint16_t end_address;
+		uint16_t instruction_count;
+		block_function code;
+	};
+
+	/*	Rom translated ahead of time by chip8-cpp-aot. Blocks are only valid for memory that matches the rom
+	 *	image, so programs are selected by comparing loaded memory with it.
+	 */
+	struct program
+	{
+		std::string_view name;
+		std::span<const std::byte> rom;
+		std::span<const block> blocks;
+	};
+
+	// Makes program available to find_program. Called from static initializers of generated code, so the
+	// program has to outlive every interpreter
+	bool register_program(const program& program);
+
+	// Returns registered program whose rom was loaded into memory or nullptr if there is none
+	[[nodiscard]] const program* find_program(const memory_t& mem) noexcept;
+}
+
+#endif /* AOT_PROGRAM_HPP */
@@ -0,0 +1,98 @@
+#include "batch/job.hpp"
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace chip8::batch;
+using namespace std::literals::string_literals;
+
+namespace
+{
+	[[nodiscard]] std::ifstream open_for_reading(const std::filesystem::path& path)
+	{
+		auto reader = std::ifstream(path);
+		if (!reader)
+			throw std::runtime_error("Unable to open file "s + path.string() + " for reading"s);
+
+		return reader;
+	}
+
+	[[nodiscard]] bool is_ignored_line(const std::string& line) noexcept
+	{
+		const auto first = line.find_first_not_of(" \t\r"s);
+		return first == std::string::npos || line[first] == '#';
+	}
+
+	[[nodiscard]] std::filesystem::path resolve_path(const std::filesystem::path& base_file,
+		const std::filesystem::path& path)
+	{
+		return path.is_absolute() ? path : base_file.parent_path() / path;
+	}
+
+	[[noreturn]] void throw_parse_error(const std::filesystem::path& path, size_t line_number)
+	{
+		throw std::runtime_error("Malformed line "s + std::to_string(line_number) + " in "s + path.string());
+	}
+}
+
+std::vector<job> chip8::batch::load_jobs(const std::filesystem::path& job_file_path)
+{
+	auto reader = open_for_reading(job_file_path);
+	auto jobs = std::vector<job>{};
+
+	auto line = std::string{};
+	for (size_t line_number = 1; std::getline(reader, line); ++line_number)
+	{
+		if (is_ignored_line(line))
+			continue;
+
+		auto line_reader = std::istringstream{line};
+		auto rom_path = std::string{};
+		auto instruction_count = size_t{0};
+		if (!(line_reader >> rom_path >> instruction_count))
+			throw_parse_error(job_file_path, line_number);
+
+		auto& added = jobs.emplace_back(job{resolve_path(job_file_path, rom_path), instruction_count, {}});
+
+		auto script_path = std::string{};
+		if (line_reader >> script_path)
+			added.input = load_input_script(resolve_path(job_file_path, script_path));
+	}
+
+	return jobs;
+}
+
+std::vector<input_event> chip8::batch::load_input_script(const std::filesystem::path& script_path)
+{
+	auto reader = open_for_reading(script_path);
+	auto events = std::vector<input_event>{};
+
+	auto line = std::string{};
+	for (size_t line_number = 1; std::getline(reader, line); ++line_number)
+	{
+		if (is_ignored_line(line))
+			continue;
+
+		auto line_reader = std::istringstream{line};
+		auto event = input_event{};
+		auto state = std::string{};
+		if (!(line_reader >> event.instruction >> std::hex >> event.key >> state) || event.key >= chip8::key_count ||
+			(state != "down"s && state != "up"s))
+		{
+			throw_parse_error(script_path, line_number);
+		}
+
+		if (!events.empty() && event.instruction < events.back().instruction)
+			throw_parse_error(script_path, line_number);
+
+		event.is_pressed = state == "down"s;
+		events.push_back(event);
+	}
+
+	return events;
+}
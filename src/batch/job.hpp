@@ -0,0 +1,35 @@
+#ifndef BATCH_JOB_HPP
+#define BATCH_JOB_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace chip8::batch
+{
+	// Key state change applied before the instruction with given index is executed
+	struct input_event
+	{
+		size_t instruction;
+		size_t key;
+		bool is_pressed;
+	};
+
+	struct job
+	{
+		std::filesystem::path rom_path;
+		size_t instruction_count;
+		std::vector<input_event> input;
+	};
+
+	/*	Job file lists one job per line: <rom path> <instruction count> [input script path]
+	 *	Input script lists one event per line in execution order: <instruction> <key (hex)> <down|up>
+	 *	Instruction counts are machine ticks, ticks skipped in idle loops and spent waiting for a key included.
+	 *	Relative paths are resolved against the directory of the file they appear in. Empty lines and
+	 *	lines starting with '#' are ignored in both files.
+	 */
+	[[nodiscard]] std::vector<job> load_jobs(const std::filesystem::path& job_file_path);
+	[[nodiscard]] std::vector<input_event> load_input_script(const std::filesystem::path& script_path);
+}
+
+#endif /* BATCH_JOB_HPP */
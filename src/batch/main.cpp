@@ -0,0 +1,131 @@
+#include "batch/job.hpp"
+#include "batch/runner.hpp"
+#include "execution_engine.hpp"
+#include "fault.hpp"
+
+#include "cxxopts.hpp"
+#include <SDL_log.h>
+
+#include <thread>
+
+using namespace std::literals::string_literals;
+
+namespace
+{
+	[[nodiscard]] auto set_up_options()
+	{
+		auto opts = cxxopts::Options("chip8-cpp-batch"s, "Runs many chip8 roms headless across all cores"s);
+
+		opts.add_options()
+			("h, help"s, "Show help screen"s)
+			("j, jobs"s, "Path to job file, one '<rom path> <instruction count> [input script]' per line"s,
+				cxxopts::value<std::string>())
+			("t, threads"s, "Number of worker threads (0 - one per hardware thread)"s,
+				cxxopts::value<size_t>()->default_value("0"s))
+			("d, debug"s, "Enable debug strings"s, cxxopts::value<bool>())
+			("f, freq"s, "Speed of emulation, timers follow machine time at this frequency"s,
+				cxxopts::value<int>()->default_value("500"s))
+			("e, engine"s, "Execution engine (interpreter, threaded, specialized, jit, aot)"s,
+				cxxopts::value<std::string>()->default_value("interpreter"s))
+			("faults"s, "Fault policy (halt - end faulting job, skip - skip faulting instructions, "
+				"trap - end faulting job like halt)"s,
+				cxxopts::value<std::string>()->default_value("halt"s))
+			("seed"s, "Seed for random numbers, job n uses seed + n"s,
+				cxxopts::value<uint64_t>()->default_value("0"s));
+
+		return opts;
+	}
+
+	[[nodiscard]] auto parse_worker_count(const cxxopts::ParseResult& parse_result)
+	{
+		const auto count = parse_result["threads"].as<size_t>();
+		return (count == 0) ? std::max(size_t{std::thread::hardware_concurrency()}, size_t{1}) : count;
+	}
+
+	[[nodiscard]] auto parse_machine_tick_period(const cxxopts::ParseResult& parse_result)
+	{
+		const auto freq = parse_result["freq"].as<int>();
+		if (freq <= 0)
+			throw std::invalid_argument("Frequency has to be positive"s);
+
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds{1}) / freq;
+	}
+
+	[[nodiscard]] auto parse_execution_engine(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["engine"].as<std::string>();
+		if (const auto engine = chip8::parse_execution_engine_name(name))
+			return *engine;
+
+		throw std::invalid_argument("Unknown execution engine "s + name);
+	}
+
+	[[nodiscard]] auto parse_fault_policy(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["faults"].as<std::string>();
+		if (const auto policy = chip8::parse_fault_policy_name(name))
+			return *policy;
+
+		throw std::invalid_argument("Unknown fault policy "s + name);
+	}
+
+	void log_report(const std::vector<chip8::batch::job>& jobs, const chip8::batch::report& report)
+	{
+		auto failed_count = size_t{0};
+		for (size_t idx = 0; idx < jobs.size(); ++idx)
+		{
+			if (report.results[idx].error.empty())
+				continue;
+
+			++failed_count;
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Job %zu (%s) failed: %s", idx,
+				jobs[idx].rom_path.string().c_str(), report.results[idx].error.c_str());
+		}
+
+		const auto seconds = std::chrono::duration<double>(report.elapsed).count();
+		for (size_t idx = 0; idx < report.executed_instructions_per_worker.size(); ++idx)
+		{
+			const auto executed = report.executed_instructions_per_worker[idx];
+			SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Worker %zu executed %zu instructions (%.0f per second)",
+				idx, executed, (seconds > 0.0) ? executed / seconds : 0.0);
+		}
+
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Jobs: %zu, failed: %zu, workers: %zu, steals: %zu",
+			jobs.size(), failed_count, report.executed_instructions_per_worker.size(), report.steal_count);
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Executed %zu instructions in %.3f s (%.0f instructions per second)",
+			report.executed_instructions, seconds, report.get_instructions_per_second());
+	}
+}
+
+int main(int argc, char* argv[]) try
+{
+	auto options = set_up_options();
+	const auto parse_result = options.parse(argc, argv);
+	if (parse_result.count("help"))
+	{
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, options.help().c_str());
+		return EXIT_SUCCESS;
+	}
+
+	if (parse_result["debug"].count())
+		SDL_LogSetAllPriority(SDL_LOG_PRIORITY_DEBUG);
+
+	if (!parse_result["jobs"].count())
+	{
+		SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "No job file provided. Please use '-j/--jobs' argument");
+		return EXIT_FAILURE;
+	}
+
+	const auto jobs = chip8::batch::load_jobs(parse_result["jobs"].as<std::string>());
+	const auto report = chip8::batch::run_jobs(jobs, parse_worker_count(parse_result),
+		parse_execution_engine(parse_result), parse_machine_tick_period(parse_result),
+		parse_result["seed"].as<uint64_t>(), parse_fault_policy(parse_result));
+	log_report(jobs, report);
+
+	return EXIT_SUCCESS;
+}
+catch(std::exception& e)
+{
+	SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Unhandled exception: %s", e.what());
+	return EXIT_FAILURE;
+}
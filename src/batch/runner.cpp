@@ -0,0 +1,141 @@
+#include "batch/runner.hpp"
+
+#include "batch/work_stealing_pool.hpp"
+#include "clock_source.hpp"
+#include "interpreter.hpp"
+#include "io/headless_backend.hpp"
+
+#include <exception>
+#include <memory>
+
+using namespace chip8;
+using namespace chip8::batch;
+
+namespace
+{
+	// Machine that is reused for every job executed by a single worker
+	struct instance
+	{
+		headless_backend backend;
+		std::unique_ptr<chip8::interpreter> interpreter;
+	};
+
+	// Aligned to keep state of different workers on different cache lines
+	struct alignas(64) worker_state
+	{
+		std::unique_ptr<instance> machine;
+		size_t executed_instructions = 0;
+	};
+
+	[[nodiscard]] chip8::interpreter& prepare_instance(worker_state& worker, const job& job,
+		execution_engine engine, std::chrono::nanoseconds machine_tick_period, uint64_t seed, fault_policy policy)
+	{
+		if (!worker.machine)
+			worker.machine = std::make_unique<instance>();
+
+		auto& machine = *worker.machine;
+		machine.backend.reset();
+
+		if (machine.interpreter)
+			machine.interpreter->reset(job.rom_path);
+		else
+		{
+			machine.interpreter = std::make_unique<chip8::interpreter>(job.rom_path, machine.backend,
+				machine_tick_period, engine);
+			machine.interpreter->set_clock_source(clock_source::virtual_time);
+		}
+
+		machine.interpreter->set_seed(seed);
+		machine.interpreter->set_fault_policy(policy);
+		return *machine.interpreter;
+	}
+
+	// Job stopped by a fault doesn't go any further, even when its machine would retry a trapped instruction
+	[[nodiscard]] size_t execute_job(chip8::interpreter& interpreter, headless_backend& backend, const job& job)
+	{
+		auto executed = size_t{0};
+		for (const auto& event : job.input)
+		{
+			if (event.instruction >= job.instruction_count)
+				break;
+
+			if (event.instruction > executed)
+				executed += interpreter.run(event.instruction - executed);
+
+			if (interpreter.is_faulted())
+				return executed;
+
+			if (event.is_pressed)
+				backend.press_key(event.key);
+			else
+				backend.release_key(event.key);
+		}
+
+		if (job.instruction_count > executed)
+			executed += interpreter.run(job.instruction_count - executed);
+
+		return executed;
+	}
+}
+
+double report::get_instructions_per_second() const noexcept
+{
+	const auto seconds = std::chrono::duration<double>(this->elapsed).count();
+	return (seconds > 0.0) ? this->executed_instructions / seconds : 0.0;
+}
+
+report chip8::batch::run_jobs(const std::vector<job>& jobs, size_t worker_count, execution_engine engine,
+	std::chrono::nanoseconds machine_tick_period, uint64_t seed, fault_policy policy)
+{
+	auto pool = work_stealing_pool(worker_count);
+	auto workers = std::vector<worker_state>(pool.get_worker_count());
+	auto results = std::vector<job_result>(jobs.size());
+
+	auto tasks = std::vector<work_stealing_pool::task>{};
+	tasks.reserve(jobs.size());
+	for (size_t job_idx = 0; job_idx < jobs.size(); ++job_idx)
+	{
+		tasks.emplace_back([&, job_idx](size_t worker_idx)
+		{
+			auto& worker = workers[worker_idx];
+			auto& result = results[job_idx];
+
+			try
+			{
+				auto& interpreter = prepare_instance(worker, jobs[job_idx], engine, machine_tick_period,
+					seed + job_idx, policy);
+				result.machine_ticks = execute_job(interpreter, worker.machine->backend, jobs[job_idx]);
+				result.executed_instructions = result.machine_ticks - interpreter.get_skipped_tick_count() -
+					interpreter.get_key_wait_tick_count();
+				result.fault_count = interpreter.get_fault_count();
+
+				// Machine is fully restored by reset, so it is kept for the next job
+				if (interpreter.is_faulted())
+					result.error = describe_fault(interpreter.get_last_fault());
+			}
+			catch (const std::exception& e)
+			{
+				result.error = e.what();
+
+				// Machine state is unknown after a failure, next job gets a new instance
+				worker.machine.reset();
+			}
+
+			worker.executed_instructions += result.executed_instructions;
+		});
+	}
+
+	const auto start_time = std::chrono::steady_clock::now();
+	pool.run(std::move(tasks));
+	const auto elapsed = std::chrono::steady_clock::now() - start_time;
+
+	auto out = report{std::move(results), {}, 0, pool.get_steal_count(),
+		std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)};
+	for (const auto& worker : workers)
+	{
+		out.executed_instructions_per_worker.push_back(worker.executed_instructions);
+		out.executed_instructions += worker.executed_instructions;
+	}
+
+	return out;
+}
@@ -0,0 +1,59 @@
+#ifndef BATCH_RUNNER_HPP
+#define BATCH_RUNNER_HPP
+
+#include "batch/job.hpp"
+#include "execution_engine.hpp"
+#include "fault.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace chip8::batch
+{
+	struct job_result
+	{
+		// Machine ticks the job ran for, which job and input event instruction counts refer to. Ticks skipped
+		// in idle loops and spent waiting for a key are included
+		size_t machine_ticks;
+
+		// Instructions that were actually executed
+		size_t executed_instructions;
+
+		// Faults raised by the job, skipped ones included
+		size_t fault_count;
+
+		// Empty if job finished without errors or faults stopping it
+		std::string error;
+	};
+
+	struct report
+	{
+		// Indexed the same way as jobs
+		std::vector<job_result> results;
+
+		// Only instructions that were actually executed count towards throughput
+		std::vector<size_t> executed_instructions_per_worker;
+
+		size_t executed_instructions;
+		size_t steal_count;
+		std::chrono::nanoseconds elapsed;
+
+		[[nodiscard]] double get_instructions_per_second() const noexcept;
+	};
+
+	/*	Runs every job headless at uncapped speed on worker_count threads.
+	 *	Jobs run in virtual time, every instruction lasts machine_tick_period, so timers change after the same
+	 *	instruction regardless of host load and a job always gives the same result for the same seed.
+	 *	Every worker keeps its own machine instance and reuses it for all jobs it executes, so workers
+	 *	don't share any mutable state while executing instructions. Errors only fail the job that caused them.
+	 *	Faults are handled by fault policy, a job stopped by a fault ends there and its worker goes on.
+	 *	Job with index n draws random numbers from seed + n, regardless of the worker that executes it.
+	 */
+	[[nodiscard]] report run_jobs(const std::vector<job>& jobs, size_t worker_count, execution_engine engine,
+		std::chrono::nanoseconds machine_tick_period, uint64_t seed = 0, fault_policy policy = fault_policy::halt);
+}
+
+#endif /* BATCH_RUNNER_HPP */
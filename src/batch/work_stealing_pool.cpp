@@ -0,0 +1,80 @@
+#include "batch/work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using namespace chip8::batch;
+
+work_stealing_pool::work_stealing_pool(size_t worker_count)
+{
+	for (size_t idx = 0; idx < std::max(worker_count, size_t{1}); ++idx)
+		this->m_queues.push_back(std::make_unique<worker_queue>());
+}
+
+void work_stealing_pool::run(std::vector<task> tasks)
+{
+	for (size_t idx = 0; idx < tasks.size(); ++idx)
+		this->m_queues[idx % this->m_queues.size()]->task_indices.push_back(idx);
+
+	auto workers = std::vector<std::jthread>{};
+	workers.reserve(this->m_queues.size() - 1);
+	for (size_t worker_idx = 1; worker_idx < this->m_queues.size(); ++worker_idx)
+		workers.emplace_back(&work_stealing_pool::work, this, worker_idx, std::ref(tasks));
+
+	// Calling thread is the first worker
+	this->work(0, tasks);
+}
+
+size_t work_stealing_pool::get_worker_count() const noexcept
+{
+	return this->m_queues.size();
+}
+
+size_t work_stealing_pool::get_steal_count() const noexcept
+{
+	auto steal_count = size_t{0};
+	for (const auto& queue : this->m_queues)
+		steal_count += queue->steal_count;
+
+	return steal_count;
+}
+
+void work_stealing_pool::work(size_t worker_idx, std::vector<task>& tasks)
+{
+	auto task_idx = size_t{0};
+	while (this->pop_own(worker_idx, task_idx) || this->steal(worker_idx, task_idx))
+		tasks[task_idx](worker_idx);
+}
+
+bool work_stealing_pool::pop_own(size_t worker_idx, size_t& task_idx)
+{
+	auto& queue = *this->m_queues[worker_idx];
+	const auto lock = std::scoped_lock(queue.mutex);
+	if (queue.task_indices.empty())
+		return false;
+
+	task_idx = queue.task_indices.back();
+	queue.task_indices.pop_back();
+	return true;
+}
+
+bool work_stealing_pool::steal(size_t worker_idx, size_t& task_idx)
+{
+	// Victims are visited starting from the next worker, so thieves don't all pick the same one
+	for (size_t offset = 1; offset < this->m_queues.size(); ++offset)
+	{
+		auto& victim = *this->m_queues[(worker_idx + offset) % this->m_queues.size()];
+		const auto lock = std::scoped_lock(victim.mutex);
+		if (victim.task_indices.empty())
+			continue;
+
+		task_idx = victim.task_indices.front();
+		victim.task_indices.pop_front();
+
+		// Counted on the victim while its lock is held
+		++victim.steal_count;
+		return true;
+	}
+
+	return false;
+}
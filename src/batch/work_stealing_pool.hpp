@@ -0,0 +1,47 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace chip8::batch
+{
+	/*	Runs independent tasks on a fixed number of worker threads.
+	 *	Every worker owns a queue, takes tasks from its back and, once it runs dry, steals from the front
+	 *	of other queues. Tasks never enqueue more work, so a worker exits when every queue is empty.
+	 */
+	struct work_stealing_pool
+	{
+		// Receives index of the worker that executes the task
+		using task = std::function<void(size_t)>;
+
+		explicit work_stealing_pool(size_t worker_count);
+
+		// Distributes tasks round robin between workers and blocks until all of them are executed
+		void run(std::vector<task> tasks);
+
+		[[nodiscard]] size_t get_worker_count() const noexcept;
+		[[nodiscard]] size_t get_steal_count() const noexcept;
+
+	private:
+		// Aligned to keep queues that belong to different workers on different cache lines
+		struct alignas(64) worker_queue
+		{
+			std::mutex mutex;
+			std::deque<size_t> task_indices;
+			size_t steal_count = 0;
+		};
+
+		void work(size_t worker_idx, std::vector<task>& tasks);
+		[[nodiscard]] bool pop_own(size_t worker_idx, size_t& task_idx);
+		[[nodiscard]] bool steal(size_t worker_idx, size_t& task_idx);
+
+		std::vector<std::unique_ptr<worker_queue>> m_queues;
+	};
+}
+
+#endif /* WORK_STEALING_POOL_HPP */
@@ -0,0 +1,43 @@
+#ifndef BLOCK_INVALIDATION_HPP
+#define BLOCK_INVALIDATION_HPP
+
+#include "constants.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8
+{
+	// Start addresses of translated blocks that can overlap a write, in [first, last)
+	struct block_start_range
+	{
+		size_t first;
+		size_t last;
+	};
+
+	/*	Finds start addresses of blocks, up to max_block_instructions long, that a memory write can overlap.
+	 *	The range is empty when the write doesn't touch any translated byte.
+	 */
+	[[nodiscard]] inline block_start_range find_overlapping_block_starts(
+		const std::bitset<constants::mem_size>& translated_bytes, uint16_t address, size_t byte_count,
+		size_t max_block_instructions) noexcept
+	{
+		const auto write_end = std::min(size_t{address} + byte_count, constants::mem_size);
+
+		auto is_translated = false;
+		for (auto idx = size_t{address}; idx < write_end; ++idx)
+			is_translated = is_translated || translated_bytes[idx];
+
+		if (!is_translated)
+			return {0, 0};
+
+		// Only blocks starting at most one maximum block length before the write can overlap it
+		const auto max_block_bytes = max_block_instructions * 2;
+		const auto first = (address > max_block_bytes) ? size_t{address} - max_block_bytes : size_t{0};
+		return {first, write_end};
+	}
+}
+
+#endif /* BLOCK_INVALIDATION_HPP */
@@ -0,0 +1,29 @@
+#ifndef CLOCK_SOURCE_HPP
+#define CLOCK_SOURCE_HPP
+
+#include <optional>
+#include <string_view>
+
+namespace chip8
+{
+	enum class clock_source
+	{
+		// Machine and timers follow host wall clock
+		host,
+		// Time is derived from number of executed instructions, instructions run as fast as host allows
+		virtual_time
+	};
+
+	// Maps command line clock source name to clock source, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<clock_source> parse_clock_source_name(std::string_view name) noexcept
+	{
+		if (name == "host")
+			return clock_source::host;
+		if (name == "virtual")
+			return clock_source::virtual_time;
+
+		return std::nullopt;
+	}
+}
+
+#endif /* CLOCK_SOURCE_HPP */
@@ -13,10 +13,14 @@ namespace chip8::constants
 	static constexpr auto audio_ampl = std::uint8_t {128};
 	static constexpr auto ch8_width = 64;
 	static constexpr auto ch8_height = 32;
+	static constexpr auto frame_period = std::chrono::duration_cast<std::chrono::nanoseconds>(1s) / 60;
 
 	// Memories
 	static constexpr auto v_reg_count = std::size_t {16};
 	static constexpr auto mem_size = std::size_t {4096};
+	static constexpr auto address_mask = std::uint16_t {0x0FFF};
+	// Longest access through I is LD [I], VF storing 16 registers
+	static constexpr auto mem_guard_size = std::size_t {16};
 	static constexpr auto stack_size = std::size_t {16};
 
 	// Other
@@ -0,0 +1,43 @@
+#ifndef EXECUTION_ENGINE_HPP
+#define EXECUTION_ENGINE_HPP
+
+#include <optional>
+#include <string_view>
+
+namespace chip8
+{
+	enum class execution_engine
+	{
+		interpreter,
+		threaded,
+		specialized,
+		jit,
+		aot
+	};
+
+	// Threaded dispatch relies on labels as values extension
+#if defined(__GNUC__) || defined(__clang__)
+	static constexpr auto is_threaded_dispatch_available = true;
+#else
+	static constexpr auto is_threaded_dispatch_available = false;
+#endif
+
+	// Maps command line engine name to engine, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<execution_engine> parse_execution_engine_name(std::string_view name) noexcept
+	{
+		if (name == "interpreter")
+			return execution_engine::interpreter;
+		if (name == "threaded")
+			return execution_engine::threaded;
+		if (name == "specialized")
+			return execution_engine::specialized;
+		if (name == "jit")
+			return execution_engine::jit;
+		if (name == "aot")
+			return execution_engine::aot;
+
+		return std::nullopt;
+	}
+}
+
+#endif /* EXECUTION_ENGINE_HPP */
@@ -0,0 +1,40 @@
+#include "fault.hpp"
+
+#include <cstddef>
+#include <iomanip>
+#include <sstream>
+
+using namespace chip8;
+using namespace std::literals::string_literals;
+
+namespace
+{
+	[[nodiscard]] std::string_view get_fault_name(fault kind) noexcept
+	{
+		switch (kind)
+		{
+			case fault::none: return "No fault";
+			case fault::illegal_instruction: return "Illegal instruction";
+			case fault::memory_access: return "Invalid memory access";
+			case fault::pc_out_of_range: return "PC out of range";
+			case fault::stack_overflow: return "Stack overflow";
+			case fault::stack_underflow: return "Stack underflow";
+		}
+
+		return "Unknown fault";
+	}
+}
+
+std::string chip8::describe_fault(const fault_status& status)
+{
+	auto str = std::ostringstream{};
+	str << get_fault_name(status.kind) << std::hex << std::setfill('0');
+	if (status.kind != fault::pc_out_of_range)
+	{
+		str << " 0x"s << std::setw(2) << std::to_integer<int>(status.instruction[0]) <<
+			std::setw(2) << std::to_integer<int>(status.instruction[1]);
+	}
+
+	str << " at 0x"s << std::setw(3) << int{status.pc};
+	return str.str();
+}
@@ -0,0 +1,65 @@
+#ifndef FAULT_HPP
+#define FAULT_HPP
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace chip8
+{
+	enum class fault : uint8_t
+	{
+		none,
+		// Opcode doesn't encode any instruction
+		illegal_instruction,
+		// Instruction accessed memory past its end through I
+		memory_access,
+		// PC points past the last complete instruction in memory
+		pc_out_of_range,
+		// CALL with all stack levels in use
+		stack_overflow,
+		// RET with an empty stack
+		stack_underflow
+	};
+
+	enum class fault_policy
+	{
+		// Run returns at the faulting instruction, next run executes it again
+		trap,
+		// Machine stops at the faulting instruction until reset
+		halt,
+		// Faulting instruction is skipped without any effects. PC out of range can't be skipped and halts
+		skip
+	};
+
+	/*	Fault raised by an instruction, with PC and raw instruction as they were when it was raised.
+	 *	Instruction is zero for PC out of range.
+	 */
+	struct fault_status
+	{
+		fault kind;
+		uint16_t pc;
+		instr_t instruction;
+	};
+
+	// Maps command line fault policy name to policy, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<fault_policy> parse_fault_policy_name(std::string_view name) noexcept
+	{
+		if (name == "trap")
+			return fault_policy::trap;
+		if (name == "halt")
+			return fault_policy::halt;
+		if (name == "skip")
+			return fault_policy::skip;
+
+		return std::nullopt;
+	}
+
+	// Human readable description of a fault, only meant for reporting
+	[[nodiscard]] std::string describe_fault(const fault_status& status);
+}
+
+#endif /* FAULT_HPP */
@@ -0,0 +1,51 @@
+#ifndef FLAG_EVALUATION_HPP
+#define FLAG_EVALUATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace chip8
+{
+	enum class flag_evaluation
+	{
+		// Every ALU instruction stores its VF right away
+		eager,
+		// VF of ADD, SUB, SHR, SUBN and SHL is computed only once an instruction touches VF or run ends
+		lazy
+	};
+
+	/*	Operands of the last flag producing ALU instruction executed in lazy flag evaluation,
+	 *	VF is computed from them when something reads it.
+	 */
+	struct deferred_flag
+	{
+		enum class operation : uint8_t
+		{
+			none,
+			add,
+			sub,
+			shr,
+			subn,
+			shl
+		};
+
+		operation op;
+		std::byte vx;
+		std::byte vy;
+	};
+
+	// Maps command line flag evaluation name to flag evaluation, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<flag_evaluation> parse_flag_evaluation_name(std::string_view name) noexcept
+	{
+		if (name == "eager")
+			return flag_evaluation::eager;
+		if (name == "lazy")
+			return flag_evaluation::lazy;
+
+		return std::nullopt;
+	}
+}
+
+#endif /* FLAG_EVALUATION_HPP */
@@ -0,0 +1,42 @@
+#ifndef FRAMEBUFFER_HPP
+#define FRAMEBUFFER_HPP
+
+#include "constants.hpp"
+#include "types.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8::framebuffer
+{
+	static_assert(constants::ch8_width == 64, "Framebuffer rows are stored in 64-bit words");
+
+	// Pixel x of a row is bit 63 - x, so the leftmost pixel is the most significant bit
+	[[nodiscard]] constexpr bool get_pixel(const framebuffer_t& frame, size_t x, size_t y) noexcept
+	{
+		return (frame[y] >> (constants::ch8_width - 1 - x)) & 1;
+	}
+
+	// Positions sprite line at column x, pixels past the right edge wrap around to the left one
+	[[nodiscard]] constexpr uint64_t place_sprite_line(std::byte line, size_t x) noexcept
+	{
+		return std::rotr(std::to_integer<uint64_t>(line) << (constants::ch8_width - 8), static_cast<int>(x));
+	}
+
+	// Positions sprite line at column x, pixels past the right edge are dropped
+	[[nodiscard]] constexpr uint64_t place_clipped_sprite_line(std::byte line, size_t x) noexcept
+	{
+		return (std::to_integer<uint64_t>(line) << (constants::ch8_width - 8)) >> x;
+	}
+
+	// XORs pixels into a row. Returns true if any lit pixel was turned off
+	constexpr bool draw_sprite_line(uint64_t& row, uint64_t pixels) noexcept
+	{
+		const auto is_collision = (row & pixels) != 0;
+		row ^= pixels;
+		return is_collision;
+	}
+}
+
+#endif /* FRAMEBUFFER_HPP */
@@ -0,0 +1,36 @@
+#include "instruction_cache.hpp"
+
+#include <algorithm>
+
+using namespace chip8;
+
+instruction_cache::instruction_cache(instruction_handler decode_handler) noexcept :
+	m_decode_handler{decode_handler}
+{
+	this->invalidate_all();
+}
+
+void instruction_cache::invalidate(uint16_t address, size_t byte_count) noexcept
+{
+	// Instruction starting one byte before the write also contains a written byte
+	const auto first = (address > 0) ? size_t{address} - 1 : size_t{0};
+	const auto last = std::min(size_t{address} + byte_count, this->m_entries.size());
+	const auto invalidated = decoded_instruction{this->m_decode_handler, 0, 0, 0, 0, std::byte{0}, opcode::decode,
+		opcode::decode};
+
+	// So does a fused pair starting up to three bytes before it
+	for (auto idx = (first > 2) ? first - 2 : size_t{0}; idx < first; ++idx)
+	{
+		if (is_fused_opcode(this->m_entries[idx].op))
+			this->m_entries[idx] = invalidated;
+	}
+
+	for (auto idx = first; idx < last; ++idx)
+		this->m_entries[idx] = invalidated;
+}
+
+void instruction_cache::invalidate_all() noexcept
+{
+	this->m_entries.fill(decoded_instruction{this->m_decode_handler, 0, 0, 0, 0, std::byte{0}, opcode::decode,
+		opcode::decode});
+}
@@ -0,0 +1,157 @@
+#ifndef INSTRUCTION_CACHE_HPP
+#define INSTRUCTION_CACHE_HPP
+
+#include "constants.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace chip8
+{
+	struct interpreter;
+	struct decoded_instruction;
+
+	using instruction_handler = void (*)(interpreter&, const decoded_instruction&);
+
+	// Identifies instruction handler for dispatch methods that can't use handler pointers
+	enum class opcode : uint8_t
+	{
+		decode,
+		illegal,
+		cls,
+		ret,
+		jp,
+		call,
+		se_reg_byte,
+		sne_reg_byte,
+		se_reg_reg,
+		ld_reg_byte,
+		add_reg_byte,
+		ld_reg_reg,
+		or_reg_reg,
+		and_reg_reg,
+		xor_reg_reg,
+		add_reg_reg,
+		sub_reg_reg,
+		shr_reg_reg,
+		subn_reg_reg,
+		shl_reg_reg,
+		sne_reg_reg,
+		ld_i_addr,
+		jp_v0_addr,
+		rnd_reg_byte,
+		drw,
+		skp_reg,
+		sknp_reg,
+		ld_reg_dt,
+		ld_reg_k,
+		ld_dt_reg,
+		ld_st_reg,
+		add_i_reg,
+		ld_f_reg,
+		ld_b_reg,
+		str_i_reg,
+		str_reg_i,
+		// Lazy flag evaluation, ALU instructions deferring VF and instruction touching VF, which is computed first
+		add_reg_reg_deferred,
+		sub_reg_reg_deferred,
+		shr_reg_reg_deferred,
+		subn_reg_reg_deferred,
+		shl_reg_reg_deferred,
+		materialize_flag,
+		// Masked memory model, memory instructions mask I to 12 bits and don't check where the access ends
+		drw_masked,
+		ld_b_reg_masked,
+		str_i_reg_masked,
+		str_reg_i_masked,
+		// Fused pairs execute the instruction at PC and then the following one, unless the first one skips it
+		se_reg_byte_jp,
+		sne_reg_byte_jp,
+		se_reg_reg_jp,
+		sne_reg_reg_jp,
+		ld_i_addr_drw,
+		ld_reg_byte_add_reg_reg,
+		add_i_reg_str_reg_i,
+		ld_i_addr_drw_masked,
+		add_i_reg_str_reg_i_masked,
+		count
+	};
+
+	// Handlers indexed by opcode, every quirk profile has its own
+	using handler_table_t = std::array<instruction_handler, static_cast<size_t>(opcode::count)>;
+
+	static constexpr auto first_fused_opcode = opcode::se_reg_byte_jp;
+	static constexpr auto fused_opcode_count = static_cast<size_t>(opcode::count) -
+		static_cast<size_t>(first_fused_opcode);
+
+	// Indexed from the first fused opcode
+	static constexpr auto fused_opcode_names = std::array<std::string_view, fused_opcode_count>{
+		"SE Vx, byte + JP addr",
+		"SNE Vx, byte + JP addr",
+		"SE Vx, Vy + JP addr",
+		"SNE Vx, Vy + JP addr",
+		"LD I, addr + DRW Vx, Vy, nibble",
+		"LD Vx, byte + ADD Vx, Vy",
+		"ADD I, Vx + LD Vx, [I]",
+		"LD I, addr + DRW Vx, Vy, nibble (masked)",
+		"ADD I, Vx + LD Vx, [I] (masked)"
+	};
+
+	[[nodiscard]] constexpr bool is_fused_opcode(opcode op) noexcept
+	{
+		return op >= first_fused_opcode && op != opcode::count;
+	}
+
+	[[nodiscard]] constexpr size_t get_fused_opcode_index(opcode op) noexcept
+	{
+		return static_cast<size_t>(op) - static_cast<size_t>(first_fused_opcode);
+	}
+
+	// Instruction with its handler resolved and operands already extracted
+	struct decoded_instruction
+	{
+		instruction_handler handler;
+		uint16_t nnn;
+		uint8_t x;
+		uint8_t y;
+		uint8_t n;
+		std::byte kk;
+		opcode op;
+		// Opcode executed once VF is computed, when op is materialize_flag
+		opcode materialized_op;
+	};
+
+	/*	Decoded instruction for every memory address.
+	 *	Entries that were never decoded or were invalidated by a memory write point to the decode handler,
+	 *	which decodes the instruction, stores it and executes it, so lookups never need a validity check.
+	 */
+	struct instruction_cache
+	{
+		explicit instruction_cache(instruction_handler decode_handler) noexcept;
+
+		[[nodiscard]] const decoded_instruction& operator[](uint16_t address) const noexcept;
+		void store(uint16_t address, const decoded_instruction& instr) noexcept;
+
+		// Invalidates every entry whose instruction or fused pair overlaps with the written byte range
+		void invalidate(uint16_t address, size_t byte_count) noexcept;
+		void invalidate_all() noexcept;
+
+	private:
+		const instruction_handler m_decode_handler;
+		std::array<decoded_instruction, constants::mem_size> m_entries;
+	};
+}
+
+inline const chip8::decoded_instruction& chip8::instruction_cache::operator[](uint16_t address) const noexcept
+{
+	return this->m_entries[address];
+}
+
+inline void chip8::instruction_cache::store(uint16_t address, const decoded_instruction& instr) noexcept
+{
+	this->m_entries[address] = instr;
+}
+
+#endif /* INSTRUCTION_CACHE_HPP */
@@ -1,65 +1,62 @@
 #include "instructions.hpp"
-#include "io/input.hpp"
 
-#include <SDL_log.h>
-
-#include <random>
+#include <bit>
 
 using namespace chip8;
 
 namespace
 {
-	inline bool is_key_pressed(const registers& regs, instr_t instr) noexcept
+	inline bool is_key_pressed(const registers& regs, keyboard_state keys, size_t x) noexcept
 	{
-		const auto x_offset = instructions::get_lower_nibble<size_t>(instr[0]);
-		const auto key = std::to_integer<size_t>(regs.v[x_offset]);
-		return chip8::get_keyboard_state()[key];
+		// Only the lower nibble selects a key, like on the original interpreter
+		const auto key = std::to_integer<size_t>(regs.v[x]) & 0xF;
+		return (keys >> key) & 1;
 	}
 }
 
-void instructions::detail::throw_memory_access_error()
+void instructions::rnd_reg_byte(chip8::registers& regs, random_generator& rng, instr_t instr) noexcept
 {
-	throw std::out_of_range("Invalid memory access (address out of range)");
+	instructions::rnd_reg_byte(regs, rng, instructions::get_lower_nibble<size_t>(instr[0]), instr[1]);
 }
 
-void instructions::rnd_reg_byte(chip8::registers& regs, instr_t instr) noexcept
+void instructions::skp_reg(chip8::registers& regs, keyboard_state keys, instr_t instr) noexcept
 {
-	const auto x_offset = instructions::get_lower_nibble<size_t>(instr[0]);
+	instructions::skp_reg(regs, keys, instructions::get_lower_nibble<size_t>(instr[0]));
+}
 
-	auto engine = std::default_random_engine{std::random_device{}()};
-	auto random_number = std::uniform_int_distribution<uint16_t>(0, 255)(engine);
+void instructions::sknp_reg(chip8::registers& regs, keyboard_state keys, instr_t instr) noexcept
+{
+	instructions::sknp_reg(regs, keys, instructions::get_lower_nibble<size_t>(instr[0]));
+}
 
-	regs.v[x_offset] = std::byte(random_number) & instr[1];
+bool instructions::ld_reg_k(chip8::registers& regs, keyboard_state keys, instr_t instr) noexcept
+{
+	return instructions::ld_reg_k(regs, keys, instructions::get_lower_nibble<size_t>(instr[0]));
 }
 
-void instructions::skp_reg(chip8::registers& regs, instr_t instr) noexcept
+void instructions::rnd_reg_byte(chip8::registers& regs, random_generator& rng, size_t x, std::byte kk) noexcept
 {
-	if (is_key_pressed(regs, instr))
+	regs.v[x] = rng.next_byte() & kk;
+}
+
+void instructions::skp_reg(chip8::registers& regs, keyboard_state keys, size_t x) noexcept
+{
+	if (is_key_pressed(regs, keys, x))
 		regs.pc += 2;
 }
 
-void instructions::sknp_reg(chip8::registers& regs, instr_t instr) noexcept
+void instructions::sknp_reg(chip8::registers& regs, keyboard_state keys, size_t x) noexcept
 {
-	if (!is_key_pressed(regs, instr))
+	if (!is_key_pressed(regs, keys, x))
 		regs.pc += 2;
 }
 
-bool instructions::ld_reg_k(chip8::registers& regs, instr_t instr) noexcept
+bool instructions::ld_reg_k(chip8::registers& regs, keyboard_state keys, size_t x) noexcept
 {
-	const auto kbd_state = chip8::get_keyboard_state();
-	if (!kbd_state.count())
+	if (keys == 0)
 		return false;
 
-	auto pressed_idx = std::byte{0};
-	for (size_t idx = 0; idx < kbd_state.size(); ++idx)
-	{
-		if (kbd_state[idx])
-		{
-			pressed_idx = std::byte(idx);
-			break;
-		}
-	}
-
-	regs.v[instructions::get_lower_nibble<size_t>(instr[0])] = pressed_idx;
+	// Lowest pressed key wins
+	regs.v[x] = std::byte(std::countr_zero(keys));
 	return true;
 }
@@ -2,6 +2,8 @@
 #define INSTRUCTIONS_HPP
 
 #include "chip8_font.hpp"
+#include "flag_evaluation.hpp"
+#include "random_generator.hpp"
 #include "types.hpp"
 #include "registers.hpp"
 
@@ -17,8 +19,9 @@ namespace chip8::instructions
 	
 	[[nodiscard]] constexpr std::byte extract_instruction_class(instruction instr) noexcept;
 
+	// PC must be in range, callers check it before fetching
 	template <size_t array_size>
-	[[nodiscard]] instruction fetch(const std::array<std::byte, array_size>& mem, uint16_t pc);
+	[[nodiscard]] instruction fetch(const std::array<std::byte, array_size>& mem, uint16_t pc) noexcept;
 
 	template <std::integral T>
 	[[nodiscard]] constexpr T get_lower_nibble(std::byte byte) noexcept;
@@ -34,12 +37,22 @@ namespace chip8::instructions
 		template <std::integral T>
 		[[nodiscard]] constexpr T get_lower_12_bits(instruction instr) noexcept;
 
-		[[noreturn]] void throw_memory_access_error();
+		// Bytes an access may reach in memory of array_size bytes, guard band of memory_t is not part of them
+		template <size_t array_size>
+		inline constexpr auto addressable_size = std::min(array_size, constants::mem_size);
+
+		// VF values of flag producing ALU instructions
+		[[nodiscard]] constexpr std::byte get_add_flag(std::byte vx, std::byte vy) noexcept;
+		[[nodiscard]] constexpr std::byte get_sub_flag(std::byte vx, std::byte vy) noexcept;
+		[[nodiscard]] constexpr std::byte get_shr_flag(std::byte vx) noexcept;
+		[[nodiscard]] constexpr std::byte get_shl_flag(std::byte vx) noexcept;
 	}
 
-	constexpr void ret(chip8::registers& regs, stack_t& stack) noexcept;
+	// Stack instructions return false without touching registers or stack when RET finds the stack empty or
+	// CALL finds it full
+	[[nodiscard]] constexpr bool ret(chip8::registers& regs, stack_t& stack) noexcept;
 	constexpr void jp(chip8::registers& regs, instruction instr) noexcept;
-	constexpr void call(chip8::registers& regs, stack_t& stack, instruction instr) noexcept;
+	[[nodiscard]] constexpr bool call(chip8::registers& regs, stack_t& stack, instruction instr) noexcept;
 	constexpr void se_reg_byte(chip8::registers& regs, instruction instr) noexcept;
 	constexpr void sne_reg_byte(chip8::registers& regs, instruction instr) noexcept;
 	constexpr void se_reg_reg(chip8::registers& regs, instruction instr) noexcept;
@@ -57,24 +70,88 @@ namespace chip8::instructions
 	constexpr void sne_reg_reg(chip8::registers& regs, instruction instr) noexcept;
 	constexpr void ld_i_addr(chip8::registers& regs, instruction instr) noexcept;
 	constexpr void jp_v0_addr(chip8::registers& regs, instruction instr) noexcept;
-	void rnd_reg_byte(chip8::registers& regs, instruction instr) noexcept;
-	void skp_reg(chip8::registers& regs, instruction instr) noexcept;
-	void sknp_reg(chip8::registers& regs, instruction instr) noexcept;
+	void rnd_reg_byte(chip8::registers& regs, random_generator& rng, instruction instr) noexcept;
+	void skp_reg(chip8::registers& regs, keyboard_state keys, instruction instr) noexcept;
+	void sknp_reg(chip8::registers& regs, keyboard_state keys, instruction instr) noexcept;
 	constexpr void ld_reg_dt(chip8::registers& regs, instruction instr) noexcept;
-	[[nodiscard]] bool ld_reg_k(chip8::registers& regs, instruction instr) noexcept;
+	[[nodiscard]] bool ld_reg_k(chip8::registers& regs, keyboard_state keys, instruction instr) noexcept;
 	constexpr void ld_dt_reg(chip8::registers& regs, instruction instr) noexcept;
 	constexpr void ld_st_reg(chip8::registers& regs, instruction instr) noexcept;
 	constexpr void add_i_reg(chip8::registers& regs, instruction instr) noexcept;
 	constexpr void ld_f_reg(chip8::registers& regs, instruction instr) noexcept;
 
+	// Memory instructions return false without touching memory or registers when access through I would go past
+	// the last address
 	template <size_t array_size>
-	constexpr void ld_b_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem, instruction instr);
+	[[nodiscard]] constexpr bool ld_b_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		instruction instr) noexcept;
 
 	template <size_t array_size>
-	constexpr void str_i_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem, instruction instr);
+	[[nodiscard]] constexpr bool str_i_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		instruction instr) noexcept;
+	template <size_t array_size>
+	[[nodiscard]] constexpr bool str_reg_i(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		instruction instr) noexcept;
+
+	// Overloads taking already decoded operands (x, y - register indices, kk - byte, nnn - address)
+	constexpr void jp(chip8::registers& regs, uint16_t nnn) noexcept;
+	[[nodiscard]] constexpr bool call(chip8::registers& regs, stack_t& stack, uint16_t nnn) noexcept;
+	constexpr void se_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept;
+	constexpr void sne_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept;
+	constexpr void se_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void ld_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept;
+	constexpr void add_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept;
+	constexpr void ld_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void or_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void and_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void xor_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void add_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void sub_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void shr_reg_reg(chip8::registers& regs, size_t x) noexcept;
+	constexpr void subn_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void shl_reg_reg(chip8::registers& regs, size_t x) noexcept;
+	constexpr void sne_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept;
+	constexpr void ld_i_addr(chip8::registers& regs, uint16_t nnn) noexcept;
+	constexpr void jp_v0_addr(chip8::registers& regs, uint16_t nnn) noexcept;
+	// Bxnn of CHIP-48 and SUPER-CHIP, which jumps to xnn + Vx
+	constexpr void jp_vx_addr(chip8::registers& regs, size_t x, uint16_t nnn) noexcept;
+	void rnd_reg_byte(chip8::registers& regs, random_generator& rng, size_t x, std::byte kk) noexcept;
+	void skp_reg(chip8::registers& regs, keyboard_state keys, size_t x) noexcept;
+	void sknp_reg(chip8::registers& regs, keyboard_state keys, size_t x) noexcept;
+	constexpr void ld_reg_dt(chip8::registers& regs, size_t x) noexcept;
+	[[nodiscard]] bool ld_reg_k(chip8::registers& regs, keyboard_state keys, size_t x) noexcept;
+	constexpr void ld_dt_reg(chip8::registers& regs, size_t x) noexcept;
+	constexpr void ld_st_reg(chip8::registers& regs, size_t x) noexcept;
+	constexpr void add_i_reg(chip8::registers& regs, size_t x) noexcept;
+	constexpr void ld_f_reg(chip8::registers& regs, size_t x) noexcept;
+
 	template <size_t array_size>
-	constexpr void str_reg_i(chip8::registers& regs, std::array<std::byte, array_size>& mem, instruction instr);
+	[[nodiscard]] constexpr bool ld_b_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		size_t x) noexcept;
 
+	template <size_t array_size>
+	[[nodiscard]] constexpr bool str_i_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		size_t x) noexcept;
+	template <size_t array_size>
+	[[nodiscard]] constexpr bool str_reg_i(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		size_t x) noexcept;
+
+	// Memory instructions of the masked memory model, I is masked to 12 bits and accesses running past 0xFFF land
+	// in the guard band instead of being checked
+	constexpr void ld_b_reg_masked(chip8::registers& regs, memory_t& mem, size_t x) noexcept;
+	constexpr void str_i_reg_masked(chip8::registers& regs, memory_t& mem, size_t x) noexcept;
+	constexpr void str_reg_i_masked(chip8::registers& regs, memory_t& mem, size_t x) noexcept;
+
+	// Flag producing instructions for lazy flag evaluation, which record their operands in flag instead of
+	// storing VF. Neither x nor y may be VF
+	constexpr void add_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x, size_t y) noexcept;
+	constexpr void sub_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x, size_t y) noexcept;
+	constexpr void shr_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x) noexcept;
+	constexpr void subn_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x, size_t y) noexcept;
+	constexpr void shl_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x) noexcept;
+
+	// Stores VF of the deferred instruction, if there is one, and clears flag
+	constexpr void materialize_flag(chip8::registers& regs, deferred_flag& flag) noexcept;
 }
 
 namespace chip8::instructions
@@ -84,18 +161,36 @@ namespace chip8::instructions
 	{
 		return std::to_integer<T>(instr[0] & std::byte{0x0F}) << 8 | std::to_integer<T>(instr[1]);
 	}
+
+	constexpr std::byte detail::get_add_flag(std::byte vx, std::byte vy) noexcept
+	{
+		const auto sum = std::to_integer<uint16_t>(vx) + std::to_integer<uint16_t>(vy);
+		return (sum > 255) ? std::byte{0x01} : std::byte{0x00};
+	}
+
+	constexpr std::byte detail::get_sub_flag(std::byte vx, std::byte vy) noexcept
+	{
+		return (vx > vy) ? std::byte{0x01} : std::byte{0x00};
+	}
+
+	constexpr std::byte detail::get_shr_flag(std::byte vx) noexcept
+	{
+		return vx & std::byte{0x01};
+	}
+
+	constexpr std::byte detail::get_shl_flag(std::byte vx) noexcept
+	{
+		return vx >> 7;
+	}
 }
 
 namespace chip8
 {
 	template <size_t array_size>
-	instr_t instructions::fetch(const std::array<std::byte, array_size>& mem, uint16_t pc)
+	instr_t instructions::fetch(const std::array<std::byte, array_size>& mem, uint16_t pc) noexcept
 	{
 		static constexpr auto instruction_size = std::tuple_size<instr_t>::value;
 
-		if (array_size < pc + instruction_size)
-			detail::throw_memory_access_error();
-
 		instr_t instr;
 		std::copy_n(mem.begin() + pc, instruction_size, instr.begin());
 		return instr;
@@ -124,211 +219,429 @@ namespace chip8
 		return std::to_integer<T>(byte >> 4);
 	}
 
-	constexpr void instructions::ret(chip8::registers& regs, stack_t& stack) noexcept
+	constexpr bool instructions::ret(chip8::registers& regs, stack_t& stack) noexcept
 	{
+		if (regs.sp < 0)
+			return false;
+
 		regs.pc = stack[regs.sp];
 		--regs.sp;
+		return true;
 	}
 
 	constexpr void instructions::jp(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.pc = detail::get_lower_12_bits<decltype(regs.pc)>(instr);
+		instructions::jp(regs, detail::get_lower_12_bits<uint16_t>(instr));
 	}
 
-	constexpr void instructions::call(chip8::registers& regs, stack_t& stack, instr_t instr) noexcept
+	constexpr bool instructions::call(chip8::registers& regs, stack_t& stack, instr_t instr) noexcept
 	{
-		++regs.sp;
-		stack[regs.sp] = regs.pc;
-		regs.pc = detail::get_lower_12_bits<decltype(regs.pc)>(instr);
+		return instructions::call(regs, stack, detail::get_lower_12_bits<uint16_t>(instr));
 	}
 
 	constexpr void instructions::se_reg_byte(chip8::registers& regs, instr_t instr) noexcept
 	{
-		if (regs.v[instructions::get_lower_nibble<size_t>(instr[0])] == instr[1])
-			regs.pc += 2;
+		instructions::se_reg_byte(regs, instructions::get_lower_nibble<size_t>(instr[0]), instr[1]);
 	}
 
 	constexpr void instructions::sne_reg_byte(chip8::registers& regs, instr_t instr) noexcept
 	{
-		if (regs.v[instructions::get_lower_nibble<size_t>(instr[0])] != instr[1])
-			regs.pc += 2;
+		instructions::sne_reg_byte(regs, instructions::get_lower_nibble<size_t>(instr[0]), instr[1]);
 	}
 
 	constexpr void instructions::se_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		if (regs.v[instructions::get_lower_nibble<size_t>(instr[0])] ==
-			regs.v[instructions::get_upper_nibble<size_t>(instr[1])])
-				regs.pc += 2;
+		instructions::se_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::ld_reg_byte(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.v[instructions::get_lower_nibble<size_t>(instr[0])] = instr[1];
+		instructions::ld_reg_byte(regs, instructions::get_lower_nibble<size_t>(instr[0]), instr[1]);
 	}
 
 	constexpr void instructions::add_reg_byte(chip8::registers& regs, instr_t instr) noexcept
 	{
-		const auto reg_idx = instructions::get_lower_nibble<size_t>(instr[0]);
-		regs.v[reg_idx] = std::byte(std::to_integer<uint8_t>(regs.v[reg_idx])
-			+ std::to_integer<uint8_t>(instr[1]));
+		instructions::add_reg_byte(regs, instructions::get_lower_nibble<size_t>(instr[0]), instr[1]);
 	}
 
 	constexpr void instructions::ld_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.v[instructions::get_lower_nibble<size_t>(instr[0])] =
-			regs.v[instructions::get_upper_nibble<size_t>(instr[1])];
+		instructions::ld_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::or_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.v[instructions::get_lower_nibble<size_t>(instr[0])] |=
-			regs.v[instructions::get_upper_nibble<size_t>(instr[1])];
+		instructions::or_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::and_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.v[instructions::get_lower_nibble<size_t>(instr[0])] &=
-			regs.v[instructions::get_upper_nibble<size_t>(instr[1])];
+		instructions::and_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::xor_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.v[instructions::get_lower_nibble<size_t>(instr[0])] ^=
-			regs.v[instructions::get_upper_nibble<size_t>(instr[1])];
+		instructions::xor_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::add_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		const auto x_offset = instructions::get_lower_nibble<size_t>(instr[0]);
-		const auto y_offset = instructions::get_upper_nibble<size_t>(instr[1]);
-	
-		auto tmp = std::to_integer<uint8_t>(regs.v[x_offset]) + std::to_integer<uint8_t>(regs.v[y_offset]);
-
-		if (tmp > 255)
-		{
-			regs.v[x_offset] = std::byte(tmp & 0xFF);
-			regs.v[0xF] = std::byte{0x01};
-		}
-		else
-		{
-			regs.v[x_offset] = std::byte(tmp);
-			regs.v[0xF] = std::byte{0x00};
-		}
+		instructions::add_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::sub_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		const auto x_offset = instructions::get_lower_nibble<size_t>(instr[0]);
-		const auto y_offset = instructions::get_upper_nibble<size_t>(instr[1]);
-
-		regs.v[0xF] = (regs.v[x_offset] > regs.v[y_offset]) ? std::byte{0x01} : std::byte{0x00};
-		auto res = std::to_integer<uint8_t>(regs.v[x_offset]) - std::to_integer<uint8_t>(regs.v[y_offset]);
-
-		regs.v[x_offset] = (res >= 0) ? std::byte(res) : std::byte(res & 0xFF);
+		instructions::sub_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::shr_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		const auto x_offset = instructions::get_lower_nibble<size_t>(instr[0]);
-		regs.v[0xF] = regs.v[x_offset] & std::byte{0x01};
-		regs.v[x_offset] >>= 1;
+		instructions::shr_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]));
 	}
 
 	constexpr void instructions::subn_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		const auto x_offset = instructions::get_lower_nibble<size_t>(instr[0]);
-		const auto y_offset = instructions::get_upper_nibble<size_t>(instr[1]);
-
-		regs.v[0xF] = (regs.v[y_offset] > regs.v[x_offset]) ? std::byte{0x01} : std::byte{0x00};
-		auto res = std::to_integer<uint8_t>(regs.v[y_offset]) - std::to_integer<uint8_t>(regs.v[x_offset]);
-
-		regs.v[x_offset] = (res >= 0) ? std::byte(res) : std::byte(res & 0xFF);
+		instructions::subn_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::shl_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		const auto x_offset = instructions::get_lower_nibble<size_t>(instr[0]);
-		regs.v[0xF] = (regs.v[x_offset] & std::byte{0x80}) != std::byte{0x00} ?
-			std::byte{0x01} : std::byte{0x00};
-		regs.v[x_offset] <<= 1;
+		instructions::shl_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]));
 	}
 
 	constexpr void instructions::sne_reg_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		if (regs.v[instructions::get_lower_nibble<size_t>(instr[0])] !=
-			regs.v[instructions::get_upper_nibble<size_t>(instr[1])])
-				regs.pc += 2;
+		instructions::sne_reg_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]),
+			instructions::get_upper_nibble<size_t>(instr[1]));
 	}
 
 	constexpr void instructions::ld_i_addr(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.i = instructions::detail::get_lower_12_bits<decltype(regs.i)>(instr);
+		instructions::ld_i_addr(regs, detail::get_lower_12_bits<uint16_t>(instr));
 	}
 
 	constexpr void instructions::jp_v0_addr(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.pc = uint16_t(instructions::detail::get_lower_12_bits<decltype(regs.pc)>(instr) + 
-			std::to_integer<uint16_t>(regs.v[0x00])) & uint16_t{0xFFF};
+		instructions::jp_v0_addr(regs, detail::get_lower_12_bits<uint16_t>(instr));
 	}
 
 	constexpr void instructions::ld_reg_dt(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.v[instructions::get_lower_nibble<size_t>(instr[0])] = std::byte{regs.delay};
+		instructions::ld_reg_dt(regs, instructions::get_lower_nibble<size_t>(instr[0]));
 	}
 
 	constexpr void instructions::ld_dt_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.delay = std::to_integer<uint8_t>(regs.v[instructions::get_lower_nibble<size_t>(instr[0])]);
+		instructions::ld_dt_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]));
 	}
 
 	constexpr void instructions::ld_st_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.sound = std::to_integer<uint8_t>(regs.v[instructions::get_lower_nibble<size_t>(instr[0])]);
+		instructions::ld_st_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]));
 	}
 
 	constexpr void instructions::add_i_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		regs.i += std::to_integer<uint8_t>(regs.v[instructions::get_lower_nibble<size_t>(instr[0])]);
+		instructions::add_i_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]));
 	}
 
 	constexpr void instructions::ld_f_reg(chip8::registers& regs, instr_t instr) noexcept
 	{
-		const auto digit = std::to_integer<uint8_t>(regs.v[instructions::get_lower_nibble<size_t>(instr[0])]);
+		instructions::ld_f_reg(regs, instructions::get_lower_nibble<size_t>(instr[0]));
+	}
+
+	template <size_t array_size>
+	constexpr bool instructions::ld_b_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		instr_t instr) noexcept
+	{
+		return instructions::ld_b_reg(regs, mem, instructions::get_lower_nibble<size_t>(instr[0]));
+	}
+
+	template <size_t array_size>
+	constexpr bool instructions::str_i_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		instr_t instr) noexcept
+	{
+		return instructions::str_i_reg(regs, mem, instructions::get_lower_nibble<size_t>(instr[0]));
+	}
+
+	template <size_t array_size>
+	constexpr bool instructions::str_reg_i(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		instr_t instr) noexcept
+	{
+		return instructions::str_reg_i(regs, mem, instructions::get_lower_nibble<size_t>(instr[0]));
+	}
+
+	constexpr void instructions::jp(chip8::registers& regs, uint16_t nnn) noexcept
+	{
+		regs.pc = nnn;
+	}
+
+	constexpr bool instructions::call(chip8::registers& regs, stack_t& stack, uint16_t nnn) noexcept
+	{
+		if (regs.sp + 1 >= int(constants::stack_size))
+			return false;
+
+		++regs.sp;
+		stack[regs.sp] = regs.pc;
+		regs.pc = nnn;
+		return true;
+	}
+
+	constexpr void instructions::se_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept
+	{
+		if (regs.v[x] == kk)
+			regs.pc += 2;
+	}
+
+	constexpr void instructions::sne_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept
+	{
+		if (regs.v[x] != kk)
+			regs.pc += 2;
+	}
+
+	constexpr void instructions::se_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		if (regs.v[x] == regs.v[y])
+			regs.pc += 2;
+	}
+
+	constexpr void instructions::ld_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept
+	{
+		regs.v[x] = kk;
+	}
+
+	constexpr void instructions::add_reg_byte(chip8::registers& regs, size_t x, std::byte kk) noexcept
+	{
+		regs.v[x] = std::byte(std::to_integer<uint8_t>(regs.v[x]) + std::to_integer<uint8_t>(kk));
+	}
+
+	constexpr void instructions::ld_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		regs.v[x] = regs.v[y];
+	}
+
+	constexpr void instructions::or_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		regs.v[x] |= regs.v[y];
+	}
+
+	constexpr void instructions::and_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		regs.v[x] &= regs.v[y];
+	}
+
+	constexpr void instructions::xor_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		regs.v[x] ^= regs.v[y];
+	}
+
+	constexpr void instructions::add_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		const auto flag = detail::get_add_flag(regs.v[x], regs.v[y]);
+		regs.v[x] = std::byte(std::to_integer<uint8_t>(regs.v[x]) + std::to_integer<uint8_t>(regs.v[y]));
+		regs.v[0xF] = flag;
+	}
+
+	constexpr void instructions::sub_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		regs.v[0xF] = detail::get_sub_flag(regs.v[x], regs.v[y]);
+		regs.v[x] = std::byte(std::to_integer<uint8_t>(regs.v[x]) - std::to_integer<uint8_t>(regs.v[y]));
+	}
+
+	constexpr void instructions::shr_reg_reg(chip8::registers& regs, size_t x) noexcept
+	{
+		regs.v[0xF] = detail::get_shr_flag(regs.v[x]);
+		regs.v[x] >>= 1;
+	}
+
+	constexpr void instructions::subn_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		regs.v[0xF] = detail::get_sub_flag(regs.v[y], regs.v[x]);
+		regs.v[x] = std::byte(std::to_integer<uint8_t>(regs.v[y]) - std::to_integer<uint8_t>(regs.v[x]));
+	}
+
+	constexpr void instructions::shl_reg_reg(chip8::registers& regs, size_t x) noexcept
+	{
+		regs.v[0xF] = detail::get_shl_flag(regs.v[x]);
+		regs.v[x] <<= 1;
+	}
+
+	constexpr void instructions::sne_reg_reg(chip8::registers& regs, size_t x, size_t y) noexcept
+	{
+		if (regs.v[x] != regs.v[y])
+			regs.pc += 2;
+	}
+
+	constexpr void instructions::ld_i_addr(chip8::registers& regs, uint16_t nnn) noexcept
+	{
+		regs.i = nnn;
+	}
+
+	constexpr void instructions::jp_v0_addr(chip8::registers& regs, uint16_t nnn) noexcept
+	{
+		regs.pc = uint16_t(nnn + std::to_integer<uint16_t>(regs.v[0x00])) & uint16_t{0xFFF};
+	}
+
+	constexpr void instructions::jp_vx_addr(chip8::registers& regs, size_t x, uint16_t nnn) noexcept
+	{
+		regs.pc = uint16_t(nnn + std::to_integer<uint16_t>(regs.v[x])) & uint16_t{0xFFF};
+	}
+
+	constexpr void instructions::ld_reg_dt(chip8::registers& regs, size_t x) noexcept
+	{
+		regs.v[x] = std::byte{regs.delay};
+	}
+
+	constexpr void instructions::ld_dt_reg(chip8::registers& regs, size_t x) noexcept
+	{
+		regs.delay = std::to_integer<uint8_t>(regs.v[x]);
+	}
+
+	constexpr void instructions::ld_st_reg(chip8::registers& regs, size_t x) noexcept
+	{
+		regs.sound = std::to_integer<uint8_t>(regs.v[x]);
+	}
+
+	constexpr void instructions::add_i_reg(chip8::registers& regs, size_t x) noexcept
+	{
+		regs.i += std::to_integer<uint8_t>(regs.v[x]);
+	}
+
+	constexpr void instructions::ld_f_reg(chip8::registers& regs, size_t x) noexcept
+	{
+		const auto digit = std::to_integer<uint8_t>(regs.v[x]);
 		regs.i = uint16_t(chip8::font::c_font_offset + digit * chip8::font::c_bytes_per_symbol);
 	}
 
 	template <size_t array_size>
-	constexpr void instructions::ld_b_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem, instr_t instr)
+	constexpr bool instructions::ld_b_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		size_t x) noexcept
 	{
-		if (array_size < size_t{regs.i} + 3)
-			detail::throw_memory_access_error();
+		if (detail::addressable_size<array_size> < size_t{regs.i} + 3)
+			return false;
 
-		auto number = std::to_integer<int>(regs.v[instructions::get_lower_nibble<size_t>(instr[0])]);
+		auto number = std::to_integer<int>(regs.v[x]);
 		for (int idx = 2; idx >= 0; --idx)
 		{
 			mem[regs.i + idx] = std::byte(number % 10);
 			number /= 10;
 		}
+
+		return true;
 	}
 
 	template <size_t array_size>
-	constexpr void instructions::str_i_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem, instr_t instr)
+	constexpr bool instructions::str_i_reg(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		size_t x) noexcept
 	{
-		const auto last_reg = instructions::get_lower_nibble<size_t>(instr[0]);
-		if (array_size < size_t{regs.i} + last_reg)
-			detail::throw_memory_access_error();
+		if (detail::addressable_size<array_size> < size_t{regs.i} + x + 1)
+			return false;
 
-		std::copy(regs.v.begin(), regs.v.begin() + last_reg + 1, mem.begin() + size_t{regs.i});
+		std::copy(regs.v.begin(), regs.v.begin() + x + 1, mem.begin() + size_t{regs.i});
+		return true;
 	}
 
 	template <size_t array_size>
-	constexpr void instructions::str_reg_i(chip8::registers& regs, std::array<std::byte, array_size>& mem, instr_t instr)
+	constexpr bool instructions::str_reg_i(chip8::registers& regs, std::array<std::byte, array_size>& mem,
+		size_t x) noexcept
+	{
+		if (detail::addressable_size<array_size> < size_t{regs.i} + x + 1)
+			return false;
+
+		std::copy(mem.begin() + size_t{regs.i}, mem.begin() + size_t{regs.i} + x + 1, regs.v.begin());
+		return true;
+	}
+
+	constexpr void instructions::ld_b_reg_masked(chip8::registers& regs, memory_t& mem, size_t x) noexcept
 	{
-		const auto last_reg = instructions::get_lower_nibble<size_t>(instr[0]);
-		if (array_size < size_t{regs.i} + last_reg)
-			detail::throw_memory_access_error();
+		const auto address = size_t{regs.i} & constants::address_mask;
+		auto number = std::to_integer<int>(regs.v[x]);
+		for (int idx = 2; idx >= 0; --idx)
+		{
+			mem[address + idx] = std::byte(number % 10);
+			number /= 10;
+		}
+	}
+
+	constexpr void instructions::str_i_reg_masked(chip8::registers& regs, memory_t& mem, size_t x) noexcept
+	{
+		const auto address = size_t{regs.i} & constants::address_mask;
+		std::copy(regs.v.begin(), regs.v.begin() + x + 1, mem.begin() + address);
+	}
+
+	constexpr void instructions::str_reg_i_masked(chip8::registers& regs, memory_t& mem, size_t x) noexcept
+	{
+		const auto address = size_t{regs.i} & constants::address_mask;
+		std::copy(mem.begin() + address, mem.begin() + address + x + 1, regs.v.begin());
+	}
+
+	constexpr void instructions::add_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x, size_t y) noexcept
+	{
+		flag = deferred_flag{deferred_flag::operation::add, regs.v[x], regs.v[y]};
+		regs.v[x] = std::byte(std::to_integer<uint8_t>(regs.v[x]) + std::to_integer<uint8_t>(regs.v[y]));
+	}
+
+	constexpr void instructions::sub_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x, size_t y) noexcept
+	{
+		flag = deferred_flag{deferred_flag::operation::sub, regs.v[x], regs.v[y]};
+		regs.v[x] = std::byte(std::to_integer<uint8_t>(regs.v[x]) - std::to_integer<uint8_t>(regs.v[y]));
+	}
+
+	constexpr void instructions::shr_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x) noexcept
+	{
+		flag = deferred_flag{deferred_flag::operation::shr, regs.v[x], std::byte{0x00}};
+		regs.v[x] >>= 1;
+	}
+
+	constexpr void instructions::subn_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x, size_t y) noexcept
+	{
+		flag = deferred_flag{deferred_flag::operation::subn, regs.v[x], regs.v[y]};
+		regs.v[x] = std::byte(std::to_integer<uint8_t>(regs.v[y]) - std::to_integer<uint8_t>(regs.v[x]));
+	}
+
+	constexpr void instructions::shl_reg_reg(chip8::registers& regs, deferred_flag& flag, size_t x) noexcept
+	{
+		flag = deferred_flag{deferred_flag::operation::shl, regs.v[x], std::byte{0x00}};
+		regs.v[x] <<= 1;
+	}
+
+	constexpr void instructions::materialize_flag(chip8::registers& regs, deferred_flag& flag) noexcept
+	{
+		switch (flag.op)
+		{
+			case deferred_flag::operation::none:
+				return;
+
+			case deferred_flag::operation::add:
+				regs.v[0xF] = detail::get_add_flag(flag.vx, flag.vy);
+				break;
+
+			case deferred_flag::operation::sub:
+				regs.v[0xF] = detail::get_sub_flag(flag.vx, flag.vy);
+				break;
+
+			case deferred_flag::operation::shr:
+				regs.v[0xF] = detail::get_shr_flag(flag.vx);
+				break;
+
+			case deferred_flag::operation::subn:
+				regs.v[0xF] = detail::get_sub_flag(flag.vy, flag.vx);
+				break;
+
+			case deferred_flag::operation::shl:
+				regs.v[0xF] = detail::get_shl_flag(flag.vx);
+				break;
+		}
 
-		std::copy(mem.begin() + size_t{regs.i}, mem.begin() + size_t{regs.i} + last_reg + 1, regs.v.begin());
+		flag.op = deferred_flag::operation::none;
 	}
 }
 
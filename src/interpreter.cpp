@@ -2,17 +2,21 @@
 
 #include "chip8_font.hpp"
 #include "instructions.hpp"
+#include "opcode_handlers.hpp"
+#include "aot/engine.hpp"
 #include "io/rom.hpp"
-#include "errors/illegal_instruction_exception.hpp"
 
-#include <SDL_timer.h>
+#ifdef CHIP8_ENABLE_JIT
+#include "jit/engine.hpp"
+#endif
+
 #include <SDL_log.h>
 
 #include <algorithm>
-#include <bitset>
 #include <chrono>
 #include <cstring>
-#include <functional>
+#include <stdexcept>
+#include <utility>
 
 using namespace chip8;
 
@@ -25,309 +29,766 @@ namespace
 		tick_time = std::chrono::high_resolution_clock::now();
 		return std::chrono::duration_cast<std::chrono::nanoseconds>(tick_time - last_tick_time);
 	}
-
-	[[nodiscard]] inline auto wrap(size_t val, size_t limit)
-	{
-		return (val >= limit) ? (val - limit) : val;
-	};
 }
 
-interpreter::interpreter(const std::filesystem::path& rom_path, sdl::window& interpreter_window, sdl::beeper& beeper,
-	std::chrono::nanoseconds tick_period) :
+interpreter::interpreter(const std::filesystem::path& rom_path, chip8::backend& backend,
+	std::chrono::nanoseconds tick_period, execution_engine engine, presentation_mode presentation) :
 		m_is_running{true},
-		m_interpreter_window{interpreter_window},
-		m_display{m_interpreter_window, constants::ch8_width, constants::ch8_height},
+		m_engine{engine},
+		m_presentation_mode{presentation},
+		m_backend{backend},
 		m_machine_tick_period{tick_period},
+		m_batch_size{default_batch_size},
+		m_clock_source{clock_source::host},
+		m_flag_evaluation{flag_evaluation::eager},
+		m_memory_model{memory_model::strict},
+		m_quirk_profile{quirk_profile::modern},
+		m_handlers{&opcode_handlers::get_handler_table(quirk_profile::modern)},
+		m_execute_threaded{opcode_handlers::get_threaded_executor(quirk_profile::modern)},
+		m_fault_policy{fault_policy::halt},
+		m_machine_time{0ns},
+		m_scheduler{constants::frame_period},
+		m_is_frame_dirty{false},
+		m_frame_time{0ns},
+		m_delay_timer{constants::timer_tick_freq},
+		m_sound_timer{constants::timer_tick_freq},
+		m_is_sound_playing{false},
+		m_missed_timer_tick_count{0},
 		m_registers{constants::code_start},
-		m_video_mem(this->m_display.get_pixel_count())
+		m_deferred_flag{},
+		m_keys{0},
+		m_state{machine_state::running},
+		m_key_wait_register{0},
+		m_idle_loop{},
+		m_skipped_tick_count{0},
+		m_key_wait_tick_count{0},
+		m_last_fault{},
+		m_fault_count{0},
+		m_seed{0},
+		m_random{0},
+		m_video_mem{},
+		m_instruction_cache{&opcode_handlers::decode_and_execute},
+		m_fused_tick_count{0},
+		m_fusion_counts{}
 {
-	// Set up timers
-	// Timer index 0 - delay
-	// Timer index 1 - sound
-	this->m_timers.emplace_back(this->m_registers.delay, constants::timer_tick_freq);
-	this->m_timers.emplace_back(this->m_registers.sound, constants::timer_tick_freq,
-		std::bind(&sdl::beeper::play, &beeper),
-		std::bind(&sdl::beeper::pause, &beeper)
-	);
-
 	// Set up memory
-	std::copy_n(chip8::font::raw_data.begin(), chip8::font::raw_data.size(), this->m_mem.begin());
-	chip8::load_rom_from_file(rom_path, this->m_mem);
+	this->load_machine_state(rom_path);
+
+	// Set up execution engine
+	if (engine == execution_engine::jit)
+	{
+#ifdef CHIP8_ENABLE_JIT
+		this->m_jit = std::make_unique<jit::engine>(this->m_mem);
+#else
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "JIT is not available in this build, using interpreter");
+		this->m_engine = execution_engine::interpreter;
+#endif
+	}
+
+	if (engine == execution_engine::aot)
+		this->load_aot_program();
+
+#ifndef CHIP8_ENABLE_SPECIALIZED_DISPATCH
+	if (engine == execution_engine::specialized)
+	{
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Specialized dispatch is not available in this build, "
+			"using interpreter");
+		this->m_engine = execution_engine::interpreter;
+	}
+#endif
+
+	if (engine == execution_engine::threaded && !is_threaded_dispatch_available)
+	{
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Threaded dispatch is not supported by compiler, "
+			"using interpreter");
+		this->m_engine = execution_engine::interpreter;
+	}
+}
+
+interpreter::~interpreter() = default;
+
+void interpreter::reset(const std::filesystem::path& rom_path)
+{
+	this->m_is_running = true;
+	this->m_is_frame_dirty = false;
+	this->m_frame_time = 0ns;
+	this->m_machine_time = 0ns;
+	this->m_registers = registers{constants::code_start};
+	this->m_deferred_flag = deferred_flag{};
+	this->m_keys = 0;
+	this->m_state = machine_state::running;
+	this->m_skipped_tick_count = 0;
+	this->m_key_wait_tick_count = 0;
+	this->m_last_fault = fault_status{};
+	this->m_fault_count = 0;
+	this->m_fusion_counts.fill(0);
+	this->m_random.seed(this->m_seed);
+	this->m_delay_timer.reset();
+	this->m_sound_timer.reset();
+	this->m_missed_timer_tick_count = 0;
+	if (this->m_is_sound_playing)
+	{
+		this->m_is_sound_playing = false;
+		this->m_backend.pause_sound();
+	}
+
+	this->load_machine_state(rom_path);
+	this->m_instruction_cache.invalidate_all();
+
+#ifdef CHIP8_ENABLE_JIT
+	if (this->m_jit)
+		this->m_jit->invalidate_all();
+#endif
+
+	if (this->m_engine == execution_engine::aot)
+		this->load_aot_program();
 }
 
-void interpreter::run()
+snapshot_t interpreter::save_state() const noexcept
 {
-	size_t test_count = 0;
-	bool test_tick = false;
+	auto snapshot = snapshot_t{};
+	snapshot::store(snapshot, snapshot::magic_offset, snapshot::magic);
+	snapshot::store(snapshot, snapshot::version_offset, snapshot::version);
+
+	const auto state = (this->m_state == machine_state::idle) ? machine_state::running : this->m_state;
+	snapshot::store(snapshot, snapshot::state_offset, static_cast<uint8_t>(state));
+	snapshot::store(snapshot, snapshot::key_wait_register_offset, uint8_t(this->m_key_wait_register));
+
+	// VF deferred by lazy flag evaluation is stored computed
+	auto regs = this->m_registers;
+	auto flag = this->m_deferred_flag;
+	instructions::materialize_flag(regs, flag);
+	std::copy(regs.v.begin(), regs.v.end(), snapshot.begin() + snapshot::v_offset);
+	snapshot::store(snapshot, snapshot::i_offset, regs.i);
+	snapshot::store(snapshot, snapshot::pc_offset, regs.pc);
+	snapshot::store(snapshot, snapshot::sp_offset, uint8_t(regs.sp));
+	snapshot::store(snapshot, snapshot::delay_offset, this->m_delay_timer.get(this->m_machine_time));
+	snapshot::store(snapshot, snapshot::sound_offset, this->m_sound_timer.get(this->m_machine_time));
+	snapshot::store(snapshot, snapshot::machine_time_offset, uint64_t(this->m_machine_time.count()));
+
+	const auto& random_state = this->m_random.get_state();
+	for (auto idx = size_t{0}; idx < random_state.size(); ++idx)
+		snapshot::store(snapshot, snapshot::random_offset + idx * sizeof(uint32_t), random_state[idx]);
+
+	snapshot::store(snapshot, snapshot::fault_kind_offset, static_cast<uint8_t>(this->m_last_fault.kind));
+	snapshot::store(snapshot, snapshot::fault_pc_offset, this->m_last_fault.pc);
+	std::copy(this->m_last_fault.instruction.begin(), this->m_last_fault.instruction.end(),
+		snapshot.begin() + snapshot::fault_instruction_offset);
+
+	for (auto idx = size_t{0}; idx < this->m_stack.size(); ++idx)
+		snapshot::store(snapshot, snapshot::stack_offset + idx * sizeof(uint16_t), this->m_stack[idx]);
+
+	for (auto idx = size_t{0}; idx < this->m_video_mem.size(); ++idx)
+		snapshot::store(snapshot, snapshot::video_offset + idx * sizeof(uint64_t), this->m_video_mem[idx]);
+
+	std::copy(this->m_mem.begin(), this->m_mem.end(), snapshot.begin() + snapshot::mem_offset);
+	return snapshot;
+}
+
+void interpreter::load_state(const snapshot_t& snapshot)
+{
+	if (snapshot::load<uint32_t>(snapshot, snapshot::magic_offset) != snapshot::magic ||
+		snapshot::load<uint16_t>(snapshot, snapshot::version_offset) != snapshot::version)
+		throw std::invalid_argument("Snapshot has unknown format or version");
+
+	const auto state = snapshot::load<uint8_t>(snapshot, snapshot::state_offset);
+	const auto key_wait_register = snapshot::load<uint8_t>(snapshot, snapshot::key_wait_register_offset);
+	const auto sp = int8_t(snapshot::load<uint8_t>(snapshot, snapshot::sp_offset));
+	const auto fault_kind = snapshot::load<uint8_t>(snapshot, snapshot::fault_kind_offset);
+	if ((state != static_cast<uint8_t>(machine_state::running) &&
+		state != static_cast<uint8_t>(machine_state::waiting_for_key) &&
+		state != static_cast<uint8_t>(machine_state::faulted)) ||
+		key_wait_register >= constants::v_reg_count || sp < -1 || sp >= int(constants::stack_size) ||
+		fault_kind > static_cast<uint8_t>(fault::stack_underflow))
+		throw std::invalid_argument("Snapshot holds invalid machine state");
+
+	auto random_state = std::array<uint32_t, 4>{};
+	for (auto idx = size_t{0}; idx < random_state.size(); ++idx)
+		random_state[idx] = snapshot::load<uint32_t>(snapshot, snapshot::random_offset + idx * sizeof(uint32_t));
+
+	// Generator never leaves all-zero state, it would only produce zeros
+	if (std::all_of(random_state.begin(), random_state.end(), [](uint32_t word) { return word == 0; }))
+		throw std::invalid_argument("Snapshot holds invalid random generator state");
+
+	this->m_state = static_cast<machine_state>(state);
+	this->m_key_wait_register = key_wait_register;
+
+	std::copy_n(snapshot.begin() + snapshot::v_offset, this->m_registers.v.size(), this->m_registers.v.begin());
+	this->m_registers.i = snapshot::load<uint16_t>(snapshot, snapshot::i_offset);
+	this->m_registers.pc = snapshot::load<uint16_t>(snapshot, snapshot::pc_offset);
+	this->m_registers.sp = sp;
+	this->m_deferred_flag = deferred_flag{};
+
+	// Timers tick at multiples of their period since machine time zero, so values restore their expiry exactly
+	this->m_machine_time = std::chrono::nanoseconds(snapshot::load<uint64_t>(snapshot, snapshot::machine_time_offset));
+	this->m_registers.delay = snapshot::load<uint8_t>(snapshot, snapshot::delay_offset);
+	this->m_registers.sound = snapshot::load<uint8_t>(snapshot, snapshot::sound_offset);
+	this->m_delay_timer.set(this->m_registers.delay, this->m_machine_time);
+	this->m_sound_timer.set(this->m_registers.sound, this->m_machine_time);
+	if (const auto is_sound_playing = this->m_registers.sound > 0; is_sound_playing != this->m_is_sound_playing)
+	{
+		this->m_is_sound_playing = is_sound_playing;
+		if (is_sound_playing)
+			this->m_backend.play_sound();
+		else
+			this->m_backend.pause_sound();
+	}
+
+	this->m_random.set_state(random_state);
+
+	this->m_last_fault.kind = static_cast<fault>(fault_kind);
+	this->m_last_fault.pc = snapshot::load<uint16_t>(snapshot, snapshot::fault_pc_offset);
+	std::copy_n(snapshot.begin() + snapshot::fault_instruction_offset, this->m_last_fault.instruction.size(),
+		this->m_last_fault.instruction.begin());
+
+	for (auto idx = size_t{0}; idx < this->m_stack.size(); ++idx)
+		this->m_stack[idx] = snapshot::load<uint16_t>(snapshot, snapshot::stack_offset + idx * sizeof(uint16_t));
+
+	for (auto idx = size_t{0}; idx < this->m_video_mem.size(); ++idx)
+		this->m_video_mem[idx] = snapshot::load<uint64_t>(snapshot, snapshot::video_offset + idx * sizeof(uint64_t));
+	this->report_frame_change();
+
+	// Memory is compared in chunks, only the ones that differ are copied and reported as written
+	static constexpr auto chunk_size = size_t{64};
+	static_assert(constants::mem_size % chunk_size == 0, "Memory is not split into whole chunks");
+
+	const auto* source = snapshot.data() + snapshot::mem_offset;
+	for (auto address = size_t{0}; address < constants::mem_size; address += chunk_size)
+	{
+		if (std::memcmp(this->m_mem.data() + address, source + address, chunk_size) == 0)
+			continue;
+
+		std::memcpy(this->m_mem.data() + address, source + address, chunk_size);
+		this->report_memory_write(uint16_t(address), chunk_size);
+	}
+
+	std::copy(source + constants::mem_size, source + this->m_mem.size(), this->m_mem.begin() + constants::mem_size);
+}
+
+size_t interpreter::run(size_t instruction_limit)
+{
+	const auto is_uncapped = this->m_machine_tick_period == 0ns;
+	const auto is_virtual_time = this->m_clock_source == clock_source::virtual_time;
 	auto tick_time = std::chrono::high_resolution_clock::now();
 	auto machine_tick_count = 0ns;
+	auto executed = size_t{0};
+	this->m_scheduler.start();
 
-	while (this->m_is_running)
-	{
-		const auto tick_delta = calculate_tick_delta(tick_time);
+	// Halted machine stays stopped until reset, under any other policy the faulting instruction is executed again
+	if (this->m_state == machine_state::faulted && this->m_fault_policy != fault_policy::halt)
+		this->m_state = machine_state::running;
 
+	while (executed < instruction_limit)
+	{
 		// Process everything needed for interpreter
 		this->process_events();
-		this->process_timers(tick_delta);
+		if (!this->m_is_running)
+			break;
+
+		if (is_virtual_time)
+		{
+			executed += this->process_virtual_time_slice(instruction_limit - executed);
+			if (this->m_state == machine_state::faulted)
+				break;
+			if (this->m_state == machine_state::waiting_for_key)
+				this->m_backend.wait_for_events(constants::frame_period);
 
-		// Calculate and process machine tick
+			continue;
+		}
+
+		const auto tick_delta = calculate_tick_delta(tick_time);
+		this->advance_machine_time(tick_delta);
+		this->process_presentation(tick_delta);
+
+		// Calculate and process all machine ticks that are due in a single batch without any clock reads.
+		// Batch size is limited so events and timers keep being processed when host can't keep up
 		machine_tick_count += tick_delta;
-		if (machine_tick_count >= this->m_machine_tick_period)
+		const auto due_ticks = std::min({
+			is_uncapped ? this->m_batch_size : size_t(machine_tick_count / this->m_machine_tick_period),
+			this->m_batch_size,
+			instruction_limit - executed
+		});
+
+		if (due_ticks > 0)
+		{
+			const auto executed_ticks = this->process_machine_ticks(due_ticks);
+			executed += executed_ticks;
+			if (!is_uncapped)
+				machine_tick_count -= this->m_machine_tick_period * executed_ticks;
+		}
+
+		if (this->m_state == machine_state::faulted)
+			break;
+
+		// Block on input while waiting for a key. Waiting does not catch up on ticks missed while blocked, and
+		// scheduler counts it as sleep instead of a missed deadline
+		if (this->m_state == machine_state::waiting_for_key)
 		{
-			machine_tick_count -= this->m_machine_tick_period;
-			this->process_machine_tick();
+			if (is_uncapped)
+			{
+				this->m_backend.wait_for_events(constants::frame_period);
+				continue;
+			}
+
+			machine_tick_count %= this->m_machine_tick_period;
+			this->m_scheduler.wait_for_events([this] { this->m_backend.wait_for_events(constants::frame_period); });
+			continue;
 		}
+
+		// Uncapped machine has nothing to do until idle loop ends, so it gives the time to the host
+		if (this->m_state == machine_state::idle && is_uncapped)
+		{
+			this->m_backend.wait_for_events(std::min(constants::frame_period,
+				this->m_idle_loop.deadline - this->m_machine_time));
+			continue;
+		}
+
+		// Sleep once everything that was due is done, instead of polling the clock until the next tick
+		if (!is_uncapped && machine_tick_count < this->m_machine_tick_period)
+			this->m_scheduler.wait_for_next_slice();
 	}
+
+	instructions::materialize_flag(this->m_registers, this->m_deferred_flag);
+	this->sync_timer_registers();
+	this->present_pending_frame();
+	return executed;
 }
 
-void interpreter::process_events()
+void interpreter::set_batch_size(size_t batch_size)
 {
-	while (SDL_PollEvent(&this->m_evt))
+	if (batch_size == 0)
+		throw std::invalid_argument("Batch size must not be zero");
+
+	this->m_batch_size = batch_size;
+}
+
+size_t interpreter::get_batch_size() const noexcept
+{
+	return this->m_batch_size;
+}
+
+void interpreter::set_clock_source(clock_source source)
+{
+	if (source == clock_source::virtual_time && this->m_machine_tick_period == 0ns)
+		throw std::invalid_argument("Virtual time requires non-zero tick period");
+
+	this->m_clock_source = source;
+}
+
+clock_source interpreter::get_clock_source() const noexcept
+{
+	return this->m_clock_source;
+}
+
+void interpreter::set_flag_evaluation(flag_evaluation evaluation)
+{
+	if (evaluation == flag_evaluation::lazy)
+		this->fall_back_from_specialized("lazy flag evaluation");
+
+	if (evaluation == flag_evaluation::lazy && this->m_engine != execution_engine::interpreter &&
+		this->m_engine != execution_engine::threaded)
 	{
-		switch (this->m_evt.type)
-		{
-			case SDL_QUIT:
-				SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Quit event received");
-				this->m_is_running = false;
-				break;
-		}
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Lazy flag evaluation is only supported by interpreter and "
+			"threaded engines, using eager");
+		return;
 	}
+
+	// Cached instructions are decoded for a single flag evaluation
+	instructions::materialize_flag(this->m_registers, this->m_deferred_flag);
+	this->m_flag_evaluation = evaluation;
+	this->m_instruction_cache.invalidate_all();
 }
 
-void interpreter::process_timers(const std::chrono::nanoseconds& delta)
+flag_evaluation interpreter::get_flag_evaluation() const noexcept
 {
-	for (auto& timer : this->m_timers)
-		timer.update(delta);
+	return this->m_flag_evaluation;
 }
 
-void interpreter::process_machine_tick()
+void interpreter::set_memory_model(memory_model model)
 {
-	const auto instr = instructions::fetch(this->m_mem, this->m_registers.pc);
+	if (model == memory_model::masked)
+		this->fall_back_from_specialized("masked memory model");
 
-	auto throw_illegal_instruction = [&]
-	{
-		throw illegal_instruction{this->m_registers, instr};
-	};
+	// Cached instructions are decoded for a single memory model
+	this->m_memory_model = model;
+	this->m_instruction_cache.invalidate_all();
+}
 
-	switch(instructions::extract_instruction_class(instr))
-	{
-		case std::byte{0x0}: // Instruction starting with 0 are further split by their second byte
-		{
-			switch (instr[1])
-			{
-				case std::byte{0xE0}: // CLS
-					std::fill(this->m_video_mem.begin(), this->m_video_mem.end(), false);
-					this->m_display.draw(this->m_video_mem);
-					break;
+memory_model interpreter::get_memory_model() const noexcept
+{
+	return this->m_memory_model;
+}
 
-				case std::byte{0xEE}: // RET
-					instructions::ret(this->m_registers, this->m_stack);
-					break;
+void interpreter::set_quirk_profile(quirk_profile profile)
+{
+	if (profile != quirk_profile::modern)
+		this->fall_back_from_specialized("quirk profiles other than modern");
+
+	// Cached instructions and translated blocks are decoded for a single profile
+	this->m_quirk_profile = profile;
+	this->m_handlers = &opcode_handlers::get_handler_table(profile);
+	this->m_execute_threaded = opcode_handlers::get_threaded_executor(profile);
+	this->m_instruction_cache.invalidate_all();
+
+#ifdef CHIP8_ENABLE_JIT
+	if (this->m_jit)
+		this->m_jit->set_quirks(get_quirks(profile));
+#endif
+
+	if (this->m_engine == execution_engine::aot)
+		this->load_aot_program();
+}
 
-				default:
-					throw_illegal_instruction();
-			}
+quirk_profile interpreter::get_quirk_profile() const noexcept
+{
+	return this->m_quirk_profile;
+}
 
-			break;
-		}
+void interpreter::fall_back_from_specialized(std::string_view setting)
+{
+	if (this->m_engine != execution_engine::specialized)
+		return;
 
-		case std::byte{0x1}: // JP addr
-			instructions::jp(this->m_registers, instr);
-			return;
+	SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Specialized engine doesn't support %.*s, using interpreter",
+		int(setting.size()), setting.data());
+	this->m_engine = execution_engine::interpreter;
+}
 
-		case std::byte{0x2}: // CALL addr
-			instructions::call(this->m_registers, this->m_stack, instr);
-			return;
+void interpreter::set_fault_policy(fault_policy policy) noexcept
+{
+	this->m_fault_policy = policy;
+}
 
-		case std::byte{0x3}: // SE Vx, byte
-			instructions::se_reg_byte(this->m_registers, instr);
-			break;
+fault_policy interpreter::get_fault_policy() const noexcept
+{
+	return this->m_fault_policy;
+}
 
-		case std::byte{0x4}: // SNE Vx, byte
-			instructions::sne_reg_byte(this->m_registers, instr);
-			break;
+bool interpreter::is_faulted() const noexcept
+{
+	return this->m_state == machine_state::faulted;
+}
 
-		case std::byte{0x5}: // SE Vx, Vy
-			instructions::se_reg_reg(this->m_registers, instr);
-			break;
+const fault_status& interpreter::get_last_fault() const noexcept
+{
+	return this->m_last_fault;
+}
 
-		case std::byte{0x6}: // LD Vx, byte
-			instructions::ld_reg_byte(this->m_registers, instr);
-			break;
+size_t interpreter::get_fault_count() const noexcept
+{
+	return this->m_fault_count;
+}
 
-		case std::byte{0x7}: // ADD Vx, byte
-			instructions::add_reg_byte(this->m_registers, instr);
-			break;
+void interpreter::set_seed(uint64_t seed) noexcept
+{
+	this->m_seed = seed;
+	this->m_random.seed(seed);
+}
 
-		case std::byte{0x8}: // Instructions starting with 0x8 are further split by their lowest nibble
-		{
-			switch (instructions::get_lower_nibble<std::byte>(instr[1]))
-			{
-				case std::byte{0x00}: // LD Vx, Vy
-					instructions::ld_reg_reg(this->m_registers, instr);
-					break;
+uint64_t interpreter::get_seed() const noexcept
+{
+	return this->m_seed;
+}
 
-				case std::byte{0x01}: // OR Vx, Vy
-					instructions::or_reg_reg(this->m_registers, instr);
-					break;
+const scheduler_statistics& interpreter::get_scheduler_statistics() const noexcept
+{
+	return this->m_scheduler.get_statistics();
+}
 
-				case std::byte{0x02}: // AND Vx, Vy
-					instructions::and_reg_reg(this->m_registers, instr);
-					break;
+size_t interpreter::get_missed_timer_tick_count() const noexcept
+{
+	return this->m_missed_timer_tick_count;
+}
 
-				case std::byte{0x03}: // XOR Vx, Vy
-					instructions::xor_reg_reg(this->m_registers, instr);
-					break;
+size_t interpreter::get_skipped_tick_count() const noexcept
+{
+	return this->m_skipped_tick_count;
+}
 
-				case std::byte{0x04}: // ADD Vx, Vy
-					instructions::add_reg_reg(this->m_registers, instr);
-					break;
+size_t interpreter::get_key_wait_tick_count() const noexcept
+{
+	return this->m_key_wait_tick_count;
+}
 
-				case std::byte{0x05}: // SUB Vx, Vy
-					instructions::sub_reg_reg(this->m_registers, instr);
-					break;
+const std::array<size_t, fused_opcode_count>& interpreter::get_fusion_counts() const noexcept
+{
+	return this->m_fusion_counts;
+}
 
-				case std::byte{0x06}: // SHR Vx, Vy
-					instructions::shr_reg_reg(this->m_registers, instr);
-					break;
+const registers& interpreter::get_registers() const noexcept
+{
+	return this->m_registers;
+}
 
-				case std::byte{0x07}: // SUBN Vx, Vy
-					instructions::subn_reg_reg(this->m_registers, instr);
-					break;
+const framebuffer_t& interpreter::get_video_memory() const noexcept
+{
+	return this->m_video_mem;
+}
 
-				case std::byte{0x0E}: // SHL Vx, Vy
-					instructions::shl_reg_reg(this->m_registers, instr);
-					break;
+void interpreter::load_machine_state(const std::filesystem::path& rom_path)
+{
+	this->m_mem.fill(std::byte{0x00});
+	this->m_stack.fill(0);
+	this->m_video_mem.fill(0);
 
-				default:
-					throw_illegal_instruction();
-			}
+	std::copy_n(chip8::font::raw_data.begin(), chip8::font::raw_data.size(), this->m_mem.begin());
+	chip8::load_rom_from_file(rom_path, this->m_mem);
+}
 
-			break;
-		}
+void interpreter::load_aot_program()
+{
+	// Translated ALU instructions shift Vx in place
+	if (get_quirks(this->m_quirk_profile).is_shift_from_vy)
+	{
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Ahead-of-time translations don't support shifting Vy, "
+			"using interpreter");
+		this->m_aot.reset();
+		return;
+	}
 
-		case std::byte{0x9}: // SNE Vx, Vy
-			instructions::sne_reg_reg(this->m_registers, instr);
-			break;
+	// Translations are built into the executable, so only roms translated at build time have one
+	const auto* program = aot::find_program(this->m_mem);
+	if (!program)
+	{
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Rom has no ahead-of-time translation, using interpreter");
+		this->m_aot.reset();
+		return;
+	}
 
-		case std::byte{0xA}: // LD I, addr
-			instructions::ld_i_addr(this->m_registers, instr);
-			break;
+	SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Using ahead-of-time translation %.*s",
+		int(program->name.size()), program->name.data());
+	this->m_aot = std::make_unique<aot::engine>(*program);
+}
 
-		case std::byte{0xB}: // JP V0, addr
-			instructions::jp_v0_addr(this->m_registers, instr);
-			break;
+void interpreter::process_events()
+{
+	if (!this->m_backend.process_events(this->m_keys))
+		this->m_is_running = false;
+}
 
-		case std::byte{0xC}: // RND Vx, byte
-			instructions::rnd_reg_byte(this->m_registers, instr);
-			break;
+size_t interpreter::process_virtual_time_slice(size_t instruction_limit)
+{
+	// Batches end on timer ticks, so timer registers change after the same instruction on every run
+	const auto until_timer_tick = constants::timer_tick_freq - this->m_machine_time % constants::timer_tick_freq;
+	const auto ticks_until_timer_tick = size_t((until_timer_tick + this->m_machine_tick_period - 1ns) /
+		this->m_machine_tick_period);
+
+	// Idle loop can't end before the next timer tick, so it is skipped to it at once
+	const auto executed = this->process_machine_ticks(std::min({
+		(this->m_state == machine_state::idle) ? ticks_until_timer_tick : this->m_batch_size,
+		ticks_until_timer_tick,
+		instruction_limit
+	}));
+
+	const auto delta = this->m_machine_tick_period * executed;
+	this->advance_machine_time(delta);
+	this->process_presentation(delta);
+	return executed;
+}
 
-		case std::byte{0xD}: // DRW Vx, Vy, nibble
-		{
-			this->m_registers.v[0xF] = std::byte{0x00};
-			const auto x_offset = std::to_integer<uint8_t>(this->m_registers.v[instructions::get_lower_nibble<size_t>(instr[0])]);
-			auto y_offset = std::to_integer<uint8_t>(this->m_registers.v[instructions::get_upper_nibble<size_t>(instr[1])]);
-			const auto n_end = this->m_registers.i + instructions::get_lower_nibble<uint16_t>(instr[1]);
+void interpreter::advance_machine_time(const std::chrono::nanoseconds& delta)
+{
+	// Timers are derived from machine time when read, only lag and the end of sound need to be tracked
+	const auto passed_timer_ticks = (this->m_machine_time + delta) / constants::timer_tick_freq -
+		this->m_machine_time / constants::timer_tick_freq;
+	if (passed_timer_ticks > 1)
+		this->m_missed_timer_tick_count += size_t(passed_timer_ticks - 1);
+
+	this->m_machine_time += delta;
+	if (this->m_is_sound_playing && this->m_machine_time >= this->m_sound_timer.get_deadline())
+	{
+		this->m_is_sound_playing = false;
+		this->m_backend.pause_sound();
+	}
+}
 
-			for (size_t n_idx = this->m_registers.i; n_idx < n_end; ++n_idx)
-			{
-				auto sprite_line = std::bitset<8>(std::to_integer<uint8_t>(this->m_mem.at(n_idx)));
-				auto x_offset_line = x_offset;
+void interpreter::report_sound_timer_change()
+{
+	this->m_sound_timer.set(this->m_registers.sound, this->m_machine_time);
+	this->m_is_sound_playing = this->m_registers.sound > 0;
+	if (this->m_is_sound_playing)
+		this->m_backend.play_sound();
+	else
+		this->m_backend.pause_sound();
+}
+
+void interpreter::sync_timer_registers() noexcept
+{
+	this->m_registers.delay = this->m_delay_timer.get(this->m_machine_time);
+	this->m_registers.sound = this->m_sound_timer.get(this->m_machine_time);
+}
 
-				for (int bit_idx = sprite_line.size() - 1; bit_idx >= 0; --bit_idx)
-				{
-					const auto cur_idx = y_offset * this->m_display.get_width() + x_offset_line;
-					const auto prev_bit = bool{this->m_video_mem.at(cur_idx)};
-					const auto new_bit = bool{sprite_line[bit_idx]};
+void interpreter::process_presentation(const std::chrono::nanoseconds& delta)
+{
+	if (this->m_presentation_mode != presentation_mode::coalesced)
+		return;
 
-					this->m_video_mem[cur_idx] = prev_bit ^ new_bit;
-					if (prev_bit && new_bit)
-						this->m_registers.v[0xF] = std::byte{0x01};
+	// Frames that were missed are not made up for, only the latest state is presented
+	this->m_frame_time += delta;
+	if (this->m_frame_time < constants::frame_period)
+		return;
 
-					x_offset_line = wrap(x_offset_line + 1, this->m_display.get_width());
-				}
+	this->m_frame_time %= constants::frame_period;
+	this->present_pending_frame();
+}
 
-				y_offset = wrap(y_offset + 1, this->m_display.get_height());
-			}
+void interpreter::report_frame_change()
+{
+	if (this->m_presentation_mode == presentation_mode::immediate)
+		this->m_backend.draw(this->m_video_mem);
+	else
+		this->m_is_frame_dirty = true;
+}
 
-			this->m_display.draw(this->m_video_mem);
-			break;
-		}
+void interpreter::present_pending_frame()
+{
+	if (!this->m_is_frame_dirty)
+		return;
 
-		case std::byte{0xE}: // Instructions starting with 0xE are further split by their lowest byte
-		{
-			switch (instr[1])
-			{
-				case std::byte{0x9E}: // Ex9E - SKP Vx
-					instructions::skp_reg(this->m_registers, instr);
-					break;
+	this->m_is_frame_dirty = false;
+	this->m_backend.draw(this->m_video_mem);
+}
 
-				case std::byte{0xA1}: // ExA1 - SKNP Vx
-					instructions::sknp_reg(this->m_registers, instr);
-					break;
+size_t interpreter::process_machine_ticks(size_t count)
+{
+	if (this->m_state == machine_state::faulted)
+		return 0;
 
-				default:
-					throw_illegal_instruction();
-			}
+	// Ticks spent waiting for a key or in idle loop still count as executed, so timers and instruction
+	// limits keep going
+	if (this->m_state == machine_state::waiting_for_key && !this->complete_key_wait())
+	{
+		this->m_key_wait_tick_count += count;
+		return count;
+	}
 
-			break;
-		}
+	if (this->m_state == machine_state::idle)
+	{
+		if (const auto skipped = this->skip_idle_ticks(count))
+			return skipped;
+	}
 
-		case std::byte{0xF}: // Instructions starting with 0xF are further split by their lowest byte
-		{
-			switch (instr[1])
-			{
-				case std::byte{0x07}: // Fx07 - LD Vx, DT
-					instructions::ld_reg_dt(this->m_registers, instr);
-					break;
+	if (this->m_engine == execution_engine::threaded)
+		return this->m_execute_threaded(*this, count);
 
-				case std::byte{0x0A}: // LD Vx, K
-					if (!instructions::ld_reg_k(this->m_registers, instr))
-						return;
+#ifdef CHIP8_ENABLE_SPECIALIZED_DISPATCH
+	if (this->m_engine == execution_engine::specialized)
+		return opcode_handlers::execute_specialized(*this, count);
+#endif
 
-					break;
+	auto executed = size_t{0};
+	while (executed < count && this->m_state == machine_state::running)
+		executed += this->process_machine_tick(count - executed);
 
-				case std::byte{0x15}: // Fx15 - LD DT, Vx
-					instructions::ld_dt_reg(this->m_registers, instr);
-					this->m_timers[0].report_change();
-					break;
+	return executed;
+}
 
-				case std::byte{0x18}: // Fx18 - LD ST, Vx
-					instructions::ld_st_reg(this->m_registers, instr);
-					this->m_timers[1].report_change();
-					break;
+bool interpreter::complete_key_wait() noexcept
+{
+	if (!instructions::ld_reg_k(this->m_registers, this->m_keys, this->m_key_wait_register))
+		return false;
 
-				case std::byte{0x1E}: // Fx1E - ADD I, Vx
-					instructions::add_i_reg(this->m_registers, instr);
-					break;
+	this->m_state = machine_state::running;
+	this->m_registers.pc += 2;
+	return true;
+}
 
-				case std::byte{0x29}: // Fx29 - LD F, Vx
-					instructions::ld_f_reg(this->m_registers, instr);
-					break;
+void interpreter::enter_idle_loop(const idle_loop& loop) noexcept
+{
+	this->m_state = machine_state::idle;
+	this->m_idle_loop = loop;
+}
 
-				case std::byte{0x33}: // Fx33 - LD B, Vx
-					instructions::ld_b_reg(this->m_registers, this->m_mem, instr);
-					break;
+size_t interpreter::skip_idle_ticks(size_t count) noexcept
+{
+	auto& loop = this->m_idle_loop;
+	if (this->m_machine_time >= loop.deadline)
+	{
+		this->m_state = machine_state::running;
+		return 0;
+	}
 
-				case std::byte{0x55}: // Fx55 - ld [i], vx
-					instructions::str_i_reg(this->m_registers, this->m_mem, instr);
-					break;
+	// Leave PC where executing the loop for count ticks would
+	loop.position = uint16_t((loop.position + count) % loop.length);
+	this->m_registers.pc = uint16_t(loop.start + loop.position * 2);
+	this->m_skipped_tick_count += count;
+	return count;
+}
 
-				case std::byte{0x65}: // Fx65 - ld vx, [i]
-					instructions::str_reg_i(this->m_registers, this->m_mem, instr);
-					break;
+size_t interpreter::process_machine_tick(size_t tick_budget)
+{
+	// Blocks longer than the budget are left for the interpreter, so batches end on the same instruction
+	// with every engine
+#ifdef CHIP8_ENABLE_JIT
+	if (this->m_jit)
+	{
+		if (const auto executed = this->m_jit->execute(this->m_registers, tick_budget))
+			return executed;
+	}
+#endif
 
-				default:
-					throw_illegal_instruction();
-			}
+	if (this->m_aot)
+	{
+		if (const auto executed = this->m_aot->execute(this->m_registers, this->m_stack, tick_budget))
+			return executed;
+	}
 
-			break;
-		}
+	if (!this->check_pc_range())
+		return 0;
 
-		default:
-			throw_illegal_instruction();
+	const auto& instr = this->m_instruction_cache[this->m_registers.pc];
+
+	// Fused pair would overrun the budget, so only its first instruction is executed
+	auto executed = size_t{1};
+	if (tick_budget == 1 && is_fused_opcode(instr.op))
+	{
+		const auto first = opcode_handlers::unfuse(instr, *this->m_handlers);
+		first.handler(*this, first);
+	}
+	else
+	{
+		instr.handler(*this, instr);
+		executed += std::exchange(this->m_fused_tick_count, 0);
 	}
 
-	// If not returned before, PC was not changed by instruction, so increment it here
-	this->m_registers.pc += 2;
+	// Instruction stopped by a fault was not executed
+	return (this->m_state == machine_state::faulted) ? executed - 1 : executed;
+}
+
+void interpreter::report_memory_write(uint16_t address, size_t byte_count) noexcept
+{
+	this->m_instruction_cache.invalidate(address, byte_count);
+
+#ifdef CHIP8_ENABLE_JIT
+	if (this->m_jit)
+		this->m_jit->invalidate(address, byte_count);
+#endif
+
+	if (this->m_aot)
+		this->m_aot->invalidate(address, byte_count);
+}
+
+void interpreter::raise_fault(fault kind) noexcept
+{
+	const auto pc = this->m_registers.pc;
+	auto instruction = instr_t{};
+	if (size_t{pc} + 2 <= constants::mem_size)
+		instruction = instr_t{this->m_mem[pc], this->m_mem[pc + 1]};
+
+	this->m_last_fault = fault_status{kind, pc, instruction};
+	++this->m_fault_count;
+
+	if (this->m_fault_policy == fault_policy::skip && kind != fault::pc_out_of_range)
+		this->m_registers.pc += 2;
+	else
+		this->m_state = machine_state::faulted;
+}
+
+bool interpreter::check_pc_range() noexcept
+{
+	if (size_t{this->m_registers.pc} + 2 <= constants::mem_size)
+		return true;
+
+	this->raise_fault(fault::pc_out_of_range);
+	return false;
 }
@@ -1,45 +1,229 @@
 #ifndef INTERPRETER_HPP
 #define INTERPRETER_HPP
 
+#include "clock_source.hpp"
+#include "execution_engine.hpp"
+#include "fault.hpp"
+#include "flag_evaluation.hpp"
+#include "instruction_cache.hpp"
+#include "memory_model.hpp"
+#include "presentation_mode.hpp"
+#include "quirks.hpp"
+#include "random_generator.hpp"
 #include "registers.hpp"
+#include "scheduler.hpp"
+#include "snapshot.hpp"
 #include "timer.hpp"
 #include "types.hpp"
-#include "sdl/sdl_beeper.hpp"
-#include "io/display.hpp"
-
-#include <SDL_events.h>
+#include "io/backend.hpp"
 
 #include <array>
 #include <filesystem>
+#include <limits>
+#include <memory>
+#include <string_view>
 
 namespace chip8
 {
+	namespace jit
+	{
+		struct engine;
+	}
+
+	namespace aot
+	{
+		struct engine;
+	}
+
 	struct interpreter
 	{
+		// Instructions executed between two rounds of event, timer and clock processing
+		static constexpr auto default_batch_size = size_t{64};
+
+		// Zero tick period runs the machine as fast as the host allows
 		interpreter(
 			const std::filesystem::path& rom_path,
-			sdl::window& interpreter_window,
-			sdl::beeper& beeper,
-			std::chrono::nanoseconds tick_period);
+			chip8::backend& backend,
+			std::chrono::nanoseconds tick_period,
+			execution_engine engine = execution_engine::interpreter,
+			presentation_mode presentation = presentation_mode::immediate);
+		~interpreter();
+
+		// Restores power-on state and loads another rom, keeping backend, engine and allocated resources
+		void reset(const std::filesystem::path& rom_path);
+
+		// Captures registers, memory, stack, screen, timers, random generator, key wait and fault of the machine.
+		// Settings, statistics and key presses are not part of the snapshot. Machine in an idle loop is captured
+		// as running, it goes through the loop instructions again once restored
+		[[nodiscard]] snapshot_t save_state() const noexcept;
+
+		// Restores machine captured by save_state, which may come from another interpreter with the same settings.
+		// Only cached instructions and translated blocks overlapping memory that differs are dropped. Throws
+		// std::invalid_argument for snapshots of another version or with invalid machine state
+		void load_state(const snapshot_t& snapshot);
+
+		// Runs until backend requests a stop or instruction_limit instructions were executed. JIT and AOT blocks
+		// that don't fit the limit are left for the interpreter, so it is never overshot. Ticks spent waiting for a
+		// key in LD Vx, K count as executed. A frame still pending in coalesced presentation mode is presented
+		// before returning. Stops early at a fault unless fault policy skips it, faulting instruction doesn't count
+		// as executed. Returns number of executed instructions
+		size_t run(size_t instruction_limit = std::numeric_limits<size_t>::max());
+
+		// Batch size of one processes events and timers after every instruction. When tick period is not
+		// zero, batch only limits how many overdue instructions are executed at once
+		void set_batch_size(size_t batch_size);
+		[[nodiscard]] size_t get_batch_size() const noexcept;
+
+		// In virtual time every instruction lasts exactly one tick period, so timers change after the same
+		// instruction on every run. Requires non-zero tick period
+		void set_clock_source(clock_source source);
+		[[nodiscard]] clock_source get_clock_source() const noexcept;
+
+		/*	Specialized engine is replaced by interpreter whenever a setting it doesn't support is picked, so the
+		 *	result doesn't depend on the order of the following setters.
+		 */
+
+		// Lazy flag evaluation is only supported by interpreter and threaded engines, JIT and AOT keep eager one.
+		// VF is always up to date once run returns
+		void set_flag_evaluation(flag_evaluation evaluation);
+		[[nodiscard]] flag_evaluation get_flag_evaluation() const noexcept;
+
+		// Masked memory model is supported by every engine except specialized one
+		void set_memory_model(memory_model model);
+		[[nodiscard]] memory_model get_memory_model() const noexcept;
+
+		// Profile of behaviour that differs between CHIP-8 implementations, modern is the default. Specialized engine
+		// only supports modern profile and is replaced by interpreter for others, AOT translations only run under
+		// profiles shifting Vx in place
+		void set_quirk_profile(quirk_profile profile);
+		[[nodiscard]] quirk_profile get_quirk_profile() const noexcept;
 
-		void run();
+		// Decides what happens when an instruction faults, halting is the default
+		void set_fault_policy(fault_policy policy) noexcept;
+		[[nodiscard]] fault_policy get_fault_policy() const noexcept;
+
+		// Whether machine stopped at a fault, which it will retry on the next run unless fault policy halts
+		[[nodiscard]] bool is_faulted() const noexcept;
+
+		// Last fault raised since reset, including skipped ones. Kind is none if there was no fault
+		[[nodiscard]] const fault_status& get_last_fault() const noexcept;
+		[[nodiscard]] size_t get_fault_count() const noexcept;
+
+		// Seeds generator used by RND. Seed is kept, so every reset replays the same random sequence
+		void set_seed(uint64_t seed) noexcept;
+		[[nodiscard]] uint64_t get_seed() const noexcept;
+
+		// Pacing of the last run, only updated when tick period is not zero
+		[[nodiscard]] const scheduler_statistics& get_scheduler_statistics() const noexcept;
+
+		// Timer ticks which passed without the program having a chance to run in between, counted since reset
+		[[nodiscard]] size_t get_missed_timer_tick_count() const noexcept;
+
+		// Machine ticks spent in idle loops without executing them, counted since reset
+		[[nodiscard]] size_t get_skipped_tick_count() const noexcept;
+
+		// Machine ticks spent waiting for a key in LD Vx, K, counted since reset
+		[[nodiscard]] size_t get_key_wait_tick_count() const noexcept;
+
+		// How many times each fused instruction pair executed both of its instructions with a single dispatch,
+		// indexed from the first fused opcode and counted since reset
+		[[nodiscard]] const std::array<size_t, fused_opcode_count>& get_fusion_counts() const noexcept;
+
+		[[nodiscard]] const registers& get_registers() const noexcept;
+		[[nodiscard]] const framebuffer_t& get_video_memory() const noexcept;
 
 	private:
+		friend struct opcode_handlers;
+
+		// Instructions are only fetched in running state
+		enum class machine_state
+		{
+			running,
+			waiting_for_key,
+			idle,
+			faulted
+		};
+
+		/*	Loop of length instructions starting at start address, which has no effects other than moving
+		 *	through its instructions until deadline. Position is the index of instruction at PC.
+		 */
+		struct idle_loop
+		{
+			uint16_t start;
+			uint16_t length;
+			uint16_t position;
+			std::chrono::nanoseconds deadline;
+		};
+
+		void load_machine_state(const std::filesystem::path& rom_path);
+		void load_aot_program();
+		void fall_back_from_specialized(std::string_view setting);
 		void process_events();
-		void process_timers(const std::chrono::nanoseconds& delta);
-		void process_machine_tick();
+		[[nodiscard]] size_t process_virtual_time_slice(size_t instruction_limit);
+		void advance_machine_time(const std::chrono::nanoseconds& delta);
+		void report_sound_timer_change();
+		void sync_timer_registers() noexcept;
+		void process_presentation(const std::chrono::nanoseconds& delta);
+		void report_frame_change();
+		void present_pending_frame();
+		[[nodiscard]] size_t process_machine_ticks(size_t count);
+		[[nodiscard]] bool complete_key_wait() noexcept;
+		void enter_idle_loop(const idle_loop& loop) noexcept;
+		[[nodiscard]] size_t skip_idle_ticks(size_t count) noexcept;
+		[[nodiscard]] size_t process_machine_tick(size_t tick_budget);
+		void report_memory_write(uint16_t address, size_t byte_count) noexcept;
+
+		// Records fault of instruction at PC and applies fault policy to it
+		void raise_fault(fault kind) noexcept;
+
+		// Raises PC out of range fault unless a whole instruction can be fetched at PC
+		[[nodiscard]] bool check_pc_range() noexcept;
 
 		bool m_is_running;
-		sdl::window& m_interpreter_window;
-		display m_display;
+		execution_engine m_engine;
+		const presentation_mode m_presentation_mode;
+		chip8::backend& m_backend;
 		const std::chrono::nanoseconds m_machine_tick_period;
-		SDL_Event m_evt;
+		size_t m_batch_size;
+		clock_source m_clock_source;
+		flag_evaluation m_flag_evaluation;
+		memory_model m_memory_model;
+		quirk_profile m_quirk_profile;
+		const handler_table_t* m_handlers;
+		size_t (*m_execute_threaded)(interpreter&, size_t);
+		fault_policy m_fault_policy;
+		std::chrono::nanoseconds m_machine_time;
+
+		scheduler m_scheduler;
+		bool m_is_frame_dirty;
+		std::chrono::nanoseconds m_frame_time;
 
-		std::vector<chip8::timer> m_timers;
+		chip8::timer m_delay_timer;
+		chip8::timer m_sound_timer;
+		bool m_is_sound_playing;
+		size_t m_missed_timer_tick_count;
 		registers m_registers;
+		deferred_flag m_deferred_flag;
+		keyboard_state m_keys;
+		machine_state m_state;
+		size_t m_key_wait_register;
+		idle_loop m_idle_loop;
+		size_t m_skipped_tick_count;
+		size_t m_key_wait_tick_count;
+		fault_status m_last_fault;
+		size_t m_fault_count;
+		uint64_t m_seed;
+		random_generator m_random;
 		memory_t m_mem;
 		stack_t m_stack;
-		std::vector<bool> m_video_mem;
+		framebuffer_t m_video_mem;
+		instruction_cache m_instruction_cache;
+		size_t m_fused_tick_count;
+		std::array<size_t, fused_opcode_count> m_fusion_counts;
+#ifdef CHIP8_ENABLE_JIT
+		std::unique_ptr<jit::engine> m_jit;
+#endif
+		std::unique_ptr<aot::engine> m_aot;
 	};
 }
 
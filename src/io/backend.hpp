@@ -0,0 +1,29 @@
+#ifndef BACKEND_HPP
+#define BACKEND_HPP
+
+#include "types.hpp"
+
+#include <chrono>
+
+namespace chip8
+{
+	// Host side of the interpreter. Presents frames, plays sound and provides input
+	struct backend
+	{
+		virtual ~backend() = default;
+
+		virtual void draw(const framebuffer_t& frame) = 0;
+
+		virtual void play_sound() noexcept = 0;
+		virtual void pause_sound() noexcept = 0;
+
+		// Processes pending host events and applies key changes to keys. Returns false when the interpreter
+		// should stop
+		[[nodiscard]] virtual bool process_events(keyboard_state& keys) = 0;
+
+		// Blocks until an event arrives or timeout passes, events are left for process_events
+		virtual void wait_for_events(std::chrono::nanoseconds timeout) = 0;
+	};
+}
+
+#endif /* BACKEND_HPP */
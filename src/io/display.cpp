@@ -1,4 +1,5 @@
 #include "display.hpp"
+#include "framebuffer.hpp"
 #include "errors/sdl_exception.hpp"
 
 #include <array>
@@ -23,14 +24,15 @@ display::~display()
 	SDL_FreeSurface(this->m_surface);
 }
 
-void display::draw(const std::vector<bool>& pixels)
+void display::draw(const framebuffer_t& frame)
 {
-	assert(pixels.size() == this->m_pixel_count);
+	assert(frame.size() * constants::ch8_width == this->m_pixel_count);
 
 	// Update current surface
-	for (size_t cnt = 0; cnt < pixels.size(); ++cnt)
-		std::memset(&static_cast<std::byte*>(this->m_surface->pixels)[cnt * 4],
-			pixels[cnt] ? 0xff : 0x00, 4);
+	for (size_t y = 0; y < frame.size(); ++y)
+		for (size_t x = 0; x < constants::ch8_width; ++x)
+			std::memset(&static_cast<std::byte*>(this->m_surface->pixels)[(y * constants::ch8_width + x) * 4],
+				framebuffer::get_pixel(frame, x, y) ? 0xff : 0x00, 4);
 
 	// Blit everything to main window
 	auto& window_surface = this->m_window.get_window_surface();
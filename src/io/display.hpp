@@ -2,11 +2,10 @@
 #define DISPLAY_HPP
 
 #include "sdl/sdl_window.hpp"
+#include "types.hpp"
 
 #include <SDL_surface.h>
 
-#include <vector>
-
 namespace chip8
 {
 	struct display
@@ -14,7 +13,7 @@ namespace chip8
 		display(sdl::window& window, size_t game_width, size_t game_height);
 		~display();
 
-		void draw(const std::vector<bool>& pixels);
+		void draw(const framebuffer_t& frame);
 
 		size_t get_pixel_count() const noexcept;
 		int get_width() const noexcept;
@@ -0,0 +1,81 @@
+#include "io/headless_backend.hpp"
+
+#include <stdexcept>
+#include <thread>
+
+using namespace chip8;
+
+namespace
+{
+	inline void check_key(size_t key)
+	{
+		if (key >= key_count)
+			throw std::out_of_range("Key index out of range");
+	}
+}
+
+void headless_backend::draw(const framebuffer_t&)
+{
+	++this->m_frame_count;
+}
+
+void headless_backend::play_sound() noexcept
+{
+	this->m_is_sound_playing = true;
+}
+
+void headless_backend::pause_sound() noexcept
+{
+	this->m_is_sound_playing = false;
+}
+
+bool headless_backend::process_events(keyboard_state& keys)
+{
+	keys = this->m_keys;
+	return !this->m_is_stop_requested;
+}
+
+void headless_backend::wait_for_events(std::chrono::nanoseconds)
+{
+	std::this_thread::yield();
+}
+
+void headless_backend::set_keyboard_state(keyboard_state keys) noexcept
+{
+	this->m_keys = keys;
+}
+
+void headless_backend::press_key(size_t key)
+{
+	check_key(key);
+	this->m_keys |= keyboard_state(1 << key);
+}
+
+void headless_backend::release_key(size_t key)
+{
+	check_key(key);
+	this->m_keys &= keyboard_state(~(1 << key));
+}
+
+void headless_backend::request_stop() noexcept
+{
+	this->m_is_stop_requested = true;
+}
+
+void headless_backend::reset() noexcept
+{
+	this->m_keys = 0;
+	this->m_frame_count = 0;
+	this->m_is_sound_playing = false;
+	this->m_is_stop_requested = false;
+}
+
+size_t headless_backend::get_frame_count() const noexcept
+{
+	return this->m_frame_count;
+}
+
+bool headless_backend::is_sound_playing() const noexcept
+{
+	return this->m_is_sound_playing;
+}
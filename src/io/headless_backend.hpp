@@ -0,0 +1,47 @@
+#ifndef HEADLESS_BACKEND_HPP
+#define HEADLESS_BACKEND_HPP
+
+#include "io/backend.hpp"
+
+#include <cstddef>
+
+namespace chip8
+{
+	/*	Backend without any host devices, used to run roms on machines without a display.
+	 *	Frames are only counted, sound is only tracked and input is set programmatically.
+	 */
+	struct headless_backend final : backend
+	{
+		void draw(const framebuffer_t& frame) override;
+
+		void play_sound() noexcept override;
+		void pause_sound() noexcept override;
+
+		// Replaces keys with programmatically set state
+		[[nodiscard]] bool process_events(keyboard_state& keys) override;
+
+		// Input never arrives on its own, so only gives up the rest of the time slice
+		void wait_for_events(std::chrono::nanoseconds timeout) override;
+
+		void set_keyboard_state(keyboard_state keys) noexcept;
+		void press_key(size_t key);
+		void release_key(size_t key);
+
+		// Interpreter stops the next time it processes events
+		void request_stop() noexcept;
+
+		// Releases all keys, clears stop request and statistics
+		void reset() noexcept;
+
+		[[nodiscard]] size_t get_frame_count() const noexcept;
+		[[nodiscard]] bool is_sound_playing() const noexcept;
+
+	private:
+		keyboard_state m_keys = 0;
+		size_t m_frame_count = 0;
+		bool m_is_sound_playing = false;
+		bool m_is_stop_requested = false;
+	};
+}
+
+#endif /* HEADLESS_BACKEND_HPP */
@@ -1,17 +1,15 @@
 #ifndef INPUT_HPP
 #define INPUT_HPP
 
+#include "types.hpp"
+
 #include <SDL_keycode.h>
 
 #include <array>
-#include <bitset>
+#include <optional>
 
 namespace chip8
 {
-	static constexpr auto key_count = size_t{16};
-
-	using keyboard_state = std::bitset<key_count>;
-
 	/*	Default keyboard map
 	 *		---------
 	 *		|2|3|4|5|
@@ -28,8 +26,15 @@ namespace chip8
 		SDL_SCANCODE_5, SDL_SCANCODE_T, SDL_SCANCODE_F, SDL_SCANCODE_V
 	};
 
-	// Ensure that chip8::get_keyboard_state() is called after all events have been processed
-	keyboard_state get_keyboard_state() noexcept;
+	// Returns chip8 key bound to scancode or nullopt if it is not bound
+	[[nodiscard]] constexpr std::optional<size_t> map_scancode(int scancode) noexcept
+	{
+		for (size_t key = 0; key < key_count; ++key)
+			if (default_map[key] == scancode)
+				return key;
+
+		return std::nullopt;
+	}
 }
 
 #endif /* INPUT_HPP */
@@ -0,0 +1,111 @@
+#include "renderer_display.hpp"
+#include "constants.hpp"
+#include "framebuffer.hpp"
+#include "errors/sdl_exception.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include <SDL_log.h>
+
+using namespace chip8;
+using namespace std::literals::string_literals;
+
+namespace
+{
+	[[nodiscard]] SDL_Texture* create_texture(SDL_Renderer* renderer)
+	{
+		return SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STREAMING,
+			constants::ch8_width, constants::ch8_height);
+	}
+}
+
+renderer_display::renderer_display(sdl::window& window) :
+	m_uploaded_frame{},
+	m_is_texture_initialized{false}
+{
+	this->m_renderer = SDL_CreateRenderer(&window.get_native_window(), -1, SDL_RENDERER_ACCELERATED);
+	sdl::sdl_check_null(this->m_renderer, "Unable to create renderer"s);
+
+	this->m_texture = create_texture(this->m_renderer);
+	if (!this->m_texture)
+	{
+		SDL_DestroyRenderer(this->m_renderer);
+		sdl::sdl_check_null(this->m_texture, "Unable to create game texture"s);
+	}
+}
+
+renderer_display::~renderer_display()
+{
+	SDL_DestroyTexture(this->m_texture);
+	SDL_DestroyRenderer(this->m_renderer);
+}
+
+void renderer_display::draw(const framebuffer_t& frame)
+{
+	// Upload runs of changed rows, every row is uploaded for the first frame
+	auto row = size_t{0};
+	while (row < frame.size())
+	{
+		const auto is_row_changed = [&](size_t idx)
+		{
+			return !this->m_is_texture_initialized || frame[idx] != this->m_uploaded_frame[idx];
+		};
+
+		if (!is_row_changed(row))
+		{
+			++row;
+			continue;
+		}
+
+		auto end_row = row + 1;
+		while (end_row < frame.size() && is_row_changed(end_row))
+			++end_row;
+
+		this->upload_rows(frame, row, end_row - row);
+		row = end_row;
+	}
+
+	this->m_uploaded_frame = frame;
+	this->m_is_texture_initialized = true;
+
+	// Renderer scales texture to the whole window
+	sdl::sdl_check_error(SDL_RenderCopy(this->m_renderer, this->m_texture, nullptr, nullptr),
+		"Unable to copy game texture"s);
+	SDL_RenderPresent(this->m_renderer);
+}
+
+void renderer_display::restore(bool is_device_reset)
+{
+	if (is_device_reset)
+	{
+		SDL_DestroyTexture(this->m_texture);
+		this->m_texture = create_texture(this->m_renderer);
+		sdl::sdl_check_null(this->m_texture, "Unable to recreate game texture"s);
+	}
+
+	// Frames are only drawn when they change, so the last one is uploaded whole right away
+	this->m_is_texture_initialized = false;
+	const auto frame = this->m_uploaded_frame;
+	this->draw(frame);
+}
+
+void renderer_display::upload_rows(const framebuffer_t& frame, size_t first_row, size_t row_count)
+{
+	const auto rect = SDL_Rect{0, static_cast<int>(first_row), constants::ch8_width, static_cast<int>(row_count)};
+	void* pixels = nullptr;
+	auto pitch = 0;
+	sdl::sdl_check_error(SDL_LockTexture(this->m_texture, &rect, &pixels, &pitch), "Unable to lock game texture"s);
+
+	for (size_t row = 0; row < row_count; ++row)
+	{
+		auto line = std::array<uint32_t, constants::ch8_width>{};
+		for (size_t x = 0; x < line.size(); ++x)
+			line[x] = framebuffer::get_pixel(frame, x, first_row + row) ? 0xFFFFFF : 0x000000;
+
+		std::memcpy(static_cast<std::byte*>(pixels) + row * pitch, line.data(), sizeof(line));
+	}
+
+	SDL_UnlockTexture(this->m_texture);
+}
@@ -0,0 +1,42 @@
+#ifndef RENDERER_DISPLAY_HPP
+#define RENDERER_DISPLAY_HPP
+
+#include "sdl/sdl_window.hpp"
+#include "types.hpp"
+
+#include <SDL_render.h>
+
+#include <cstddef>
+
+namespace chip8
+{
+	/*	Presents frames through SDL_Renderer, which scales a native resolution streaming texture to the window.
+	 *	Only rows that changed since the previous frame are uploaded to the texture.
+	 */
+	struct renderer_display
+	{
+		explicit renderer_display(sdl::window& window);
+		~renderer_display();
+
+		renderer_display(const renderer_display&) = delete;
+		renderer_display& operator=(const renderer_display&) = delete;
+
+		void draw(const framebuffer_t& frame);
+
+		// Presents the last frame again after the renderer lost texture contents, which happens when it resets its
+		// targets. Device reset loses the texture itself, so it is created again.
+		void restore(bool is_device_reset);
+
+	private:
+		void upload_rows(const framebuffer_t& frame, size_t first_row, size_t row_count);
+
+		SDL_Renderer* m_renderer;
+		SDL_Texture* m_texture;
+
+		// Frame currently held by the texture
+		framebuffer_t m_uploaded_frame;
+		bool m_is_texture_initialized;
+	};
+}
+
+#endif /* RENDERER_DISPLAY_HPP */
@@ -0,0 +1,82 @@
+#include "io/sdl_backend.hpp"
+
+#include "constants.hpp"
+#include "io/input.hpp"
+
+#include <SDL_log.h>
+
+using namespace chip8;
+
+sdl_backend::sdl_backend(sdl::window& window, sdl::beeper& beeper, display_driver driver) :
+	m_beeper{beeper}
+{
+	if (driver == display_driver::renderer)
+		this->m_renderer_display.emplace(window);
+	else
+		this->m_surface_display.emplace(window, constants::ch8_width, constants::ch8_height);
+}
+
+void sdl_backend::draw(const framebuffer_t& frame)
+{
+	if (this->m_renderer_display)
+		this->m_renderer_display->draw(frame);
+	else
+		this->m_surface_display->draw(frame);
+}
+
+void sdl_backend::play_sound() noexcept
+{
+	this->m_beeper.play();
+}
+
+void sdl_backend::pause_sound() noexcept
+{
+	this->m_beeper.pause();
+}
+
+bool sdl_backend::process_events(keyboard_state& keys)
+{
+	auto is_running = true;
+	while (SDL_PollEvent(&this->m_evt))
+	{
+		switch (this->m_evt.type)
+		{
+			case SDL_QUIT:
+				SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Quit event received");
+				is_running = false;
+				break;
+
+			case SDL_KEYDOWN:
+			case SDL_KEYUP:
+				if (const auto key = chip8::map_scancode(this->m_evt.key.keysym.scancode))
+				{
+					const auto mask = keyboard_state(1 << *key);
+					keys = (this->m_evt.type == SDL_KEYDOWN) ? (keys | mask) : (keys & ~mask);
+				}
+				break;
+
+			case SDL_WINDOWEVENT:
+				// Key releases are not delivered to unfocused window, so nothing stays pressed
+				if (this->m_evt.window.event == SDL_WINDOWEVENT_FOCUS_LOST)
+					keys = 0;
+				break;
+
+			case SDL_RENDER_TARGETS_RESET:
+			case SDL_RENDER_DEVICE_RESET:
+				// Surface display draws whole frames, so only the renderer has to restore what it lost
+				SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Renderer reset event received");
+				if (this->m_renderer_display)
+					this->m_renderer_display->restore(this->m_evt.type == SDL_RENDER_DEVICE_RESET);
+				break;
+		}
+	}
+
+	return is_running;
+}
+
+void sdl_backend::wait_for_events(std::chrono::nanoseconds timeout)
+{
+	// Rounded up, so short timeouts don't turn into polling
+	const auto timeout_ms = std::chrono::ceil<std::chrono::milliseconds>(timeout);
+	static_cast<void>(SDL_WaitEventTimeout(nullptr, int(timeout_ms.count())));
+}
@@ -0,0 +1,58 @@
+#ifndef SDL_BACKEND_HPP
+#define SDL_BACKEND_HPP
+
+#include "io/backend.hpp"
+#include "io/display.hpp"
+#include "io/renderer_display.hpp"
+#include "sdl/sdl_beeper.hpp"
+#include "sdl/sdl_window.hpp"
+
+#include <SDL_events.h>
+
+#include <optional>
+#include <string_view>
+
+namespace chip8
+{
+	enum class display_driver
+	{
+		// Software scaled surface blitted to window surface
+		surface,
+		// Streaming texture scaled by SDL_Renderer
+		renderer
+	};
+
+	// Maps command line display driver name to driver, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<display_driver> parse_display_driver_name(std::string_view name) noexcept
+	{
+		if (name == "surface")
+			return display_driver::surface;
+		if (name == "renderer")
+			return display_driver::renderer;
+
+		return std::nullopt;
+	}
+
+	// Presents frames to an SDL window, plays sound through SDL audio and reads SDL key events
+	struct sdl_backend final : backend
+	{
+		sdl_backend(sdl::window& window, sdl::beeper& beeper, display_driver driver = display_driver::renderer);
+
+		void draw(const framebuffer_t& frame) override;
+
+		void play_sound() noexcept override;
+		void pause_sound() noexcept override;
+
+		[[nodiscard]] bool process_events(keyboard_state& keys) override;
+		void wait_for_events(std::chrono::nanoseconds timeout) override;
+
+	private:
+		// Exactly one of the displays is created
+		std::optional<display> m_surface_display;
+		std::optional<renderer_display> m_renderer_display;
+		sdl::beeper& m_beeper;
+		SDL_Event m_evt;
+	};
+}
+
+#endif /* SDL_BACKEND_HPP */
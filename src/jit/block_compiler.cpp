@@ -0,0 +1,484 @@
+#include "jit/block_compiler.hpp"
+#include "jit/x86_64_emitter.hpp"
+
+#include "chip8_font.hpp"
+#include "instructions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+
+using namespace chip8;
+using namespace chip8::jit;
+using namespace chip8::jit::x86_64;
+
+namespace
+{
+	enum class instruction_kind
+	{
+		unsupported,
+		regular,
+		terminator
+	};
+
+	// Guest register indices used for register allocation: V0-VF followed by I
+	static constexpr auto i_reg_idx = constants::v_reg_count;
+	static constexpr auto guest_reg_count = constants::v_reg_count + 1;
+
+	// Host register holding the pointer to chip8::registers (first System V argument)
+	static constexpr auto regs_ptr = reg::rdi;
+
+	// Host registers available for guest registers. Caller saved ones first, so short blocks don't need to
+	// save anything
+	static constexpr auto allocatable_regs = std::array
+	{
+		reg::rsi, reg::r8, reg::r9, reg::r10, reg::r11,
+		reg::rbx, reg::rbp, reg::r12, reg::r13, reg::r14, reg::r15
+	};
+
+	[[nodiscard]] constexpr bool is_callee_saved(reg r) noexcept
+	{
+		return r == reg::rbx || r == reg::rbp || r >= reg::r12;
+	}
+
+	[[nodiscard]] instruction_kind classify(instr_t instr, uint16_t address) noexcept
+	{
+		switch (std::to_integer<uint8_t>(instructions::extract_instruction_class(instr)))
+		{
+			case 0x1: // JP addr
+				// Jump to itself is an idle loop, which interpreter handlers skip until the next timer tick
+				return (instructions::detail::get_lower_12_bits<uint16_t>(instr) == address) ?
+					instruction_kind::unsupported : instruction_kind::terminator;
+
+			case 0x3: // SE Vx, byte
+			case 0x4: // SNE Vx, byte
+			case 0x5: // SE Vx, Vy
+			case 0x9: // SNE Vx, Vy
+			case 0xB: // JP V0, addr
+				return instruction_kind::terminator;
+
+			case 0x6: // LD Vx, byte
+			case 0x7: // ADD Vx, byte
+			case 0xA: // LD I, addr
+				return instruction_kind::regular;
+
+			// Stack bounds of CALL and RET are checked by interpreter handlers, so blocks end before them
+			case 0x0: // CLS, RET
+			case 0x2: // CALL addr
+				return instruction_kind::unsupported;
+
+			case 0x8:
+			{
+				const auto op = instructions::get_lower_nibble<uint8_t>(instr[1]);
+				return (op <= 0x7 || op == 0xE) ? instruction_kind::regular : instruction_kind::unsupported;
+			}
+
+			case 0xF:
+			{
+				switch (std::to_integer<uint8_t>(instr[1]))
+				{
+					case 0x1E: // ADD I, Vx
+					case 0x29: // LD F, Vx
+						return instruction_kind::regular;
+
+					default:
+						return instruction_kind::unsupported;
+				}
+			}
+
+			default:
+				return instruction_kind::unsupported;
+		}
+	}
+
+	struct block_translator
+	{
+		explicit block_translator(std::vector<instr_t> instrs, uint16_t start_address, const quirks& quirks) :
+			m_instrs{std::move(instrs)},
+			m_start_address{start_address},
+			m_quirks{quirks}
+		{
+			this->m_host_regs.fill(std::nullopt);
+			this->m_is_written.fill(false);
+			this->allocate_registers();
+		}
+
+		[[nodiscard]] std::vector<std::byte> translate()
+		{
+			this->emit_prologue();
+
+			auto address = this->m_start_address;
+			auto is_pc_stored = false;
+			for (const auto& instr : this->m_instrs)
+			{
+				is_pc_stored = this->translate_instruction(instr, address);
+				address += 2;
+			}
+
+			if (!is_pc_stored)
+				this->m_emitter.store_word(regs_ptr, offsetof(registers, pc), address);
+
+			this->emit_epilogue();
+			return this->m_emitter.get_code();
+		}
+
+	private:
+		void allocate_registers()
+		{
+			auto use_count = std::array<size_t, guest_reg_count>{};
+			for (const auto& instr : this->m_instrs)
+			{
+				const auto x = instructions::get_lower_nibble<size_t>(instr[0]);
+				const auto y = instructions::get_upper_nibble<size_t>(instr[1]);
+
+				switch (std::to_integer<uint8_t>(instructions::extract_instruction_class(instr)))
+				{
+					case 0x3: case 0x4: case 0x6: case 0x7:
+						++use_count[x];
+						break;
+
+					case 0x5: case 0x9:
+						++use_count[x];
+						++use_count[y];
+						break;
+
+					case 0x8:
+						++use_count[x];
+						++use_count[y];
+						++use_count[0xF];
+						break;
+
+					case 0xA:
+						++use_count[i_reg_idx];
+						break;
+
+					case 0xB:
+						++use_count[this->m_quirks.is_jump_offset_vx ? x : 0x0];
+						break;
+
+					case 0xF:
+						++use_count[x];
+						++use_count[i_reg_idx];
+						break;
+				}
+			}
+
+			auto order = std::array<size_t, guest_reg_count>{};
+			std::iota(order.begin(), order.end(), size_t{0});
+			std::stable_sort(order.begin(), order.end(), [&use_count](size_t lhs, size_t rhs)
+			{
+				return use_count[lhs] > use_count[rhs];
+			});
+
+			for (size_t idx = 0; idx < allocatable_regs.size(); ++idx)
+			{
+				if (use_count[order[idx]] == 0)
+					break;
+
+				this->m_host_regs[order[idx]] = allocatable_regs[idx];
+			}
+		}
+
+		[[nodiscard]] static constexpr int32_t get_guest_offset(size_t guest_reg) noexcept
+		{
+			return (guest_reg == i_reg_idx) ?
+				int32_t(offsetof(registers, i)) : int32_t(offsetof(registers, v) + guest_reg);
+		}
+
+		void emit_prologue()
+		{
+			for (size_t idx = 0; idx < guest_reg_count; ++idx)
+			{
+				if (!this->m_host_regs[idx])
+					continue;
+
+				const auto host = *this->m_host_regs[idx];
+				if (is_callee_saved(host))
+					this->m_emitter.push(host);
+
+				this->load_from_memory(host, idx);
+			}
+		}
+
+		void emit_epilogue()
+		{
+			for (size_t idx = guest_reg_count; idx-- > 0;)
+			{
+				if (!this->m_host_regs[idx])
+					continue;
+
+				const auto host = *this->m_host_regs[idx];
+				if (this->m_is_written[idx])
+					this->store_to_memory(idx, host);
+
+				if (is_callee_saved(host))
+					this->m_emitter.pop(host);
+			}
+
+			this->m_emitter.ret();
+		}
+
+		void load_from_memory(reg dst, size_t guest_reg)
+		{
+			if (guest_reg == i_reg_idx)
+				this->m_emitter.load_word(dst, regs_ptr, get_guest_offset(guest_reg));
+			else
+				this->m_emitter.load_byte(dst, regs_ptr, get_guest_offset(guest_reg));
+		}
+
+		void store_to_memory(size_t guest_reg, reg src)
+		{
+			if (guest_reg == i_reg_idx)
+				this->m_emitter.store_word(regs_ptr, get_guest_offset(guest_reg), src);
+			else
+				this->m_emitter.store_byte(regs_ptr, get_guest_offset(guest_reg), src);
+		}
+
+		// Loads zero extended guest register into a scratch register
+		void load(reg dst, size_t guest_reg)
+		{
+			if (const auto host = this->m_host_regs[guest_reg])
+				this->m_emitter.mov(dst, *host);
+			else
+				this->load_from_memory(dst, guest_reg);
+		}
+
+		// Stores a scratch register to a guest register, truncating it to the width of guest register
+		void store(size_t guest_reg, reg src)
+		{
+			if (const auto host = this->m_host_regs[guest_reg])
+			{
+				if (guest_reg == i_reg_idx)
+					this->m_emitter.movzx_word(*host, src);
+				else
+					this->m_emitter.movzx_byte(*host, src);
+
+				this->m_is_written[guest_reg] = true;
+			}
+			else
+				this->store_to_memory(guest_reg, src);
+		}
+
+		void emit_skip(condition cc, uint16_t address)
+		{
+			// PC = address + 2 + (condition ? 2 : 0)
+			this->m_emitter.setcc(cc, reg::rdx);
+			this->m_emitter.movzx_byte(reg::rdx, reg::rdx);
+			this->m_emitter.alu(alu_op::add, reg::rdx, reg::rdx);
+			this->m_emitter.alu(alu_op::add, reg::rdx, uint32_t(address) + 2);
+			this->m_emitter.store_word(regs_ptr, offsetof(registers, pc), reg::rdx);
+		}
+
+		// Returns true if instruction stored PC
+		bool translate_instruction(instr_t instr, uint16_t address)
+		{
+			const auto x = instructions::get_lower_nibble<size_t>(instr[0]);
+			const auto y = instructions::get_upper_nibble<size_t>(instr[1]);
+			const auto kk = std::to_integer<uint32_t>(instr[1]);
+			const auto nnn = instructions::detail::get_lower_12_bits<uint16_t>(instr);
+			auto& em = this->m_emitter;
+
+			switch (std::to_integer<uint8_t>(instructions::extract_instruction_class(instr)))
+			{
+				case 0x1: // JP addr
+					em.store_word(regs_ptr, offsetof(registers, pc), nnn);
+					return true;
+
+				case 0x3: // SE Vx, byte
+				case 0x4: // SNE Vx, byte
+					this->load(reg::rax, x);
+					em.alu(alu_op::cmp, reg::rax, kk);
+					this->emit_skip(instructions::extract_instruction_class(instr) == std::byte{0x3} ?
+						condition::e : condition::ne, address);
+					return true;
+
+				case 0x5: // SE Vx, Vy
+				case 0x9: // SNE Vx, Vy
+					this->load(reg::rax, x);
+					this->load(reg::rcx, y);
+					em.alu(alu_op::cmp, reg::rax, reg::rcx);
+					this->emit_skip(instructions::extract_instruction_class(instr) == std::byte{0x5} ?
+						condition::e : condition::ne, address);
+					return true;
+
+				case 0x6: // LD Vx, byte
+					em.mov(reg::rax, kk);
+					this->store(x, reg::rax);
+					return false;
+
+				case 0x7: // ADD Vx, byte
+					this->load(reg::rax, x);
+					em.alu(alu_op::add, reg::rax, kk);
+					this->store(x, reg::rax);
+					return false;
+
+				case 0x8:
+					this->translate_alu(instructions::get_lower_nibble<uint8_t>(instr[1]), x, y);
+					return false;
+
+				case 0xA: // LD I, addr
+					em.mov(reg::rax, uint32_t{nnn});
+					this->store(i_reg_idx, reg::rax);
+					return false;
+
+				case 0xB: // JP V0, addr
+					this->load(reg::rax, this->m_quirks.is_jump_offset_vx ? x : 0x0);
+					em.alu(alu_op::add, reg::rax, uint32_t{nnn});
+					em.alu(alu_op::bit_and, reg::rax, uint32_t{0xFFF});
+					em.store_word(regs_ptr, offsetof(registers, pc), reg::rax);
+					return true;
+
+				case 0xF:
+					this->translate_misc(std::to_integer<uint8_t>(instr[1]), x);
+					return false;
+			}
+
+			return false;
+		}
+
+		// Mirrors the order of register reads and writes in instructions.hpp, so that VF as an operand
+		// behaves the same way
+		void translate_alu(uint8_t op, size_t x, size_t y)
+		{
+			auto& em = this->m_emitter;
+
+			switch (op)
+			{
+				case 0x0: // LD Vx, Vy
+					this->load(reg::rax, y);
+					this->store(x, reg::rax);
+					break;
+
+				case 0x1: // OR Vx, Vy
+				case 0x2: // AND Vx, Vy
+				case 0x3: // XOR Vx, Vy
+				{
+					static constexpr auto ops = std::array{alu_op::bit_or, alu_op::bit_and, alu_op::bit_xor};
+					this->load(reg::rax, x);
+					this->load(reg::rcx, y);
+					em.alu(ops[op - 1], reg::rax, reg::rcx);
+					this->store(x, reg::rax);
+					break;
+				}
+
+				case 0x4: // ADD Vx, Vy
+					this->load(reg::rax, x);
+					this->load(reg::rcx, y);
+					em.alu(alu_op::add, reg::rax, reg::rcx);
+					this->store(x, reg::rax);
+					em.shift(shift_op::shr, reg::rax, 8);
+					this->store(0xF, reg::rax);
+					break;
+
+				case 0x5: // SUB Vx, Vy
+				case 0x7: // SUBN Vx, Vy
+				{
+					const auto lhs = (op == 0x5) ? x : y;
+					const auto rhs = (op == 0x5) ? y : x;
+
+					this->load(reg::rax, lhs);
+					this->load(reg::rcx, rhs);
+					em.alu(alu_op::cmp, reg::rax, reg::rcx);
+					em.setcc(condition::a, reg::rdx);
+					this->store(0xF, reg::rdx);
+
+					this->load(reg::rax, lhs);
+					this->load(reg::rcx, rhs);
+					em.alu(alu_op::sub, reg::rax, reg::rcx);
+					this->store(x, reg::rax);
+					break;
+				}
+
+				case 0x6: // SHR Vx, Vy
+					this->translate_shift_source(x, y);
+					this->load(reg::rax, x);
+					em.alu(alu_op::bit_and, reg::rax, uint32_t{0x01});
+					this->store(0xF, reg::rax);
+					this->load(reg::rax, x);
+					em.shift(shift_op::shr, reg::rax, 1);
+					this->store(x, reg::rax);
+					break;
+
+				case 0xE: // SHL Vx, Vy
+					this->translate_shift_source(x, y);
+					this->load(reg::rax, x);
+					em.shift(shift_op::shr, reg::rax, 7);
+					this->store(0xF, reg::rax);
+					this->load(reg::rax, x);
+					em.shift(shift_op::shl, reg::rax, 1);
+					this->store(x, reg::rax);
+					break;
+			}
+		}
+
+		// Profiles shifting Vy copy it into Vx first, like opcode handlers do
+		void translate_shift_source(size_t x, size_t y)
+		{
+			if (!this->m_quirks.is_shift_from_vy)
+				return;
+
+			this->load(reg::rax, y);
+			this->store(x, reg::rax);
+		}
+
+		void translate_misc(uint8_t op, size_t x)
+		{
+			auto& em = this->m_emitter;
+
+			switch (op)
+			{
+				case 0x1E: // ADD I, Vx
+					this->load(reg::rax, i_reg_idx);
+					this->load(reg::rcx, x);
+					em.alu(alu_op::add, reg::rax, reg::rcx);
+					this->store(i_reg_idx, reg::rax);
+					break;
+
+				case 0x29: // LD F, Vx
+					this->load(reg::rax, x);
+					em.imul(reg::rax, reg::rax, int8_t(font::c_bytes_per_symbol));
+					if constexpr (font::c_font_offset != 0)
+						em.alu(alu_op::add, reg::rax, uint32_t(font::c_font_offset));
+					this->store(i_reg_idx, reg::rax);
+					break;
+			}
+		}
+
+		const std::vector<instr_t> m_instrs;
+		const uint16_t m_start_address;
+		const quirks m_quirks;
+
+		emitter m_emitter;
+		std::array<std::optional<reg>, guest_reg_count> m_host_regs;
+		std::array<bool, guest_reg_count> m_is_written;
+	};
+}
+
+translated_block jit::translate_block(const memory_t& mem, uint16_t start_address, const quirks& quirks)
+{
+	auto instrs = std::vector<instr_t>{};
+	auto address = start_address;
+
+	while (instrs.size() < max_block_instructions && size_t{address} + 1 < constants::mem_size)
+	{
+		const auto instr = instructions::fetch(mem, address);
+		const auto kind = classify(instr, address);
+		if (kind == instruction_kind::unsupported)
+			break;
+
+		instrs.push_back(instr);
+		address += 2;
+
+		if (kind == instruction_kind::terminator)
+			break;
+	}
+
+	if (instrs.empty())
+		return translated_block{{}, start_address, start_address, 0};
+
+	const auto instruction_count = uint16_t(instrs.size());
+	return translated_block{block_translator(std::move(instrs), start_address, quirks).translate(),
+		start_address, address, instruction_count};
+}
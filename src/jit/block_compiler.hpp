@@ -0,0 +1,37 @@
+#ifndef BLOCK_COMPILER_HPP
+#define BLOCK_COMPILER_HPP
+
+#include "quirks.hpp"
+#include "registers.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chip8::jit
+{
+	using block_function = void (*)(registers*);
+
+	struct translated_block
+	{
+		std::vector<std::byte> code;
+		uint16_t start_address;
+		uint16_t end_address;
+		uint16_t instruction_count;
+	};
+
+	static constexpr auto max_block_instructions = uint16_t{64};
+
+	/*	Translates the basic block starting at start_address into x86-64 code callable as block_function.
+	 *	A block ends after JP, SE/SNE or JP V0 and before any instruction which has to go through the
+	 *	interpreter (CALL, RET, LD Vx, K, display, keyboard, timer and memory instructions, jumps to
+	 *	themselves which the interpreter detects as idle loops).
+	 *	Shifts and JP V0 are translated with the behaviour of given quirks.
+	 *	If the very first instruction can't be translated, the returned block contains no instructions.
+	 */
+	[[nodiscard]] translated_block translate_block(const memory_t& mem, uint16_t start_address,
+		const quirks& quirks = modern_quirks);
+}
+
+#endif /* BLOCK_COMPILER_HPP */
@@ -0,0 +1,94 @@
+#include "jit/engine.hpp"
+
+#include "block_invalidation.hpp"
+
+#include <SDL_log.h>
+
+#include <algorithm>
+
+using namespace chip8;
+using namespace chip8::jit;
+
+engine::engine(const memory_t& mem) :
+	m_mem{mem},
+	m_quirks{modern_quirks},
+	m_code{code_buffer_size}
+{
+	this->invalidate_all();
+}
+
+size_t engine::execute(registers& regs, size_t tick_budget)
+{
+	if (regs.pc >= this->m_blocks.size())
+		return 0;
+
+	const auto* entry = &this->m_blocks[regs.pc];
+	if (!entry->is_valid)
+		entry = &this->translate(regs.pc);
+
+	if (entry->instruction_count == 0 || entry->instruction_count > tick_budget)
+		return 0;
+
+	entry->code(&regs);
+	return entry->instruction_count;
+}
+
+void engine::invalidate(uint16_t address, size_t byte_count) noexcept
+{
+	const auto range = find_overlapping_block_starts(this->m_translated_bytes, address, byte_count,
+		max_block_instructions);
+
+	for (auto idx = range.first; idx < range.last; ++idx)
+	{
+		auto& entry = this->m_blocks[idx];
+		if (entry.is_valid && entry.end_address > address)
+			entry.is_valid = false;
+	}
+}
+
+void engine::invalidate_all() noexcept
+{
+	this->m_blocks.fill(block{nullptr, 0, 0, false});
+	this->m_translated_bytes.reset();
+	this->m_code.reset();
+}
+
+void engine::set_quirks(const quirks& quirks) noexcept
+{
+	this->m_quirks = quirks;
+	this->invalidate_all();
+}
+
+const engine::block& engine::translate(uint16_t address)
+{
+	const auto translated = translate_block(this->m_mem, address, this->m_quirks);
+	auto& entry = this->m_blocks[address];
+
+	if (translated.instruction_count == 0)
+	{
+		// Marker covers the instruction it refused, so code stored over it later gets translated
+		const auto end_address = uint16_t(std::min(size_t{address} + 2, constants::mem_size));
+		this->mark_translated(address, end_address);
+		entry = block{nullptr, end_address, 0, true};
+		return entry;
+	}
+
+	auto* code = this->m_code.append(translated.code);
+	if (!code)
+	{
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "JIT code buffer is full, flushing all translated blocks");
+		this->invalidate_all();
+		code = this->m_code.append(translated.code);
+	}
+
+	this->mark_translated(translated.start_address, translated.end_address);
+	entry = block{reinterpret_cast<block_function>(code), translated.end_address,
+		translated.instruction_count, true};
+	return entry;
+}
+
+void engine::mark_translated(uint16_t start_address, uint16_t end_address) noexcept
+{
+	for (auto idx = size_t{start_address}; idx < end_address; ++idx)
+		this->m_translated_bytes[idx] = true;
+}
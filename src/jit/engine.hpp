@@ -0,0 +1,59 @@
+#ifndef JIT_ENGINE_HPP
+#define JIT_ENGINE_HPP
+
+#include "jit/block_compiler.hpp"
+#include "jit/executable_memory.hpp"
+#include "registers.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8::jit
+{
+	/*	Executes guest code as translated basic blocks.
+	 *	Blocks are translated on first execution and kept until memory they were translated from is
+	 *	written to. Instructions that can't be translated are left for the interpreter.
+	 */
+	struct engine
+	{
+		explicit engine(const memory_t& mem);
+
+		// Executes a single block at current PC. Returns number of executed instructions, zero means that
+		// the instruction at PC has to be executed by the interpreter, which is also the case for blocks
+		// longer than tick_budget
+		[[nodiscard]] size_t execute(registers& regs, size_t tick_budget);
+
+		void invalidate(uint16_t address, size_t byte_count) noexcept;
+		void invalidate_all() noexcept;
+
+		// Blocks translated so far are dropped, as they follow previous quirks
+		void set_quirks(const quirks& quirks) noexcept;
+
+	private:
+		struct block
+		{
+			block_function code;
+			uint16_t end_address;
+			uint16_t instruction_count;
+			bool is_valid;
+		};
+
+		[[nodiscard]] const block& translate(uint16_t address);
+		void mark_translated(uint16_t start_address, uint16_t end_address) noexcept;
+
+		static constexpr auto code_buffer_size = size_t{1024 * 1024};
+
+		const memory_t& m_mem;
+		quirks m_quirks;
+		executable_memory m_code;
+		std::array<block, constants::mem_size> m_blocks;
+
+		// Bytes covered by blocks and by markers of instructions left for the interpreter
+		std::bitset<constants::mem_size> m_translated_bytes;
+	};
+}
+
+#endif /* JIT_ENGINE_HPP */
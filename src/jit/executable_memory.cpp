@@ -0,0 +1,60 @@
+#include "jit/executable_memory.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+using namespace chip8::jit;
+using namespace std::literals::string_literals;
+
+executable_memory::executable_memory(size_t size) :
+	m_size{size},
+	m_page_size{size_t(sysconf(_SC_PAGESIZE))},
+	m_used{0}
+{
+	auto* memory = mmap(nullptr, this->m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED)
+		throw std::system_error(errno, std::system_category(), "Unable to allocate JIT code buffer"s);
+
+	this->m_memory = static_cast<std::byte*>(memory);
+}
+
+executable_memory::~executable_memory()
+{
+	munmap(this->m_memory, this->m_size);
+}
+
+const void* executable_memory::append(std::span<const std::byte> code)
+{
+	if (this->m_size - this->m_used < code.size())
+		return nullptr;
+
+	// Only pages the code lands on change protection, blocks are small so that is usually a single page
+	const auto first_page = this->m_used / this->m_page_size * this->m_page_size;
+	const auto end_page = (this->m_used + code.size() + this->m_page_size - 1) / this->m_page_size *
+		this->m_page_size;
+	const auto pages = std::span(this->m_memory + first_page, end_page - first_page);
+
+	set_writable(pages, true);
+	auto* out = this->m_memory + this->m_used;
+	std::memcpy(out, code.data(), code.size());
+	this->m_used += code.size();
+	set_writable(pages, false);
+
+	return out;
+}
+
+void executable_memory::reset()
+{
+	this->m_used = 0;
+}
+
+void executable_memory::set_writable(std::span<std::byte> pages, bool is_writable)
+{
+	const auto protection = is_writable ? (PROT_READ | PROT_WRITE) : (PROT_READ | PROT_EXEC);
+	if (mprotect(pages.data(), pages.size(), protection) != 0)
+		throw std::system_error(errno, std::system_category(), "Unable to change JIT code buffer protection"s);
+}
@@ -0,0 +1,38 @@
+#ifndef EXECUTABLE_MEMORY_HPP
+#define EXECUTABLE_MEMORY_HPP
+
+#include <cstddef>
+#include <span>
+
+namespace chip8::jit
+{
+	/*	Page aligned memory region for generated code.
+	 *	Code is appended while the region is writable and the region is made executable afterwards,
+	 *	so that memory is never writable and executable at the same time.
+	 */
+	struct executable_memory
+	{
+		explicit executable_memory(size_t size);
+		~executable_memory();
+
+		executable_memory(const executable_memory&) = delete;
+		executable_memory& operator=(const executable_memory&) = delete;
+
+		executable_memory(executable_memory&&) = delete;
+		executable_memory& operator=(executable_memory&&) = delete;
+
+		// Returns nullptr if there is not enough space left
+		[[nodiscard]] const void* append(std::span<const std::byte> code);
+		void reset();
+
+	private:
+		static void set_writable(std::span<std::byte> pages, bool is_writable);
+
+		std::byte* m_memory;
+		const size_t m_size;
+		const size_t m_page_size;
+		size_t m_used;
+	};
+}
+
+#endif /* EXECUTABLE_MEMORY_HPP */
@@ -0,0 +1,198 @@
+#include "jit/x86_64_emitter.hpp"
+
+using namespace chip8::jit::x86_64;
+
+namespace
+{
+	[[nodiscard]] constexpr uint8_t low_bits(reg r) noexcept
+	{
+		return static_cast<uint8_t>(r) & 0x07;
+	}
+
+	[[nodiscard]] constexpr bool is_extended(reg r) noexcept
+	{
+		return static_cast<uint8_t>(r) >= 8;
+	}
+
+	// Without REX prefix, byte register encodings 4-7 select ah, ch, dh and bh instead of spl, bpl, sil and dil
+	[[nodiscard]] constexpr bool needs_rex_for_byte(reg r) noexcept
+	{
+		return r == reg::rsp || r == reg::rbp || r == reg::rsi || r == reg::rdi;
+	}
+}
+
+void emitter::mov(reg dst, reg src)
+{
+	this->emit_rex(src, dst);
+	this->emit(0x89);
+	this->emit_modrm(src, dst);
+}
+
+void emitter::mov(reg dst, uint32_t imm)
+{
+	this->emit_rex(reg::rax, dst);
+	this->emit(0xB8 + low_bits(dst));
+	this->emit_imm32(imm);
+}
+
+void emitter::movzx_byte(reg dst, reg src)
+{
+	this->emit_rex(dst, src, needs_rex_for_byte(src));
+	this->emit(0x0F);
+	this->emit(0xB6);
+	this->emit_modrm(dst, src);
+}
+
+void emitter::movzx_word(reg dst, reg src)
+{
+	this->emit_rex(dst, src);
+	this->emit(0x0F);
+	this->emit(0xB7);
+	this->emit_modrm(dst, src);
+}
+
+void emitter::load_byte(reg dst, reg base, int32_t disp)
+{
+	this->emit_rex(dst, base);
+	this->emit(0x0F);
+	this->emit(0xB6);
+	this->emit_modrm(dst, base, disp);
+}
+
+void emitter::load_word(reg dst, reg base, int32_t disp)
+{
+	this->emit_rex(dst, base);
+	this->emit(0x0F);
+	this->emit(0xB7);
+	this->emit_modrm(dst, base, disp);
+}
+
+void emitter::store_byte(reg base, int32_t disp, reg src)
+{
+	this->emit_rex(src, base, needs_rex_for_byte(src));
+	this->emit(0x88);
+	this->emit_modrm(src, base, disp);
+}
+
+void emitter::store_word(reg base, int32_t disp, reg src)
+{
+	this->emit(0x66);
+	this->emit_rex(src, base);
+	this->emit(0x89);
+	this->emit_modrm(src, base, disp);
+}
+
+void emitter::store_word(reg base, int32_t disp, uint16_t imm)
+{
+	this->emit(0x66);
+	this->emit_rex(reg::rax, base);
+	this->emit(0xC7);
+	this->emit_modrm(reg::rax, base, disp);
+	this->emit_imm16(imm);
+}
+
+void emitter::alu(alu_op op, reg dst, reg src)
+{
+	this->emit_rex(src, dst);
+	this->emit(static_cast<uint8_t>(op) << 3 | 0x01);
+	this->emit_modrm(src, dst);
+}
+
+void emitter::alu(alu_op op, reg dst, uint32_t imm)
+{
+	this->emit_rex(reg::rax, dst);
+	this->emit(0x81);
+	this->emit_modrm(static_cast<reg>(op), dst);
+	this->emit_imm32(imm);
+}
+
+void emitter::shift(shift_op op, reg dst, uint8_t amount)
+{
+	this->emit_rex(reg::rax, dst);
+	this->emit(0xC1);
+	this->emit_modrm(static_cast<reg>(op), dst);
+	this->emit(amount);
+}
+
+void emitter::setcc(condition cc, reg dst)
+{
+	this->emit_rex(reg::rax, dst, needs_rex_for_byte(dst));
+	this->emit(0x0F);
+	this->emit(0x90 + static_cast<uint8_t>(cc));
+	this->emit_modrm(reg::rax, dst);
+}
+
+void emitter::imul(reg dst, reg src, int8_t imm)
+{
+	this->emit_rex(dst, src);
+	this->emit(0x6B);
+	this->emit_modrm(dst, src);
+	this->emit(static_cast<uint8_t>(imm));
+}
+
+void emitter::push(reg r)
+{
+	this->emit_rex(reg::rax, r);
+	this->emit(0x50 + low_bits(r));
+}
+
+void emitter::pop(reg r)
+{
+	this->emit_rex(reg::rax, r);
+	this->emit(0x58 + low_bits(r));
+}
+
+void emitter::ret()
+{
+	this->emit(0xC3);
+}
+
+const std::vector<std::byte>& emitter::get_code() const noexcept
+{
+	return this->m_code;
+}
+
+void emitter::emit(uint8_t byte)
+{
+	this->m_code.push_back(std::byte{byte});
+}
+
+void emitter::emit_imm16(uint16_t imm)
+{
+	this->emit(imm & 0xFF);
+	this->emit(imm >> 8);
+}
+
+void emitter::emit_imm32(uint32_t imm)
+{
+	for (int cnt = 0; cnt < 4; ++cnt)
+		this->emit((imm >> (cnt * 8)) & 0xFF);
+}
+
+void emitter::emit_rex(reg r, reg b, bool force_byte_regs)
+{
+	const auto rex = uint8_t(0x40 | (is_extended(r) ? 0x04 : 0x00) | (is_extended(b) ? 0x01 : 0x00));
+	if (rex != 0x40 || force_byte_regs)
+		this->emit(rex);
+}
+
+void emitter::emit_modrm(reg r, reg rm)
+{
+	this->emit(0xC0 | low_bits(r) << 3 | low_bits(rm));
+}
+
+void emitter::emit_modrm(reg r, reg base, int32_t disp)
+{
+	// rbp/r13 as base always need a displacement, rsp/r12 as base always need a SIB byte
+	const auto is_disp8 = disp >= -128 && disp <= 127;
+	const auto mod = (disp == 0 && low_bits(base) != 0x05) ? 0x00 : (is_disp8 ? 0x40 : 0x80);
+
+	this->emit(mod | low_bits(r) << 3 | low_bits(base));
+	if (low_bits(base) == 0x04)
+		this->emit(0x24);
+
+	if (mod == 0x40)
+		this->emit(static_cast<uint8_t>(disp));
+	else if (mod == 0x80)
+		this->emit_imm32(static_cast<uint32_t>(disp));
+}
@@ -0,0 +1,79 @@
+#ifndef X86_64_EMITTER_HPP
+#define X86_64_EMITTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chip8::jit::x86_64
+{
+	enum class reg : uint8_t
+	{
+		rax, rcx, rdx, rbx, rsp, rbp, rsi, rdi,
+		r8, r9, r10, r11, r12, r13, r14, r15
+	};
+
+	enum class condition : uint8_t
+	{
+		b = 0x2,
+		e = 0x4,
+		ne = 0x5,
+		a = 0x7
+	};
+
+	// Values are the /digit opcode extensions of the 0x81 group
+	enum class alu_op : uint8_t
+	{
+		add = 0,
+		bit_or = 1,
+		bit_and = 4,
+		sub = 5,
+		bit_xor = 6,
+		cmp = 7
+	};
+
+	// Values are the /digit opcode extensions of the 0xC1 group
+	enum class shift_op : uint8_t
+	{
+		shl = 4,
+		shr = 5
+	};
+
+	// Emits the small subset of x86-64 needed by the block compiler. All register operations are 32 bit
+	struct emitter
+	{
+		void mov(reg dst, reg src);
+		void mov(reg dst, uint32_t imm);
+		void movzx_byte(reg dst, reg src);
+		void movzx_word(reg dst, reg src);
+		void load_byte(reg dst, reg base, int32_t disp);
+		void load_word(reg dst, reg base, int32_t disp);
+		void store_byte(reg base, int32_t disp, reg src);
+		void store_word(reg base, int32_t disp, reg src);
+		void store_word(reg base, int32_t disp, uint16_t imm);
+
+		void alu(alu_op op, reg dst, reg src);
+		void alu(alu_op op, reg dst, uint32_t imm);
+		void shift(shift_op op, reg dst, uint8_t amount);
+		void setcc(condition cc, reg dst);
+		void imul(reg dst, reg src, int8_t imm);
+
+		void push(reg r);
+		void pop(reg r);
+		void ret();
+
+		[[nodiscard]] const std::vector<std::byte>& get_code() const noexcept;
+
+	private:
+		void emit(uint8_t byte);
+		void emit_imm16(uint16_t imm);
+		void emit_imm32(uint32_t imm);
+		void emit_rex(reg r, reg b, bool force_byte_regs = false);
+		void emit_modrm(reg r, reg rm);
+		void emit_modrm(reg r, reg base, int32_t disp);
+
+		std::vector<std::byte> m_code;
+	};
+}
+
+#endif /* X86_64_EMITTER_HPP */
@@ -0,0 +1,565 @@
+#include "lockstep/engine.hpp"
+#include "lockstep/simd_bytes.hpp"
+
+#include "chip8_font.hpp"
+#include "framebuffer.hpp"
+#include "instructions.hpp"
+#include "opcode_handlers.hpp"
+#include "random_generator.hpp"
+#include "io/rom.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+using namespace chip8;
+using namespace chip8::lockstep;
+
+namespace
+{
+	// Rows are padded to SIMD width, padding bytes are never selected by group mask
+	template <size_t lane_count>
+	using byte_row = std::array<uint8_t, std::max(lane_count, simd_bytes::width)>;
+
+	template <typename row_type>
+	[[nodiscard]] inline simd_bytes load(const row_type& row, size_t offset) noexcept
+	{
+		return simd_bytes::load(row.data() + offset);
+	}
+
+	// Replaces bytes of lanes selected by mask with kernel results
+	template <typename row_type, typename kernel_type>
+	inline void masked_update(const row_type& mask, row_type& row, kernel_type&& kernel) noexcept
+	{
+		for (auto offset = size_t{0}; offset < row.size(); offset += simd_bytes::width)
+		{
+			const auto result = kernel(offset);
+			simd_bytes::select(load(mask, offset), result, load(row, offset)).store(row.data() + offset);
+		}
+	}
+
+	template <typename function_type>
+	inline void for_each_lane(uint32_t mask, function_type&& function)
+	{
+		while (mask != 0)
+		{
+			function(size_t(std::countr_zero(mask)));
+			mask &= mask - 1;
+		}
+	}
+
+	[[nodiscard]] constexpr instr_t to_instruction(uint16_t raw_opcode) noexcept
+	{
+		return instr_t{std::byte(raw_opcode >> 8), std::byte(raw_opcode & 0xFF)};
+	}
+
+	inline void check_lane(size_t lane, size_t lane_count)
+	{
+		if (lane >= lane_count)
+			throw std::out_of_range("Lane index out of range");
+	}
+}
+
+template <size_t lane_count>
+struct engine<lane_count>::state
+{
+	alignas(64) std::array<byte_row<lane_count>, constants::v_reg_count> v;
+	alignas(64) byte_row<lane_count> delay;
+	alignas(64) byte_row<lane_count> sound;
+
+	// Scratch rows for SIMD kernels
+	alignas(64) byte_row<lane_count> group_mask;
+	alignas(64) byte_row<lane_count> condition;
+
+	std::array<uint16_t, lane_count> pc;
+	std::array<uint16_t, lane_count> i;
+	std::array<int8_t, lane_count> sp;
+	std::array<std::array<uint16_t, lane_count>, constants::stack_size> stack;
+	std::array<std::array<std::byte, lane_count>, constants::mem_size> mem;
+	std::array<framebuffer_t, lane_count> video;
+	std::array<keyboard_state, lane_count> keys;
+	std::array<random_generator, lane_count> random;
+	std::array<fault_status, lane_count> faults;
+
+	// Opcode fetched by every lane in current step
+	std::array<uint16_t, lane_count> fetched;
+};
+
+template <size_t lane_count>
+engine<lane_count>::engine(const std::filesystem::path& rom_path, size_t steps_per_timer_tick) :
+	m_state{std::make_unique<state>()},
+	m_steps_per_timer_tick{steps_per_timer_tick},
+	m_steps_until_timer_tick{steps_per_timer_tick},
+	m_vector_lane_steps{0},
+	m_scalar_lane_steps{0},
+	m_faulted_lanes{0}
+{
+	auto initial_memory = memory_t{};
+	std::copy_n(chip8::font::raw_data.begin(), chip8::font::raw_data.size(), initial_memory.begin());
+	chip8::load_rom_from_file(rom_path, initial_memory);
+
+	auto& s = *this->m_state;
+	for (auto address = size_t{0}; address < constants::mem_size; ++address)
+		s.mem[address].fill(initial_memory[address]);
+
+	s.pc.fill(constants::code_start);
+	s.sp.fill(-1);
+	s.faults.fill(fault_status{fault::none, 0, instr_t{}});
+	for (auto lane = size_t{0}; lane < lane_count; ++lane)
+		s.random[lane].seed(lane);
+}
+
+template <size_t lane_count>
+engine<lane_count>::~engine() = default;
+
+template <size_t lane_count>
+void engine<lane_count>::set_keyboard_state(size_t lane, keyboard_state keys)
+{
+	check_lane(lane, lane_count);
+	this->m_state->keys[lane] = keys;
+}
+
+template <size_t lane_count>
+void engine<lane_count>::set_seed(size_t lane, uint64_t seed)
+{
+	check_lane(lane, lane_count);
+	this->m_state->random[lane].seed(seed);
+}
+
+template <size_t lane_count>
+void engine<lane_count>::step()
+{
+	auto& s = *this->m_state;
+
+	// Halted lanes don't fetch anything
+	for_each_lane(lane_mask((uint64_t{1} << lane_count) - 1) & ~this->m_faulted_lanes, [&](size_t lane)
+	{
+		const auto pc = size_t{s.pc[lane]};
+		if (pc + 2 > constants::mem_size)
+		{
+			this->raise_fault(lane, fault::pc_out_of_range, instr_t{});
+			return;
+		}
+
+		s.fetched[lane] = uint16_t(std::to_integer<uint16_t>(s.mem[pc][lane]) << 8 |
+			std::to_integer<uint16_t>(s.mem[pc + 1][lane]));
+	});
+
+	// Lanes are grouped by opcode only, as no kernel depends on PC
+	auto pending = lane_mask((uint64_t{1} << lane_count) - 1) & ~this->m_faulted_lanes;
+	while (pending != 0)
+	{
+		const auto raw_opcode = s.fetched[std::countr_zero(pending)];
+		auto group = lane_mask{0};
+		for_each_lane(pending, [&](size_t lane)
+		{
+			if (s.fetched[lane] == raw_opcode)
+				group |= lane_mask{1} << lane;
+		});
+
+		pending &= ~group;
+		this->execute_group(group, raw_opcode);
+	}
+
+	this->update_timers();
+}
+
+template <size_t lane_count>
+void engine<lane_count>::run(size_t step_count)
+{
+	for (auto idx = size_t{0}; idx < step_count; ++idx)
+		this->step();
+}
+
+template <size_t lane_count>
+registers engine<lane_count>::get_registers(size_t lane) const
+{
+	check_lane(lane, lane_count);
+
+	const auto& s = *this->m_state;
+	auto regs = registers{s.pc[lane]};
+	for (auto idx = size_t{0}; idx < constants::v_reg_count; ++idx)
+		regs.v[idx] = std::byte{s.v[idx][lane]};
+
+	regs.i = s.i[lane];
+	regs.sp = s.sp[lane];
+	regs.delay = s.delay[lane];
+	regs.sound = s.sound[lane];
+	return regs;
+}
+
+template <size_t lane_count>
+std::byte engine<lane_count>::read_memory(size_t lane, uint16_t address) const
+{
+	check_lane(lane, lane_count);
+	if (address >= constants::mem_size)
+		throw std::out_of_range("Memory address out of range");
+
+	return this->m_state->mem[address][lane];
+}
+
+template <size_t lane_count>
+bool engine<lane_count>::get_pixel(size_t lane, size_t x, size_t y) const
+{
+	check_lane(lane, lane_count);
+	if (x >= constants::ch8_width || y >= constants::ch8_height)
+		throw std::out_of_range("Pixel coordinates out of range");
+
+	return framebuffer::get_pixel(this->m_state->video[lane], x, y);
+}
+
+template <size_t lane_count>
+const fault_status& engine<lane_count>::get_fault(size_t lane) const
+{
+	check_lane(lane, lane_count);
+	return this->m_state->faults[lane];
+}
+
+template <size_t lane_count>
+size_t engine<lane_count>::get_faulted_lane_count() const noexcept
+{
+	return size_t(std::popcount(this->m_faulted_lanes));
+}
+
+template <size_t lane_count>
+size_t engine<lane_count>::get_vector_lane_steps() const noexcept
+{
+	return this->m_vector_lane_steps;
+}
+
+template <size_t lane_count>
+size_t engine<lane_count>::get_scalar_lane_steps() const noexcept
+{
+	return this->m_scalar_lane_steps;
+}
+
+template <size_t lane_count>
+void engine<lane_count>::execute_group(lane_mask group, uint16_t raw_opcode)
+{
+	const auto group_size = size_t(std::popcount(group));
+	if (group_size > 1 && this->execute_vector(group, raw_opcode))
+	{
+		this->m_vector_lane_steps += group_size;
+		return;
+	}
+
+	for_each_lane(group, [&](size_t lane)
+	{
+		this->execute_scalar(lane, raw_opcode);
+	});
+	this->m_scalar_lane_steps += size_t(std::popcount(group & ~this->m_faulted_lanes));
+}
+
+template <size_t lane_count>
+bool engine<lane_count>::execute_vector(lane_mask group, uint16_t raw_opcode)
+{
+	const auto instr = opcode_handlers::decode(to_instruction(raw_opcode));
+	auto& s = *this->m_state;
+	auto& vx = s.v[instr.x];
+	auto& vy = s.v[instr.y];
+	auto& vf = s.v[0xF];
+	const auto& mask = s.group_mask;
+	const auto kk = simd_bytes::broadcast(std::to_integer<uint8_t>(instr.kk));
+	const auto one = simd_bytes::broadcast(0x01);
+
+	// Skips only compute a condition, PC is advanced per lane below
+	auto is_skip = false;
+
+	for (auto lane = size_t{0}; lane < s.group_mask.size(); ++lane)
+		s.group_mask[lane] = ((uint64_t{group} >> lane) & 1) ? 0xFF : 0x00;
+
+	// Instructions setting VF write it in the same order as their scalar counterparts, so results
+	// are the same when x or y is 0xF
+	switch (instr.op)
+	{
+		case opcode::se_reg_byte:
+		case opcode::sne_reg_byte:
+		case opcode::se_reg_reg:
+		case opcode::sne_reg_reg:
+		{
+			const auto is_equality = (instr.op == opcode::se_reg_byte || instr.op == opcode::se_reg_reg);
+			const auto is_reg_reg = (instr.op == opcode::se_reg_reg || instr.op == opcode::sne_reg_reg);
+			for (auto offset = size_t{0}; offset < s.condition.size(); offset += simd_bytes::width)
+			{
+				const auto equal = simd_bytes::equal(load(vx, offset), is_reg_reg ? load(vy, offset) : kk);
+				(is_equality ? equal : ~equal).store(s.condition.data() + offset);
+			}
+			is_skip = true;
+			break;
+		}
+
+		case opcode::ld_reg_byte:
+			masked_update(mask, vx, [&](size_t) { return kk; });
+			break;
+
+		case opcode::add_reg_byte:
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset) + kk; });
+			break;
+
+		case opcode::ld_reg_reg:
+			masked_update(mask, vx, [&](size_t offset) { return load(vy, offset); });
+			break;
+
+		case opcode::or_reg_reg:
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset) | load(vy, offset); });
+			break;
+
+		case opcode::and_reg_reg:
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset) & load(vy, offset); });
+			break;
+
+		case opcode::xor_reg_reg:
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset) ^ load(vy, offset); });
+			break;
+
+		case opcode::add_reg_reg:
+			// Carry has to be computed before Vx is overwritten
+			for (auto offset = size_t{0}; offset < s.condition.size(); offset += simd_bytes::width)
+				(simd_bytes::add_carry(load(vx, offset), load(vy, offset)) & one).store(s.condition.data() + offset);
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset) + load(vy, offset); });
+			masked_update(mask, vf, [&](size_t offset) { return load(s.condition, offset); });
+			break;
+
+		case opcode::sub_reg_reg:
+			masked_update(mask, vf, [&](size_t offset)
+			{
+				return simd_bytes::greater(load(vx, offset), load(vy, offset)) & one;
+			});
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset) - load(vy, offset); });
+			break;
+
+		case opcode::subn_reg_reg:
+			masked_update(mask, vf, [&](size_t offset)
+			{
+				return simd_bytes::greater(load(vy, offset), load(vx, offset)) & one;
+			});
+			masked_update(mask, vx, [&](size_t offset) { return load(vy, offset) - load(vx, offset); });
+			break;
+
+		case opcode::shr_reg_reg:
+			masked_update(mask, vf, [&](size_t offset) { return load(vx, offset) & one; });
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset).shift_right_1(); });
+			break;
+
+		case opcode::shl_reg_reg:
+			masked_update(mask, vf, [&](size_t offset)
+			{
+				return simd_bytes::greater(load(vx, offset), simd_bytes::broadcast(0x7F)) & one;
+			});
+			masked_update(mask, vx, [&](size_t offset) { return load(vx, offset).shift_left_1(); });
+			break;
+
+		case opcode::ld_reg_dt:
+			masked_update(mask, vx, [&](size_t offset) { return load(s.delay, offset); });
+			break;
+
+		case opcode::ld_dt_reg:
+			masked_update(mask, s.delay, [&](size_t offset) { return load(vx, offset); });
+			break;
+
+		case opcode::ld_st_reg:
+			masked_update(mask, s.sound, [&](size_t offset) { return load(vx, offset); });
+			break;
+
+		default:
+			return false;
+	}
+
+	if (is_skip)
+	{
+		for_each_lane(group, [&](size_t lane)
+		{
+			s.pc[lane] += (s.condition[lane] != 0) ? 4 : 2;
+		});
+	}
+	else
+		this->advance_pc(group);
+
+	return true;
+}
+
+template <size_t lane_count>
+void engine<lane_count>::execute_scalar(size_t lane, uint16_t raw_opcode)
+{
+	auto& s = *this->m_state;
+	const auto instr = to_instruction(raw_opcode);
+	const auto decoded = opcode_handlers::decode(instr);
+	auto regs = this->get_registers(lane);
+	auto is_pc_advanced = true;
+
+	// Faulting instruction returns before registers are written back, so the lane halts right before it
+	const auto halt = [&](fault kind) { this->raise_fault(lane, kind, instr); };
+
+	switch (decoded.op)
+	{
+		case opcode::cls:
+			s.video[lane].fill(0);
+			break;
+
+		case opcode::ret:
+			if (regs.sp < 0)
+				return halt(fault::stack_underflow);
+			regs.pc = s.stack[regs.sp][lane];
+			--regs.sp;
+			break;
+
+		case opcode::jp:
+			instructions::jp(regs, decoded.nnn);
+			is_pc_advanced = false;
+			break;
+
+		case opcode::call:
+			if (regs.sp + 1 >= int(constants::stack_size))
+				return halt(fault::stack_overflow);
+			++regs.sp;
+			s.stack[regs.sp][lane] = regs.pc;
+			regs.pc = decoded.nnn;
+			is_pc_advanced = false;
+			break;
+
+		case opcode::jp_v0_addr:
+			instructions::jp_v0_addr(regs, decoded.nnn);
+			is_pc_advanced = false;
+			break;
+
+		case opcode::rnd_reg_byte:
+			instructions::rnd_reg_byte(regs, s.random[lane], decoded.x, decoded.kk);
+			break;
+
+		case opcode::drw:
+		{
+			// Same as interpreter, but reading sprites from memory of a single lane
+			regs.v[0xF] = std::byte{0x00};
+			const auto x_offset = std::to_integer<uint8_t>(regs.v[decoded.x]) % constants::ch8_width;
+			const auto y_offset = std::to_integer<uint8_t>(regs.v[decoded.y]) % constants::ch8_height;
+			if (size_t{regs.i} + decoded.n > constants::mem_size)
+				return halt(fault::memory_access);
+
+			for (auto line = size_t{0}; line < decoded.n; ++line)
+			{
+				auto& row = s.video[lane][(y_offset + line) % constants::ch8_height];
+				const auto pixels = framebuffer::place_sprite_line(s.mem[regs.i + line][lane], x_offset);
+				if (framebuffer::draw_sprite_line(row, pixels))
+					regs.v[0xF] = std::byte{0x01};
+			}
+			break;
+		}
+
+		case opcode::skp_reg:
+			instructions::skp_reg(regs, s.keys[lane], decoded.x);
+			break;
+
+		case opcode::sknp_reg:
+			instructions::sknp_reg(regs, s.keys[lane], decoded.x);
+			break;
+
+		case opcode::ld_reg_k:
+			is_pc_advanced = instructions::ld_reg_k(regs, s.keys[lane], decoded.x);
+			break;
+
+		case opcode::ld_b_reg:
+		{
+			if (size_t{regs.i} + 3 > constants::mem_size)
+				return halt(fault::memory_access);
+
+			auto number = std::to_integer<int>(regs.v[decoded.x]);
+			for (int idx = 2; idx >= 0; --idx)
+			{
+				s.mem[regs.i + idx][lane] = std::byte(number % 10);
+				number /= 10;
+			}
+			break;
+		}
+
+		case opcode::str_i_reg:
+			if (size_t{regs.i} + decoded.x >= constants::mem_size)
+				return halt(fault::memory_access);
+			for (auto idx = size_t{0}; idx <= decoded.x; ++idx)
+				s.mem[regs.i + idx][lane] = regs.v[idx];
+			break;
+
+		case opcode::str_reg_i:
+			if (size_t{regs.i} + decoded.x >= constants::mem_size)
+				return halt(fault::memory_access);
+			for (auto idx = size_t{0}; idx <= decoded.x; ++idx)
+				regs.v[idx] = s.mem[regs.i + idx][lane];
+			break;
+
+		case opcode::se_reg_byte: instructions::se_reg_byte(regs, instr); break;
+		case opcode::sne_reg_byte: instructions::sne_reg_byte(regs, instr); break;
+		case opcode::se_reg_reg: instructions::se_reg_reg(regs, instr); break;
+		case opcode::ld_reg_byte: instructions::ld_reg_byte(regs, instr); break;
+		case opcode::add_reg_byte: instructions::add_reg_byte(regs, instr); break;
+		case opcode::ld_reg_reg: instructions::ld_reg_reg(regs, instr); break;
+		case opcode::or_reg_reg: instructions::or_reg_reg(regs, instr); break;
+		case opcode::and_reg_reg: instructions::and_reg_reg(regs, instr); break;
+		case opcode::xor_reg_reg: instructions::xor_reg_reg(regs, instr); break;
+		case opcode::add_reg_reg: instructions::add_reg_reg(regs, instr); break;
+		case opcode::sub_reg_reg: instructions::sub_reg_reg(regs, instr); break;
+		case opcode::shr_reg_reg: instructions::shr_reg_reg(regs, instr); break;
+		case opcode::subn_reg_reg: instructions::subn_reg_reg(regs, instr); break;
+		case opcode::shl_reg_reg: instructions::shl_reg_reg(regs, instr); break;
+		case opcode::sne_reg_reg: instructions::sne_reg_reg(regs, instr); break;
+		case opcode::ld_i_addr: instructions::ld_i_addr(regs, instr); break;
+		case opcode::ld_reg_dt: instructions::ld_reg_dt(regs, instr); break;
+		case opcode::ld_dt_reg: instructions::ld_dt_reg(regs, instr); break;
+		case opcode::ld_st_reg: instructions::ld_st_reg(regs, instr); break;
+		case opcode::add_i_reg: instructions::add_i_reg(regs, instr); break;
+		case opcode::ld_f_reg: instructions::ld_f_reg(regs, instr); break;
+
+		default:
+			return halt(fault::illegal_instruction);
+	}
+
+	if (is_pc_advanced)
+		regs.pc += 2;
+
+	// Scatter registers back to their rows
+	for (auto idx = size_t{0}; idx < constants::v_reg_count; ++idx)
+		s.v[idx][lane] = std::to_integer<uint8_t>(regs.v[idx]);
+
+	s.pc[lane] = regs.pc;
+	s.i[lane] = regs.i;
+	s.sp[lane] = regs.sp;
+	s.delay[lane] = regs.delay;
+	s.sound[lane] = regs.sound;
+}
+
+template <size_t lane_count>
+void engine<lane_count>::advance_pc(lane_mask group) noexcept
+{
+	for_each_lane(group, [&](size_t lane)
+	{
+		this->m_state->pc[lane] += 2;
+	});
+}
+
+template <size_t lane_count>
+void engine<lane_count>::raise_fault(size_t lane, fault kind, instr_t instruction) noexcept
+{
+	this->m_state->faults[lane] = fault_status{kind, this->m_state->pc[lane], instruction};
+	this->m_faulted_lanes |= lane_mask{1} << lane;
+}
+
+template <size_t lane_count>
+void engine<lane_count>::update_timers() noexcept
+{
+	// Zero steps per tick keeps timers frozen
+	if (this->m_steps_per_timer_tick == 0 || --this->m_steps_until_timer_tick != 0)
+		return;
+
+	this->m_steps_until_timer_tick = this->m_steps_per_timer_tick;
+
+	auto& s = *this->m_state;
+	const auto one = simd_bytes::broadcast(0x01);
+	for (auto offset = size_t{0}; offset < s.delay.size(); offset += simd_bytes::width)
+	{
+		simd_bytes::saturating_sub(load(s.delay, offset), one).store(s.delay.data() + offset);
+		simd_bytes::saturating_sub(load(s.sound, offset), one).store(s.sound.data() + offset);
+	}
+}
+
+template struct chip8::lockstep::engine<8>;
+template struct chip8::lockstep::engine<16>;
+template struct chip8::lockstep::engine<32>;
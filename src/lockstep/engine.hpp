@@ -0,0 +1,80 @@
+#ifndef LOCKSTEP_ENGINE_HPP
+#define LOCKSTEP_ENGINE_HPP
+
+#include "fault.hpp"
+#include "registers.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace chip8::lockstep
+{
+	/*	Runs the same rom on lane_count machines at once, one instruction per lane on every step.
+	 *	State is kept in structure-of-arrays form, so a register of every lane is a contiguous row of bytes.
+	 *	Lanes that fetched the same opcode form a group. Groups of register only instructions are executed
+	 *	with SIMD kernels masked to the group, everything else and lanes that diverged from the others are
+	 *	executed one lane at a time. Timers are driven by step count instead of wall clock, so runs are
+	 *	reproducible for a given input and seed. A faulting lane halts at the faulting instruction, the other
+	 *	lanes keep running.
+	 */
+	template <size_t lane_count>
+	struct engine
+	{
+		static_assert(lane_count == 8 || lane_count == 16 || lane_count == 32, "Lane count must be 8, 16 or 32");
+
+		// Delay and sound timers are decremented every steps_per_timer_tick steps, zero keeps them frozen
+		engine(const std::filesystem::path& rom_path, size_t steps_per_timer_tick);
+		~engine();
+
+		engine(const engine&) = delete;
+		engine& operator=(const engine&) = delete;
+
+		void set_keyboard_state(size_t lane, keyboard_state keys);
+		// Seeds generator used by RND in a single lane. Lanes start seeded with their index, and a lane
+		// seeded the same way as an interpreter produces the same random numbers
+		void set_seed(size_t lane, uint64_t seed);
+
+		// Executes a single instruction in every lane
+		void step();
+		void run(size_t step_count);
+
+		[[nodiscard]] registers get_registers(size_t lane) const;
+		[[nodiscard]] std::byte read_memory(size_t lane, uint16_t address) const;
+		[[nodiscard]] bool get_pixel(size_t lane, size_t x, size_t y) const;
+
+		// Fault that halted a lane, kind is none while the lane is running
+		[[nodiscard]] const fault_status& get_fault(size_t lane) const;
+		[[nodiscard]] size_t get_faulted_lane_count() const noexcept;
+
+		// Instructions executed by SIMD kernels and by scalar path, summed over all lanes
+		[[nodiscard]] size_t get_vector_lane_steps() const noexcept;
+		[[nodiscard]] size_t get_scalar_lane_steps() const noexcept;
+
+	private:
+		struct state;
+		using lane_mask = uint32_t;
+
+		void execute_group(lane_mask group, uint16_t raw_opcode);
+		[[nodiscard]] bool execute_vector(lane_mask group, uint16_t raw_opcode);
+		void execute_scalar(size_t lane, uint16_t raw_opcode);
+		void advance_pc(lane_mask group) noexcept;
+		void raise_fault(size_t lane, fault kind, instr_t instruction) noexcept;
+		void update_timers() noexcept;
+
+		std::unique_ptr<state> m_state;
+		const size_t m_steps_per_timer_tick;
+		size_t m_steps_until_timer_tick;
+		size_t m_vector_lane_steps;
+		size_t m_scalar_lane_steps;
+		lane_mask m_faulted_lanes;
+	};
+
+	extern template struct engine<8>;
+	extern template struct engine<16>;
+	extern template struct engine<32>;
+}
+
+#endif /* LOCKSTEP_ENGINE_HPP */
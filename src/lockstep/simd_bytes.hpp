@@ -0,0 +1,258 @@
+#ifndef LOCKSTEP_SIMD_BYTES_HPP
+#define LOCKSTEP_SIMD_BYTES_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace chip8::lockstep
+{
+	/*	Unsigned bytes of several lanes in a single SIMD register.
+	 *	Uses AVX2 or SSE2 when the target has them and a single byte otherwise. Comparisons return masks
+	 *	with all bits set in lanes where they hold. Memory passed to load and store has to be aligned to width.
+	 */
+	struct simd_bytes
+	{
+#if defined(__AVX2__)
+		using native = __m256i;
+		static constexpr auto width = size_t{32};
+
+		[[nodiscard]] static simd_bytes load(const uint8_t* src) noexcept
+		{
+			return {_mm256_load_si256(reinterpret_cast<const __m256i*>(src))};
+		}
+
+		void store(uint8_t* dst) const noexcept
+		{
+			_mm256_store_si256(reinterpret_cast<__m256i*>(dst), this->value);
+		}
+
+		[[nodiscard]] static simd_bytes broadcast(uint8_t byte) noexcept
+		{
+			return {_mm256_set1_epi8(static_cast<char>(byte))};
+		}
+
+		[[nodiscard]] friend simd_bytes operator+(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_add_epi8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator-(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_sub_epi8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator&(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_and_si256(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator|(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_or_si256(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator^(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_xor_si256(lhs.value, rhs.value)};
+		}
+
+		// Returns (mask ? lhs : rhs) for every lane
+		[[nodiscard]] static simd_bytes select(simd_bytes mask, simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_blendv_epi8(rhs.value, lhs.value, mask.value)};
+		}
+
+		[[nodiscard]] static simd_bytes equal(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_cmpeq_epi8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] static simd_bytes saturating_add(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_adds_epu8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] static simd_bytes saturating_sub(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm256_subs_epu8(lhs.value, rhs.value)};
+		}
+
+		// There is no byte shift, so shifting words is followed by clearing bits from the neighbouring byte
+		[[nodiscard]] simd_bytes shift_right_1() const noexcept
+		{
+			return simd_bytes{_mm256_srli_epi16(this->value, 1)} & broadcast(0x7F);
+		}
+#elif defined(__SSE2__) || defined(_M_X64)
+		using native = __m128i;
+		static constexpr auto width = size_t{16};
+
+		[[nodiscard]] static simd_bytes load(const uint8_t* src) noexcept
+		{
+			return {_mm_load_si128(reinterpret_cast<const __m128i*>(src))};
+		}
+
+		void store(uint8_t* dst) const noexcept
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst), this->value);
+		}
+
+		[[nodiscard]] static simd_bytes broadcast(uint8_t byte) noexcept
+		{
+			return {_mm_set1_epi8(static_cast<char>(byte))};
+		}
+
+		[[nodiscard]] friend simd_bytes operator+(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_add_epi8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator-(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_sub_epi8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator&(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_and_si128(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator|(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_or_si128(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator^(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_xor_si128(lhs.value, rhs.value)};
+		}
+
+		// Returns (mask ? lhs : rhs) for every lane. SSE2 has no blend, so it is built from bitwise operations
+		[[nodiscard]] static simd_bytes select(simd_bytes mask, simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_or_si128(_mm_and_si128(mask.value, lhs.value), _mm_andnot_si128(mask.value, rhs.value))};
+		}
+
+		[[nodiscard]] static simd_bytes equal(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_cmpeq_epi8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] static simd_bytes saturating_add(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_adds_epu8(lhs.value, rhs.value)};
+		}
+
+		[[nodiscard]] static simd_bytes saturating_sub(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {_mm_subs_epu8(lhs.value, rhs.value)};
+		}
+
+		// There is no byte shift, so shifting words is followed by clearing bits from the neighbouring byte
+		[[nodiscard]] simd_bytes shift_right_1() const noexcept
+		{
+			return simd_bytes{_mm_srli_epi16(this->value, 1)} & broadcast(0x7F);
+		}
+#else
+		using native = uint8_t;
+		static constexpr auto width = size_t{1};
+
+		[[nodiscard]] static simd_bytes load(const uint8_t* src) noexcept
+		{
+			return {*src};
+		}
+
+		void store(uint8_t* dst) const noexcept
+		{
+			*dst = this->value;
+		}
+
+		[[nodiscard]] static simd_bytes broadcast(uint8_t byte) noexcept
+		{
+			return {byte};
+		}
+
+		[[nodiscard]] friend simd_bytes operator+(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value + rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator-(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value - rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator&(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value & rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator|(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value | rhs.value)};
+		}
+
+		[[nodiscard]] friend simd_bytes operator^(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value ^ rhs.value)};
+		}
+
+		// Returns (mask ? lhs : rhs) for every lane
+		[[nodiscard]] static simd_bytes select(simd_bytes mask, simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t((mask.value & lhs.value) | (~mask.value & rhs.value))};
+		}
+
+		[[nodiscard]] static simd_bytes equal(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value == rhs.value ? 0xFF : 0x00)};
+		}
+
+		[[nodiscard]] static simd_bytes saturating_add(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value > 0xFF - rhs.value ? 0xFF : lhs.value + rhs.value)};
+		}
+
+		[[nodiscard]] static simd_bytes saturating_sub(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return {uint8_t(lhs.value > rhs.value ? lhs.value - rhs.value : 0)};
+		}
+
+		[[nodiscard]] simd_bytes shift_right_1() const noexcept
+		{
+			return {uint8_t(this->value >> 1)};
+		}
+#endif
+
+		[[nodiscard]] simd_bytes operator~() const noexcept
+		{
+			return *this ^ broadcast(0xFF);
+		}
+
+		[[nodiscard]] simd_bytes shift_left_1() const noexcept
+		{
+			return *this + *this;
+		}
+
+		// Unsigned lhs > rhs, which is the case when saturating subtraction does not reach zero
+		[[nodiscard]] static simd_bytes greater(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return ~equal(saturating_sub(lhs, rhs), broadcast(0x00));
+		}
+
+		// Lanes where lhs + rhs does not fit in a byte, which is the case when saturation kicks in
+		[[nodiscard]] static simd_bytes add_carry(simd_bytes lhs, simd_bytes rhs) noexcept
+		{
+			return ~equal(saturating_add(lhs, rhs), lhs + rhs);
+		}
+
+		native value;
+	};
+}
+
+#endif /* LOCKSTEP_SIMD_BYTES_HPP */
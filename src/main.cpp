@@ -1,11 +1,27 @@
+#include "clock_source.hpp"
 #include "constants.hpp"
+#include "execution_engine.hpp"
+#include "fault.hpp"
+#include "flag_evaluation.hpp"
+#include "memory_model.hpp"
+#include "presentation_mode.hpp"
+#include "quirks.hpp"
 #include "sdl/sdl_environment.hpp"
 #include "interpreter.hpp"
+#include "io/headless_backend.hpp"
+#include "io/sdl_backend.hpp"
+#include "lockstep/engine.hpp"
 
 #include "cxxopts.hpp"
 #include <SDL_log.h>
 #include <SDL_version.h>
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <string>
+
 using namespace std::literals::string_literals;
 
 namespace
@@ -19,7 +35,34 @@ namespace
 			("r, rom"s, "Path to chip8 (*.ch8) rom file"s, cxxopts::value<std::string>())
 			("f, freq"s, "Speed of emulation", cxxopts::value<int>()->default_value("500"s))
 			("d, debug"s, "Enable debug strings"s, cxxopts::value<bool>())
-			("upscale-mult"s, "Resolution multiplier"s, cxxopts::value<int>()->default_value("20"));
+			("e, engine"s, "Execution engine (interpreter, threaded, specialized, jit, aot)"s,
+				cxxopts::value<std::string>()->default_value("interpreter"s))
+			("flags"s, "VF evaluation (eager - on every ALU instruction, lazy - when VF is used)"s,
+				cxxopts::value<std::string>()->default_value("eager"s))
+			("memory"s, "Memory model (strict - accesses past 0xFFF fault, masked - I is masked to 12 bits unchecked)"s,
+				cxxopts::value<std::string>()->default_value("strict"s))
+			("quirks"s, "Quirk profile of the rom's target platform (vip, chip48, schip, modern)"s,
+				cxxopts::value<std::string>()->default_value("modern"s))
+			("faults"s, "Fault policy (halt - stop at faulting instruction, skip - skip faulting instructions, "
+				"trap - return at faulting instruction, which exits like halt)"s,
+				cxxopts::value<std::string>()->default_value("halt"s))
+			("present"s, "Frame presentation (immediate - on every CLS/DRW, coalesced - at most 60 Hz)"s,
+				cxxopts::value<std::string>()->default_value("coalesced"s))
+			("display"s, "Display driver (renderer, surface)"s,
+				cxxopts::value<std::string>()->default_value("renderer"s))
+			("upscale-mult"s, "Resolution multiplier"s, cxxopts::value<int>()->default_value("20"))
+			("headless"s, "Run without display, audio and input at uncapped speed"s, cxxopts::value<bool>())
+			("instructions"s, "Number of instructions to execute in headless mode (0 - unlimited)"s,
+				cxxopts::value<size_t>()->default_value("0"s))
+			("batch-size"s, "Instructions executed between processing events and timers"s,
+				cxxopts::value<size_t>()->default_value(std::to_string(chip8::interpreter::default_batch_size)))
+			("clock"s, "Clock source (host - wall clock, virtual - time derived from executed instructions)"s,
+				cxxopts::value<std::string>()->default_value("host"s))
+			("seed"s, "Seed for random numbers (random when not given)"s, cxxopts::value<uint64_t>())
+			("lanes"s, "Run this many machines in lockstep in headless mode (8, 16 or 32). Lockstep engine has its "
+				"own fixed configuration and can't be combined with engine, flags, memory, clock and batch-size "
+				"options, nor with quirks and faults other than the defaults"s,
+				cxxopts::value<size_t>());
 
 		return opts;
 	}
@@ -52,12 +95,243 @@ namespace
 		return std::chrono::duration_cast<std::chrono::nanoseconds>(1s) / freq;
 	}
 
+	[[nodiscard]] auto parse_execution_engine(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["engine"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Execution engine: %s", name.c_str());
+
+		if (const auto engine = chip8::parse_execution_engine_name(name))
+			return *engine;
+
+		throw std::invalid_argument("Unknown execution engine "s + name);
+	}
+
+	[[nodiscard]] auto parse_flag_evaluation(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["flags"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Flag evaluation: %s", name.c_str());
+
+		if (const auto evaluation = chip8::parse_flag_evaluation_name(name))
+			return *evaluation;
+
+		throw std::invalid_argument("Unknown flag evaluation "s + name);
+	}
+
+	[[nodiscard]] auto parse_memory_model(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["memory"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Memory model: %s", name.c_str());
+
+		if (const auto model = chip8::parse_memory_model_name(name))
+			return *model;
+
+		throw std::invalid_argument("Unknown memory model "s + name);
+	}
+
+	[[nodiscard]] auto parse_quirk_profile(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["quirks"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Quirk profile: %s", name.c_str());
+
+		if (const auto profile = chip8::parse_quirk_profile_name(name))
+			return *profile;
+
+		throw std::invalid_argument("Unknown quirk profile "s + name);
+	}
+
+	[[nodiscard]] auto parse_fault_policy(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["faults"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Fault policy: %s", name.c_str());
+
+		if (const auto policy = chip8::parse_fault_policy_name(name))
+			return *policy;
+
+		throw std::invalid_argument("Unknown fault policy "s + name);
+	}
+
+	[[nodiscard]] auto parse_presentation_mode(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["present"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Presentation mode: %s", name.c_str());
+
+		if (const auto mode = chip8::parse_presentation_mode_name(name))
+			return *mode;
+
+		throw std::invalid_argument("Unknown presentation mode "s + name);
+	}
+
+	[[nodiscard]] auto parse_display_driver(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["display"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Display driver: %s", name.c_str());
+
+		if (const auto driver = chip8::parse_display_driver_name(name))
+			return *driver;
+
+		throw std::invalid_argument("Unknown display driver "s + name);
+	}
+
+	[[nodiscard]] auto parse_clock_source(const cxxopts::ParseResult& parse_result)
+	{
+		const auto name = parse_result["clock"].as<std::string>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Clock source: %s", name.c_str());
+
+		if (const auto source = chip8::parse_clock_source_name(name))
+			return *source;
+
+		throw std::invalid_argument("Unknown clock source "s + name);
+	}
+
 	[[nodiscard]] auto parse_upscale_multiplier(const cxxopts::ParseResult& parse_result)
 	{
 		auto mult = parse_result["upscale-mult"].as<int>();
 		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Upscale multiplier: %d", mult);
 		return mult;
 	}
+
+	[[nodiscard]] auto parse_instruction_limit(const cxxopts::ParseResult& parse_result)
+	{
+		const auto limit = parse_result["instructions"].as<size_t>();
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Instruction limit: %zu", limit);
+		return (limit == 0) ? std::numeric_limits<size_t>::max() : limit;
+	}
+
+	[[nodiscard]] auto parse_seed(const cxxopts::ParseResult& parse_result)
+	{
+		const auto seed = parse_result["seed"].count() ?
+			parse_result["seed"].as<uint64_t>() : uint64_t{std::random_device{}()};
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Random seed: %llu", static_cast<unsigned long long>(seed));
+		return seed;
+	}
+
+	// Returns whether machine stopped at a fault
+	[[nodiscard]] bool log_faults(const chip8::interpreter& interpreter)
+	{
+		if (interpreter.get_fault_count() == 0)
+			return false;
+
+		const auto description = chip8::describe_fault(interpreter.get_last_fault());
+		if (interpreter.is_faulted())
+		{
+			SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Machine stopped: %s", description.c_str());
+			return true;
+		}
+
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%zu faulting instructions were skipped, last one: %s",
+			interpreter.get_fault_count(), description.c_str());
+		return false;
+	}
+
+	void log_fusion_counts(const chip8::interpreter& interpreter)
+	{
+		const auto& counts = interpreter.get_fusion_counts();
+		for (auto idx = size_t{0}; idx < counts.size(); ++idx)
+		{
+			if (counts[idx] > 0)
+				SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Fused %s executed %zu times",
+					chip8::fused_opcode_names[idx].data(), counts[idx]);
+		}
+	}
+
+	// Tick period is only used in virtual time, host clock runs uncapped. Returns whether machine stopped at a fault
+	[[nodiscard]] bool run_headless(const std::filesystem::path& rom_path, chip8::execution_engine engine,
+		chip8::flag_evaluation flags, chip8::memory_model memory, chip8::quirk_profile quirks,
+		chip8::fault_policy faults, chip8::presentation_mode presentation, size_t batch_size, chip8::clock_source clock,
+		std::chrono::nanoseconds machine_tick_period, uint64_t seed, size_t instruction_limit)
+	{
+		const auto is_virtual_time = (clock == chip8::clock_source::virtual_time);
+		auto backend = chip8::headless_backend();
+		auto interpreter = chip8::interpreter(rom_path, backend, is_virtual_time ? machine_tick_period : 0ns,
+			engine, presentation);
+		interpreter.set_quirk_profile(quirks);
+		interpreter.set_flag_evaluation(flags);
+		interpreter.set_memory_model(memory);
+		interpreter.set_fault_policy(faults);
+		interpreter.set_batch_size(batch_size);
+		interpreter.set_clock_source(clock);
+		interpreter.set_seed(seed);
+
+		const auto start_time = std::chrono::steady_clock::now();
+		const auto executed = interpreter.run(instruction_limit);
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time);
+
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Executed %zu instructions in %.3f s (%.0f instructions per second)",
+			executed, elapsed.count(), executed / elapsed.count());
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "%zu instructions were skipped in idle loops",
+			interpreter.get_skipped_tick_count());
+		log_fusion_counts(interpreter);
+		return log_faults(interpreter);
+	}
+
+	// Returns whether any lane stopped at a fault
+	template <size_t lane_count>
+	[[nodiscard]] bool run_lockstep(const std::filesystem::path& rom_path, size_t steps_per_timer_tick,
+		uint64_t seed, size_t step_count)
+	{
+		// Every lane gets its own random stream
+		auto engine = chip8::lockstep::engine<lane_count>(rom_path, steps_per_timer_tick);
+		for (auto lane = size_t{0}; lane < lane_count; ++lane)
+			engine.set_seed(lane, seed + lane);
+
+		const auto start_time = std::chrono::steady_clock::now();
+		engine.run(step_count);
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time);
+
+		const auto executed = engine.get_vector_lane_steps() + engine.get_scalar_lane_steps();
+		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Executed %zu instructions on %zu lanes in %.3f s "
+			"(%.0f instructions per second, %zu vectorized)", executed, lane_count, elapsed.count(),
+			executed / elapsed.count(), engine.get_vector_lane_steps());
+
+		for (auto lane = size_t{0}; lane < lane_count; ++lane)
+		{
+			if (const auto& status = engine.get_fault(lane); status.kind != chip8::fault::none)
+				SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Lane %zu stopped: %s", lane,
+					chip8::describe_fault(status).c_str());
+		}
+
+		return engine.get_faulted_lane_count() > 0;
+	}
+
+	// Lockstep engine has its own fixed configuration, so options it would ignore are rejected
+	void check_lockstep_options(const cxxopts::ParseResult& parse_result, chip8::quirk_profile quirks,
+		chip8::fault_policy faults)
+	{
+		if (!parse_result["headless"].count())
+			throw std::invalid_argument("Lockstep execution only runs headless");
+
+		for (const auto& option : {"engine"s, "flags"s, "memory"s, "clock"s, "batch-size"s})
+		{
+			if (parse_result[option].count())
+				throw std::invalid_argument("Lockstep execution doesn't support --"s + option + " option"s);
+		}
+
+		if (quirks != chip8::quirk_profile::modern)
+			throw std::invalid_argument("Lockstep execution only supports modern quirks");
+		if (faults != chip8::fault_policy::halt)
+			throw std::invalid_argument("Lockstep execution only supports halt fault policy");
+	}
+
+	[[nodiscard]] bool run_lockstep(const std::filesystem::path& rom_path, size_t lanes, int freq, uint64_t seed,
+		size_t instruction_limit)
+	{
+		if (instruction_limit == std::numeric_limits<size_t>::max())
+			throw std::invalid_argument("Lockstep execution needs an instruction limit");
+
+		// Timers are driven by steps, one timer tick lasts as many instructions as at given frequency
+		const auto steps_per_timer_tick = size_t(std::max(freq / 60, 1));
+		switch (lanes)
+		{
+			case 8:
+				return run_lockstep<8>(rom_path, steps_per_timer_tick, seed, instruction_limit);
+			case 16:
+				return run_lockstep<16>(rom_path, steps_per_timer_tick, seed, instruction_limit);
+			case 32:
+				return run_lockstep<32>(rom_path, steps_per_timer_tick, seed, instruction_limit);
+			default:
+				throw std::invalid_argument("Unsupported lane count "s + std::to_string(lanes));
+		}
+	}
 }
 
 int main(int argc, char* argv[]) try
@@ -82,19 +356,62 @@ int main(int argc, char* argv[]) try
 			" argument to pass a valid path to a *.ch8 chip8 rom file");
 		return EXIT_FAILURE;
 	}
+	const auto engine = parse_execution_engine(parse_result);
+	const auto flags = parse_flag_evaluation(parse_result);
+	const auto memory = parse_memory_model(parse_result);
+	const auto quirks = parse_quirk_profile(parse_result);
+	const auto faults = parse_fault_policy(parse_result);
+	const auto presentation = parse_presentation_mode(parse_result);
+	const auto batch_size = parse_result["batch-size"].as<size_t>();
+	const auto clock = parse_clock_source(parse_result);
 	const auto machine_tick_period = parse_machine_tick_rate(parse_result);
+	const auto seed = parse_seed(parse_result);
+
+	if (parse_result["lanes"].count())
+	{
+		check_lockstep_options(parse_result, quirks, faults);
+		const auto is_faulted = run_lockstep(rom_path, parse_result["lanes"].as<size_t>(),
+			parse_result["freq"].as<int>(), seed, parse_instruction_limit(parse_result));
+		return is_faulted ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if (parse_result["headless"].count())
+	{
+		const auto is_faulted = run_headless(rom_path, engine, flags, memory, quirks, faults, presentation,
+			batch_size, clock, machine_tick_period, seed, parse_instruction_limit(parse_result));
+		return is_faulted ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
 	const auto upscale_mult = parse_upscale_multiplier(parse_result);
+	const auto driver = parse_display_driver(parse_result);
 
 	// Build SDL related stuff
 	auto sdl_game = sdl::environment();
 	auto& interpreter_window = sdl_game.create_window(u8"Chip8-cpp interpreter"s,
 		SDL_Rect{0, 0, chip8::constants::ch8_width * upscale_mult, chip8::constants::ch8_height * upscale_mult});
 	auto& beeper = sdl_game.create_beeper(chip8::constants::audio_freq, chip8::constants::audio_ampl);
+	auto backend = chip8::sdl_backend(interpreter_window, beeper, driver);
 
 	// Start interpreter
-	chip8::interpreter(rom_path, interpreter_window, beeper, machine_tick_period).run();
+	auto interpreter = chip8::interpreter(rom_path, backend, machine_tick_period, engine, presentation);
+	interpreter.set_quirk_profile(quirks);
+	interpreter.set_flag_evaluation(flags);
+	interpreter.set_memory_model(memory);
+	interpreter.set_fault_policy(faults);
+	interpreter.set_batch_size(batch_size);
+	interpreter.set_clock_source(clock);
+	interpreter.set_seed(seed);
+	static_cast<void>(interpreter.run());
+
+	const auto& stats = interpreter.get_scheduler_statistics();
+	SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "CPU utilisation %.1f%%, %zu of %zu frames missed their deadline "
+		"(worst by %.3f ms)", stats.get_cpu_utilisation() * 100.0, stats.deadline_miss_count, stats.slice_count,
+		std::chrono::duration<double, std::milli>(stats.max_lateness).count());
+	if (const auto missed = interpreter.get_missed_timer_tick_count(); missed > 0)
+		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%zu timer ticks passed while interpreter was lagging", missed);
+	log_fusion_counts(interpreter);
 
-	return EXIT_SUCCESS;
+	return log_faults(interpreter) ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 catch(std::exception& e)
 {
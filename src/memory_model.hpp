@@ -0,0 +1,29 @@
+#ifndef MEMORY_MODEL_HPP
+#define MEMORY_MODEL_HPP
+
+#include <optional>
+#include <string_view>
+
+namespace chip8
+{
+	enum class memory_model
+	{
+		// Accesses through I are checked, the ones running past 0xFFF fault
+		strict,
+		// I is masked to 12 bits without any checks, accesses running past 0xFFF land in the guard band
+		masked
+	};
+
+	// Maps command line memory model name to model, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<memory_model> parse_memory_model_name(std::string_view name) noexcept
+	{
+		if (name == "strict")
+			return memory_model::strict;
+		if (name == "masked")
+			return memory_model::masked;
+
+		return std::nullopt;
+	}
+}
+
+#endif /* MEMORY_MODEL_HPP */
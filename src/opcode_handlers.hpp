@@ -0,0 +1,843 @@
+#ifndef OPCODE_HANDLERS_HPP
+#define OPCODE_HANDLERS_HPP
+
+#include "interpreter.hpp"
+
+#include "framebuffer.hpp"
+#include "instructions.hpp"
+#include "memory_model.hpp"
+#include "quirks.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace chip8
+{
+	/*	Executes decoded instructions on interpreter state. Every handler is responsible for advancing PC.
+	 *	Handlers of instructions that differ between quirk profiles are instantiated for every profile, the
+	 *	interpreter picks the handler table of its profile once and decodes instructions with it.
+	 *	Handlers that compilers don't inline also take operands known at compile time, for the specialized engine.
+	 */
+	struct opcode_handlers
+	{
+		// Freshly fused pair is executed as its first instruction, only dispatch knows whether both instructions
+		// fit into the tick budget
+		static void decode_and_execute(interpreter& self, const decoded_instruction&)
+		{
+			const auto instr = unfuse(predecode(self, self.m_registers.pc), *self.m_handlers);
+			instr.handler(self, instr);
+		}
+
+		static void illegal(interpreter& self, const decoded_instruction&)
+		{
+			self.raise_fault(fault::illegal_instruction);
+		}
+
+		static void cls(interpreter& self, const decoded_instruction&)
+		{
+			self.m_video_mem.fill(0);
+			self.report_frame_change();
+			self.m_registers.pc += 2;
+		}
+
+		// Computes VF left by a deferred ALU instruction, then executes the instruction with its own handler
+		static void materialize_flag(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::materialize_flag(self.m_registers, self.m_deferred_flag);
+			(*self.m_handlers)[static_cast<size_t>(instr.materialized_op)](self, instr);
+		}
+
+		static void ret(interpreter& self, const decoded_instruction&)
+		{
+			if (!instructions::ret(self.m_registers, self.m_stack))
+			{
+				self.raise_fault(fault::stack_underflow);
+				return;
+			}
+
+			self.m_registers.pc += 2;
+		}
+
+		static void jp(interpreter& self, const decoded_instruction& instr)
+		{
+			// Jump to itself never ends, only timers keep changing
+			if (instr.nnn == self.m_registers.pc)
+				self.enter_idle_loop({instr.nnn, 1, 0, std::chrono::nanoseconds::max()});
+
+			instructions::jp(self.m_registers, instr.nnn);
+		}
+
+		static void call(interpreter& self, const decoded_instruction& instr)
+		{
+			if (!instructions::call(self.m_registers, self.m_stack, instr.nnn))
+				self.raise_fault(fault::stack_overflow);
+		}
+
+		// Jump sets PC itself, so it isn't advanced afterwards
+		template <quirks q>
+		static void jp_offset(interpreter& self, const decoded_instruction& instr)
+		{
+			if constexpr (q.is_jump_offset_vx)
+				instructions::jp_vx_addr(self.m_registers, instr.x, instr.nnn);
+			else
+				instructions::jp_v0_addr(self.m_registers, instr.nnn);
+		}
+
+		template <quirks q, typename instruction_type = decoded_instruction>
+		static void drw(interpreter& self, const instruction_type& instr)
+		{
+			if (size_t{self.m_registers.i} + instr.n > constants::mem_size)
+			{
+				self.raise_fault(fault::memory_access);
+				return;
+			}
+
+			draw_sprite<q>(self, instr, self.m_registers.i);
+		}
+
+		template <quirks q>
+		static void drw_masked(interpreter& self, const decoded_instruction& instr)
+		{
+			draw_sprite<q>(self, instr, self.m_registers.i & constants::address_mask);
+		}
+
+		// Draws sprite of DRW starting at address, which has to be checked already
+		template <quirks q, typename instruction_type>
+		static void draw_sprite(interpreter& self, const instruction_type& instr, size_t address)
+		{
+			// Start coordinates wrap around the screen. Sprite pixels crossing an edge wrap as well, unless sprites
+			// are clipped, which drops them
+			constexpr auto place_sprite_line = q.is_sprite_clipped ? &framebuffer::place_clipped_sprite_line :
+				&framebuffer::place_sprite_line;
+
+			self.m_registers.v[0xF] = std::byte{0x00};
+			const auto x_offset = std::to_integer<size_t>(self.m_registers.v[instr.x]) % constants::ch8_width;
+			const auto y_offset = std::to_integer<size_t>(self.m_registers.v[instr.y]) % constants::ch8_height;
+			const auto line_count = q.is_sprite_clipped ? std::min(size_t{instr.n}, constants::ch8_height - y_offset) :
+				size_t{instr.n};
+
+			auto is_collision = false;
+			for (size_t line = 0; line < line_count; ++line)
+			{
+				auto& row = self.m_video_mem[(y_offset + line) % constants::ch8_height];
+				const auto pixels = place_sprite_line(self.m_mem[address + line], x_offset);
+				is_collision |= framebuffer::draw_sprite_line(row, pixels);
+			}
+
+			if (is_collision)
+				self.m_registers.v[0xF] = std::byte{0x01};
+
+			self.report_frame_change();
+			self.m_registers.pc += 2;
+		}
+
+		static void skp_reg(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::skp_reg(self.m_registers, self.m_keys, instr.x);
+			self.m_registers.pc += 2;
+		}
+
+		static void sknp_reg(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::sknp_reg(self.m_registers, self.m_keys, instr.x);
+			self.m_registers.pc += 2;
+		}
+
+		static void rnd_reg_byte(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::rnd_reg_byte(self.m_registers, self.m_random, instr.x, instr.kk);
+			self.m_registers.pc += 2;
+		}
+
+		// Without a pressed key machine stops fetching instructions until one is pressed
+		static void ld_reg_k(interpreter& self, const decoded_instruction& instr)
+		{
+			if (instructions::ld_reg_k(self.m_registers, self.m_keys, instr.x))
+			{
+				self.m_registers.pc += 2;
+				return;
+			}
+
+			self.m_state = interpreter::machine_state::waiting_for_key;
+			self.m_key_wait_register = instr.x;
+		}
+
+		template <typename instruction_type = decoded_instruction>
+		static void ld_reg_dt(interpreter& self, const instruction_type& instr)
+		{
+			const auto pc = self.m_registers.pc;
+			self.m_registers.delay = self.m_delay_timer.get(self.m_machine_time);
+			instructions::ld_reg_dt(self.m_registers, instr.x);
+			self.m_registers.pc += 2;
+
+			// LD Vx, DT; SE Vx, 0; JP back only polls the delay timer until it reaches zero
+			if (self.m_registers.delay != 0 && is_delay_poll_loop(self.m_mem, pc, instr.x))
+				self.enter_idle_loop({pc, 3, 1, self.m_delay_timer.get_deadline()});
+		}
+
+		static void ld_dt_reg(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::ld_dt_reg(self.m_registers, instr.x);
+			self.m_delay_timer.set(self.m_registers.delay, self.m_machine_time);
+			self.m_registers.pc += 2;
+		}
+
+		static void ld_st_reg(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::ld_st_reg(self.m_registers, instr.x);
+			self.report_sound_timer_change();
+			self.m_registers.pc += 2;
+		}
+
+		static void ld_b_reg(interpreter& self, const decoded_instruction& instr)
+		{
+			if (!instructions::ld_b_reg(self.m_registers, self.m_mem, instr.x))
+			{
+				self.raise_fault(fault::memory_access);
+				return;
+			}
+
+			self.report_memory_write(self.m_registers.i, 3);
+			self.m_registers.pc += 2;
+		}
+
+		template <quirks q>
+		static void str_i_reg(interpreter& self, const decoded_instruction& instr)
+		{
+			if (!instructions::str_i_reg(self.m_registers, self.m_mem, instr.x))
+			{
+				self.raise_fault(fault::memory_access);
+				return;
+			}
+
+			// Write may reset the cache entry instr refers to, when the instruction overwrites itself
+			const auto x = instr.x;
+			self.report_memory_write(self.m_registers.i, size_t{x} + 1);
+			advance_index<q>(self.m_registers, x);
+			self.m_registers.pc += 2;
+		}
+
+		template <quirks q>
+		static void str_reg_i(interpreter& self, const decoded_instruction& instr)
+		{
+			if (!instructions::str_reg_i(self.m_registers, self.m_mem, instr.x))
+			{
+				self.raise_fault(fault::memory_access);
+				return;
+			}
+
+			advance_index<q>(self.m_registers, instr.x);
+			self.m_registers.pc += 2;
+		}
+
+		// Writes running into the guard band don't reach any cached instruction, so only the masked range is reported
+		static void ld_b_reg_masked(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::ld_b_reg_masked(self.m_registers, self.m_mem, instr.x);
+			self.report_memory_write(self.m_registers.i & constants::address_mask, 3);
+			self.m_registers.pc += 2;
+		}
+
+		template <quirks q>
+		static void str_i_reg_masked(interpreter& self, const decoded_instruction& instr)
+		{
+			const auto x = instr.x;
+			instructions::str_i_reg_masked(self.m_registers, self.m_mem, x);
+			self.report_memory_write(self.m_registers.i & constants::address_mask, size_t{x} + 1);
+			advance_index<q>(self.m_registers, x);
+			self.m_registers.pc += 2;
+		}
+
+		template <quirks q>
+		static void str_reg_i_masked(interpreter& self, const decoded_instruction& instr)
+		{
+			instructions::str_reg_i_masked(self.m_registers, self.m_mem, instr.x);
+			advance_index<q>(self.m_registers, instr.x);
+			self.m_registers.pc += 2;
+		}
+
+		// Moves I on after LD [I], Vx or LD Vx, [I] went through, by as much as the quirk profile does
+		template <quirks q>
+		static constexpr void advance_index(registers& regs, size_t x) noexcept
+		{
+			if constexpr (q.load_store_increment == index_increment::x)
+				regs.i = uint16_t(regs.i + x);
+			else if constexpr (q.load_store_increment == index_increment::x_plus_one)
+				regs.i = uint16_t(regs.i + x + 1);
+		}
+
+		// Adapters for instructions that only touch registers and fall through to the next instruction
+		template <void (*operation)(registers&, uint16_t) noexcept>
+		static void reg_nnn(interpreter& self, const decoded_instruction& instr)
+		{
+			operation(self.m_registers, instr.nnn);
+			self.m_registers.pc += 2;
+		}
+
+		template <void (*operation)(registers&, size_t, std::byte) noexcept>
+		static void reg_x_kk(interpreter& self, const decoded_instruction& instr)
+		{
+			operation(self.m_registers, instr.x, instr.kk);
+			self.m_registers.pc += 2;
+		}
+
+		template <void (*operation)(registers&, size_t, size_t) noexcept>
+		static void reg_x_y(interpreter& self, const decoded_instruction& instr)
+		{
+			operation(self.m_registers, instr.x, instr.y);
+			self.m_registers.pc += 2;
+		}
+
+		template <void (*operation)(registers&, size_t) noexcept>
+		static void reg_x(interpreter& self, const decoded_instruction& instr)
+		{
+			operation(self.m_registers, instr.x);
+			self.m_registers.pc += 2;
+		}
+
+		template <void (*operation)(registers&, deferred_flag&, size_t, size_t) noexcept>
+		static void deferred_x_y(interpreter& self, const decoded_instruction& instr)
+		{
+			operation(self.m_registers, self.m_deferred_flag, instr.x, instr.y);
+			self.m_registers.pc += 2;
+		}
+
+		template <void (*operation)(registers&, deferred_flag&, size_t) noexcept>
+		static void deferred_x(interpreter& self, const decoded_instruction& instr)
+		{
+			operation(self.m_registers, self.m_deferred_flag, instr.x);
+			self.m_registers.pc += 2;
+		}
+
+		// SHR and SHL shift Vx in place, profiles shifting Vy copy it into Vx first
+		template <quirks q, void (*operation)(registers&, size_t) noexcept>
+		static void shift(interpreter& self, const decoded_instruction& instr)
+		{
+			if constexpr (q.is_shift_from_vy)
+				instructions::ld_reg_reg(self.m_registers, instr.x, instr.y);
+
+			reg_x<operation>(self, instr);
+		}
+
+		template <quirks q, void (*operation)(registers&, deferred_flag&, size_t) noexcept>
+		static void deferred_shift(interpreter& self, const decoded_instruction& instr)
+		{
+			if constexpr (q.is_shift_from_vy)
+				instructions::ld_reg_reg(self.m_registers, instr.x, instr.y);
+
+			deferred_x<operation>(self, instr);
+		}
+
+		// Executes the first instruction of a fused pair and, unless it skipped the second one, the second
+		// instruction straight from the cache, where it was stored when the pair was fused
+		template <opcode fused_op, instruction_handler first, instruction_handler second>
+		static void fused(interpreter& self, const decoded_instruction& instr)
+		{
+			const auto second_pc = uint16_t(self.m_registers.pc + 2);
+			first(self, instr);
+			if (self.m_registers.pc != second_pc)
+				return;
+
+			second(self, self.m_instruction_cache[second_pc]);
+			++self.m_fused_tick_count;
+			++self.m_fusion_counts[get_fused_opcode_index(fused_op)];
+		}
+
+		// Executes up to max_instructions with direct threaded dispatch. Returns number of executed instructions
+		template <quirks q>
+		static size_t execute_threaded(interpreter& self, size_t max_instructions);
+
+		// Executes up to max_instructions by indexing a table of handlers specialized for every raw opcode.
+		// Only supports the modern quirk profile. Returns number of executed instructions
+		static size_t execute_specialized(interpreter& self, size_t max_instructions);
+
+		using threaded_executor = size_t (*)(interpreter&, size_t);
+
+		[[nodiscard]] static const handler_table_t& get_handler_table(quirk_profile profile) noexcept;
+		[[nodiscard]] static threaded_executor get_threaded_executor(quirk_profile profile) noexcept;
+
+		// Handlers of the modern profile, for callers only interested in opcode and operands
+		[[nodiscard]] static constexpr decoded_instruction decode(instr_t instr) noexcept
+		{
+			return decode(instr, handler_table<modern_quirks>);
+		}
+
+		[[nodiscard]] static constexpr decoded_instruction decode(instr_t instr,
+			const handler_table_t& handlers) noexcept
+		{
+			const auto op = select_opcode(instr);
+			return decoded_instruction{
+				handlers[static_cast<size_t>(op)],
+				instructions::detail::get_lower_12_bits<uint16_t>(instr),
+				instructions::get_lower_nibble<uint8_t>(instr[0]),
+				instructions::get_upper_nibble<uint8_t>(instr[1]),
+				instructions::get_lower_nibble<uint8_t>(instr[1]),
+				instr[1],
+				op,
+				opcode::decode
+			};
+		}
+
+		// Decodes instruction at address into the cache. Instruction starting a pair with a fused handler is
+		// stored as the fused pair, with the following instruction decoded into the cache as well
+		static const decoded_instruction& predecode(interpreter& self, uint16_t address)
+		{
+			auto& cache = self.m_instruction_cache;
+			const auto& handlers = *self.m_handlers;
+			auto instr = decode(instructions::fetch(self.m_mem, address), handlers, self.m_flag_evaluation,
+				self.m_memory_model);
+			if (size_t{address} + 4 <= constants::mem_size)
+			{
+				const auto next = decode(instructions::fetch(self.m_mem, address + 2), handlers,
+					self.m_flag_evaluation, self.m_memory_model);
+				if (const auto fused_op = select_fused_opcode(instr.op, next.op); fused_op != instr.op)
+				{
+					// Entry already decoded there describes the same instruction, fused or not
+					if (cache[address + 2].op == opcode::decode)
+						cache.store(address + 2, next);
+
+					instr.handler = handlers[static_cast<size_t>(fused_op)];
+					instr.op = fused_op;
+				}
+			}
+
+			cache.store(address, instr);
+			return cache[address];
+		}
+
+		// Fused pair keeps operands of its first instruction, which is executed alone when it can't be paired
+		[[nodiscard]] static constexpr decoded_instruction unfuse(const decoded_instruction& instr,
+			const handler_table_t& handlers) noexcept
+		{
+			auto first = instr;
+			first.op = select_first_opcode(instr.op);
+			first.handler = handlers[static_cast<size_t>(first.op)];
+			return first;
+		}
+
+	private:
+		using specialized_handler = void (*)(interpreter&);
+
+		// Masked memory model replaces memory instructions with their unchecked variants
+		[[nodiscard]] static constexpr decoded_instruction decode(instr_t instr, const handler_table_t& handlers,
+			memory_model model) noexcept
+		{
+			auto decoded = decode(instr, handlers);
+			if (model == memory_model::strict)
+				return decoded;
+
+			decoded.op = select_masked_opcode(decoded.op);
+			decoded.handler = handlers[static_cast<size_t>(decoded.op)];
+			return decoded;
+		}
+
+		// Lazy flag evaluation defers VF of flag producing ALU instructions, anything else touching VF has to
+		// compute it first. Fused handlers never see either of them, as they don't pair up
+		[[nodiscard]] static constexpr decoded_instruction decode(instr_t instr, const handler_table_t& handlers,
+			flag_evaluation evaluation, memory_model model) noexcept
+		{
+			auto decoded = decode(instr, handlers, model);
+			if (evaluation == flag_evaluation::eager)
+				return decoded;
+
+			if (const auto op = select_lazy_opcode(decoded); op != decoded.op)
+			{
+				// Instruction touching VF keeps its own opcode to execute after computing VF
+				if (op == opcode::materialize_flag)
+					decoded.materialized_op = decoded.op;
+
+				decoded.op = op;
+				decoded.handler = handlers[static_cast<size_t>(op)];
+			}
+
+			return decoded;
+		}
+
+		[[nodiscard]] static constexpr opcode select_lazy_opcode(const decoded_instruction& instr) noexcept
+		{
+			if (is_touching_vf(instr))
+				return opcode::materialize_flag;
+
+			switch (instr.op)
+			{
+				case opcode::add_reg_reg: return opcode::add_reg_reg_deferred;
+				case opcode::sub_reg_reg: return opcode::sub_reg_reg_deferred;
+				case opcode::shr_reg_reg: return opcode::shr_reg_reg_deferred;
+				case opcode::subn_reg_reg: return opcode::subn_reg_reg_deferred;
+				case opcode::shl_reg_reg: return opcode::shl_reg_reg_deferred;
+				default: return instr.op;
+			}
+		}
+
+		[[nodiscard]] static constexpr opcode select_masked_opcode(opcode op) noexcept
+		{
+			switch (op)
+			{
+				case opcode::drw: return opcode::drw_masked;
+				case opcode::ld_b_reg: return opcode::ld_b_reg_masked;
+				case opcode::str_i_reg: return opcode::str_i_reg_masked;
+				case opcode::str_reg_i: return opcode::str_reg_i_masked;
+				default: return op;
+			}
+		}
+
+		// Whether instruction reads or writes VF
+		[[nodiscard]] static constexpr bool is_touching_vf(const decoded_instruction& instr) noexcept
+		{
+			switch (instr.op)
+			{
+				case opcode::decode:
+				case opcode::illegal:
+				case opcode::cls:
+				case opcode::ret:
+				case opcode::jp:
+				case opcode::call:
+				case opcode::ld_i_addr:
+					return false;
+
+				// Reads Vx in profiles jumping to xnn + Vx
+				case opcode::jp_v0_addr:
+					return instr.x == 0xF;
+
+				case opcode::drw:
+				case opcode::drw_masked:
+					return true;
+
+				case opcode::se_reg_reg:
+				case opcode::ld_reg_reg:
+				case opcode::or_reg_reg:
+				case opcode::and_reg_reg:
+				case opcode::xor_reg_reg:
+				case opcode::add_reg_reg:
+				case opcode::sub_reg_reg:
+				case opcode::subn_reg_reg:
+				case opcode::sne_reg_reg:
+				// Shifts read Vy in profiles shifting from it
+				case opcode::shr_reg_reg:
+				case opcode::shl_reg_reg:
+					return instr.x == 0xF || instr.y == 0xF;
+
+				// Flag producing instructions write VF, everything else only touches Vx or registers up to Vx
+				default:
+					return instr.x == 0xF;
+			}
+		}
+
+		// Returns first opcode when the pair has no fused handler
+		[[nodiscard]] static constexpr opcode select_fused_opcode(opcode first, opcode second) noexcept
+		{
+			if (second == opcode::jp)
+			{
+				switch (first)
+				{
+					case opcode::se_reg_byte: return opcode::se_reg_byte_jp;
+					case opcode::sne_reg_byte: return opcode::sne_reg_byte_jp;
+					case opcode::se_reg_reg: return opcode::se_reg_reg_jp;
+					case opcode::sne_reg_reg: return opcode::sne_reg_reg_jp;
+					default: return first;
+				}
+			}
+
+			if (first == opcode::ld_i_addr && second == opcode::drw)
+				return opcode::ld_i_addr_drw;
+			if (first == opcode::ld_i_addr && second == opcode::drw_masked)
+				return opcode::ld_i_addr_drw_masked;
+			if (first == opcode::ld_reg_byte && second == opcode::add_reg_reg)
+				return opcode::ld_reg_byte_add_reg_reg;
+			if (first == opcode::add_i_reg && second == opcode::str_reg_i)
+				return opcode::add_i_reg_str_reg_i;
+			if (first == opcode::add_i_reg && second == opcode::str_reg_i_masked)
+				return opcode::add_i_reg_str_reg_i_masked;
+
+			return first;
+		}
+
+		[[nodiscard]] static constexpr opcode select_first_opcode(opcode op) noexcept
+		{
+			switch (op)
+			{
+				case opcode::se_reg_byte_jp: return opcode::se_reg_byte;
+				case opcode::sne_reg_byte_jp: return opcode::sne_reg_byte;
+				case opcode::se_reg_reg_jp: return opcode::se_reg_reg;
+				case opcode::sne_reg_reg_jp: return opcode::sne_reg_reg;
+				case opcode::ld_i_addr_drw: return opcode::ld_i_addr;
+				case opcode::ld_reg_byte_add_reg_reg: return opcode::ld_reg_byte;
+				case opcode::add_i_reg_str_reg_i: return opcode::add_i_reg;
+				case opcode::ld_i_addr_drw_masked: return opcode::ld_i_addr;
+				case opcode::add_i_reg_str_reg_i_masked: return opcode::add_i_reg;
+				default: return op;
+			}
+		}
+
+		[[nodiscard]] static bool is_delay_poll_loop(const memory_t& mem, uint16_t pc, uint8_t x)
+		{
+			if (size_t{pc} + 6 > constants::mem_size)
+				return false;
+
+			const auto skip = decode(instructions::fetch(mem, pc + 2));
+			const auto jump = decode(instructions::fetch(mem, pc + 4));
+			return skip.op == opcode::se_reg_byte && skip.x == x && skip.kk == std::byte{0x00} &&
+				jump.op == opcode::jp && jump.nnn == pc;
+		}
+
+		// Handler for a single raw opcode with all operands known at compile time
+		template <uint16_t raw_opcode>
+		static void execute_specialized_opcode(interpreter& self);
+
+		template <uint16_t raw_opcode>
+		[[nodiscard]] static constexpr specialized_handler select_specialized_handler() noexcept;
+
+		template <size_t instruction_class, size_t... lower_12_bits>
+		[[nodiscard]] static constexpr auto make_specialized_class_table(std::index_sequence<lower_12_bits...>) noexcept;
+
+		template <size_t... instruction_classes>
+		[[nodiscard]] static constexpr auto make_specialized_table(std::index_sequence<instruction_classes...>) noexcept;
+
+		[[nodiscard]] static constexpr opcode select_opcode(instr_t instr) noexcept
+		{
+			switch(instructions::extract_instruction_class(instr))
+			{
+				case std::byte{0x0}: // Instruction starting with 0 are further split by their second byte
+				{
+					switch (instr[1])
+					{
+						case std::byte{0xE0}: // CLS
+							return opcode::cls;
+
+						case std::byte{0xEE}: // RET
+							return opcode::ret;
+
+						default:
+							return opcode::illegal;
+					}
+				}
+
+				case std::byte{0x1}: // JP addr
+					return opcode::jp;
+
+				case std::byte{0x2}: // CALL addr
+					return opcode::call;
+
+				case std::byte{0x3}: // SE Vx, byte
+					return opcode::se_reg_byte;
+
+				case std::byte{0x4}: // SNE Vx, byte
+					return opcode::sne_reg_byte;
+
+				case std::byte{0x5}: // SE Vx, Vy
+					return opcode::se_reg_reg;
+
+				case std::byte{0x6}: // LD Vx, byte
+					return opcode::ld_reg_byte;
+
+				case std::byte{0x7}: // ADD Vx, byte
+					return opcode::add_reg_byte;
+
+				case std::byte{0x8}: // Instructions starting with 0x8 are further split by their lowest nibble
+				{
+					switch (instructions::get_lower_nibble<std::byte>(instr[1]))
+					{
+						case std::byte{0x00}: // LD Vx, Vy
+							return opcode::ld_reg_reg;
+
+						case std::byte{0x01}: // OR Vx, Vy
+							return opcode::or_reg_reg;
+
+						case std::byte{0x02}: // AND Vx, Vy
+							return opcode::and_reg_reg;
+
+						case std::byte{0x03}: // XOR Vx, Vy
+							return opcode::xor_reg_reg;
+
+						case std::byte{0x04}: // ADD Vx, Vy
+							return opcode::add_reg_reg;
+
+						case std::byte{0x05}: // SUB Vx, Vy
+							return opcode::sub_reg_reg;
+
+						case std::byte{0x06}: // SHR Vx, Vy
+							return opcode::shr_reg_reg;
+
+						case std::byte{0x07}: // SUBN Vx, Vy
+							return opcode::subn_reg_reg;
+
+						case std::byte{0x0E}: // SHL Vx, Vy
+							return opcode::shl_reg_reg;
+
+						default:
+							return opcode::illegal;
+					}
+				}
+
+				case std::byte{0x9}: // SNE Vx, Vy
+					return opcode::sne_reg_reg;
+
+				case std::byte{0xA}: // LD I, addr
+					return opcode::ld_i_addr;
+
+				case std::byte{0xB}: // JP V0, addr
+					return opcode::jp_v0_addr;
+
+				case std::byte{0xC}: // RND Vx, byte
+					return opcode::rnd_reg_byte;
+
+				case std::byte{0xD}: // DRW Vx, Vy, nibble
+					return opcode::drw;
+
+				case std::byte{0xE}: // Instructions starting with 0xE are further split by their lowest byte
+				{
+					switch (instr[1])
+					{
+						case std::byte{0x9E}: // Ex9E - SKP Vx
+							return opcode::skp_reg;
+
+						case std::byte{0xA1}: // ExA1 - SKNP Vx
+							return opcode::sknp_reg;
+
+						default:
+							return opcode::illegal;
+					}
+				}
+
+				case std::byte{0xF}: // Instructions starting with 0xF are further split by their lowest byte
+				{
+					switch (instr[1])
+					{
+						case std::byte{0x07}: // Fx07 - LD Vx, DT
+							return opcode::ld_reg_dt;
+
+						case std::byte{0x0A}: // LD Vx, K
+							return opcode::ld_reg_k;
+
+						case std::byte{0x15}: // Fx15 - LD DT, Vx
+							return opcode::ld_dt_reg;
+
+						case std::byte{0x18}: // Fx18 - LD ST, Vx
+							return opcode::ld_st_reg;
+
+						case std::byte{0x1E}: // Fx1E - ADD I, Vx
+							return opcode::add_i_reg;
+
+						case std::byte{0x29}: // Fx29 - LD F, Vx
+							return opcode::ld_f_reg;
+
+						case std::byte{0x33}: // Fx33 - LD B, Vx
+							return opcode::ld_b_reg;
+
+						case std::byte{0x55}: // Fx55 - ld [i], vx
+							return opcode::str_i_reg;
+
+						case std::byte{0x65}: // Fx65 - ld vx, [i]
+							return opcode::str_reg_i;
+
+						default:
+							return opcode::illegal;
+					}
+				}
+
+				default:
+					return opcode::illegal;
+			}
+		}
+
+		// Indexed by opcode
+		template <quirks q>
+		static constexpr auto handler_table = handler_table_t
+		{
+			&opcode_handlers::decode_and_execute,
+			&opcode_handlers::illegal,
+			&opcode_handlers::cls,
+			&opcode_handlers::ret,
+			&opcode_handlers::jp,
+			&opcode_handlers::call,
+			&opcode_handlers::reg_x_kk<&instructions::se_reg_byte>,
+			&opcode_handlers::reg_x_kk<&instructions::sne_reg_byte>,
+			&opcode_handlers::reg_x_y<&instructions::se_reg_reg>,
+			&opcode_handlers::reg_x_kk<&instructions::ld_reg_byte>,
+			&opcode_handlers::reg_x_kk<&instructions::add_reg_byte>,
+			&opcode_handlers::reg_x_y<&instructions::ld_reg_reg>,
+			&opcode_handlers::reg_x_y<&instructions::or_reg_reg>,
+			&opcode_handlers::reg_x_y<&instructions::and_reg_reg>,
+			&opcode_handlers::reg_x_y<&instructions::xor_reg_reg>,
+			&opcode_handlers::reg_x_y<&instructions::add_reg_reg>,
+			&opcode_handlers::reg_x_y<&instructions::sub_reg_reg>,
+			&opcode_handlers::shift<q, &instructions::shr_reg_reg>,
+			&opcode_handlers::reg_x_y<&instructions::subn_reg_reg>,
+			&opcode_handlers::shift<q, &instructions::shl_reg_reg>,
+			&opcode_handlers::reg_x_y<&instructions::sne_reg_reg>,
+			&opcode_handlers::reg_nnn<&instructions::ld_i_addr>,
+			&opcode_handlers::jp_offset<q>,
+			&opcode_handlers::rnd_reg_byte,
+			&opcode_handlers::drw<q>,
+			&opcode_handlers::skp_reg,
+			&opcode_handlers::sknp_reg,
+			&opcode_handlers::ld_reg_dt,
+			&opcode_handlers::ld_reg_k,
+			&opcode_handlers::ld_dt_reg,
+			&opcode_handlers::ld_st_reg,
+			&opcode_handlers::reg_x<&instructions::add_i_reg>,
+			&opcode_handlers::reg_x<&instructions::ld_f_reg>,
+			&opcode_handlers::ld_b_reg,
+			&opcode_handlers::str_i_reg<q>,
+			&opcode_handlers::str_reg_i<q>,
+			&opcode_handlers::deferred_x_y<&instructions::add_reg_reg>,
+			&opcode_handlers::deferred_x_y<&instructions::sub_reg_reg>,
+			&opcode_handlers::deferred_shift<q, &instructions::shr_reg_reg>,
+			&opcode_handlers::deferred_x_y<&instructions::subn_reg_reg>,
+			&opcode_handlers::deferred_shift<q, &instructions::shl_reg_reg>,
+			&opcode_handlers::materialize_flag,
+			&opcode_handlers::drw_masked<q>,
+			&opcode_handlers::ld_b_reg_masked,
+			&opcode_handlers::str_i_reg_masked<q>,
+			&opcode_handlers::str_reg_i_masked<q>,
+			&opcode_handlers::fused<opcode::se_reg_byte_jp, &opcode_handlers::reg_x_kk<&instructions::se_reg_byte>,
+				&opcode_handlers::jp>,
+			&opcode_handlers::fused<opcode::sne_reg_byte_jp, &opcode_handlers::reg_x_kk<&instructions::sne_reg_byte>,
+				&opcode_handlers::jp>,
+			&opcode_handlers::fused<opcode::se_reg_reg_jp, &opcode_handlers::reg_x_y<&instructions::se_reg_reg>,
+				&opcode_handlers::jp>,
+			&opcode_handlers::fused<opcode::sne_reg_reg_jp, &opcode_handlers::reg_x_y<&instructions::sne_reg_reg>,
+				&opcode_handlers::jp>,
+			&opcode_handlers::fused<opcode::ld_i_addr_drw, &opcode_handlers::reg_nnn<&instructions::ld_i_addr>,
+				&opcode_handlers::drw<q>>,
+			&opcode_handlers::fused<opcode::ld_reg_byte_add_reg_reg,
+				&opcode_handlers::reg_x_kk<&instructions::ld_reg_byte>,
+				&opcode_handlers::reg_x_y<&instructions::add_reg_reg>>,
+			&opcode_handlers::fused<opcode::add_i_reg_str_reg_i, &opcode_handlers::reg_x<&instructions::add_i_reg>,
+				&opcode_handlers::str_reg_i<q>>,
+			&opcode_handlers::fused<opcode::ld_i_addr_drw_masked, &opcode_handlers::reg_nnn<&instructions::ld_i_addr>,
+				&opcode_handlers::drw_masked<q>>,
+			&opcode_handlers::fused<opcode::add_i_reg_str_reg_i_masked,
+				&opcode_handlers::reg_x<&instructions::add_i_reg>, &opcode_handlers::str_reg_i_masked<q>>
+		};
+	};
+
+	inline const handler_table_t& opcode_handlers::get_handler_table(quirk_profile profile) noexcept
+	{
+		switch (profile)
+		{
+			case quirk_profile::vip: return handler_table<vip_quirks>;
+			case quirk_profile::chip48: return handler_table<chip48_quirks>;
+			case quirk_profile::schip: return handler_table<schip_quirks>;
+			case quirk_profile::modern: return handler_table<modern_quirks>;
+		}
+
+		return handler_table<modern_quirks>;
+	}
+
+	inline opcode_handlers::threaded_executor opcode_handlers::get_threaded_executor(quirk_profile profile) noexcept
+	{
+		switch (profile)
+		{
+			case quirk_profile::vip: return &execute_threaded<vip_quirks>;
+			case quirk_profile::chip48: return &execute_threaded<chip48_quirks>;
+			case quirk_profile::schip: return &execute_threaded<schip_quirks>;
+			case quirk_profile::modern: return &execute_threaded<modern_quirks>;
+		}
+
+		return &execute_threaded<modern_quirks>;
+	}
+}
+
+#endif /* OPCODE_HANDLERS_HPP */
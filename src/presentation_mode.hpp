@@ -0,0 +1,29 @@
+#ifndef PRESENTATION_MODE_HPP
+#define PRESENTATION_MODE_HPP
+
+#include <optional>
+#include <string_view>
+
+namespace chip8
+{
+	enum class presentation_mode
+	{
+		// Every CLS and DRW presents a frame
+		immediate,
+		// CLS and DRW only mark the frame dirty, it is presented at most once per display refresh
+		coalesced
+	};
+
+	// Maps command line presentation mode name to mode, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<presentation_mode> parse_presentation_mode_name(std::string_view name) noexcept
+	{
+		if (name == "immediate")
+			return presentation_mode::immediate;
+		if (name == "coalesced")
+			return presentation_mode::coalesced;
+
+		return std::nullopt;
+	}
+}
+
+#endif /* PRESENTATION_MODE_HPP */
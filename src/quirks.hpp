@@ -0,0 +1,82 @@
+#ifndef QUIRKS_HPP
+#define QUIRKS_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace chip8
+{
+	// How far LD [I], Vx and LD Vx, [I] move I
+	enum class index_increment : uint8_t
+	{
+		none,
+		// I points at the last accessed byte
+		x,
+		// I points past the last accessed byte
+		x_plus_one
+	};
+
+	/*	Behaviour that differs between CHIP-8 implementations, which roms written for one of them may rely on.
+	 *	Handlers are instantiated for every profile, so quirks are resolved at compile time.
+	 */
+	struct quirks
+	{
+		// SHR and SHL shift Vy into Vx instead of shifting Vx in place
+		bool is_shift_from_vy;
+		index_increment load_store_increment;
+		// Bxnn jumps to xnn + Vx instead of JP V0, addr
+		bool is_jump_offset_vx;
+		// Sprite pixels past screen edges are dropped instead of wrapping around, start coordinates still wrap
+		bool is_sprite_clipped;
+
+		constexpr bool operator==(const quirks&) const noexcept = default;
+	};
+
+	enum class quirk_profile
+	{
+		// COSMAC VIP
+		vip,
+		// CHIP-48 on HP-48 calculators
+		chip48,
+		// SUPER-CHIP 1.1
+		schip,
+		// What most present day interpreters do, the default
+		modern
+	};
+
+	inline constexpr auto vip_quirks = quirks{true, index_increment::x_plus_one, false, true};
+	inline constexpr auto chip48_quirks = quirks{false, index_increment::x, true, true};
+	inline constexpr auto schip_quirks = quirks{false, index_increment::none, true, true};
+	inline constexpr auto modern_quirks = quirks{false, index_increment::none, false, false};
+
+	[[nodiscard]] constexpr quirks get_quirks(quirk_profile profile) noexcept
+	{
+		switch (profile)
+		{
+			case quirk_profile::vip: return vip_quirks;
+			case quirk_profile::chip48: return chip48_quirks;
+			case quirk_profile::schip: return schip_quirks;
+			case quirk_profile::modern: return modern_quirks;
+		}
+
+		return modern_quirks;
+	}
+
+	// Maps command line quirk profile name to profile, returns nullopt for unknown names
+	[[nodiscard]] constexpr std::optional<quirk_profile> parse_quirk_profile_name(std::string_view name) noexcept
+	{
+		if (name == "vip")
+			return quirk_profile::vip;
+		if (name == "chip48")
+			return quirk_profile::chip48;
+		if (name == "schip")
+			return quirk_profile::schip;
+		if (name == "modern")
+			return quirk_profile::modern;
+
+		return std::nullopt;
+	}
+}
+
+#endif /* QUIRKS_HPP */
@@ -0,0 +1,92 @@
+#ifndef RANDOM_GENERATOR_HPP
+#define RANDOM_GENERATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8
+{
+	/*	Xoshiro128** generator used by RND. State is only 16 bytes, so every machine keeps its own and a
+	 *	given seed always produces the same sequence. Seed is expanded with SplitMix64, so even adjacent
+	 *	seeds produce unrelated streams.
+	 */
+	struct random_generator
+	{
+		constexpr explicit random_generator(uint64_t seed = 0) noexcept;
+
+		constexpr void seed(uint64_t seed) noexcept;
+		[[nodiscard]] constexpr uint32_t next() noexcept;
+
+		// Upper bits of the output have the best quality
+		[[nodiscard]] constexpr std::byte next_byte() noexcept;
+
+		// Raw generator state, restoring it continues the sequence where it was captured
+		[[nodiscard]] constexpr const std::array<uint32_t, 4>& get_state() const noexcept;
+		constexpr void set_state(const std::array<uint32_t, 4>& state) noexcept;
+
+	private:
+		[[nodiscard]] static constexpr uint32_t rotl(uint32_t value, int shift) noexcept;
+
+		std::array<uint32_t, 4> m_state;
+	};
+}
+
+constexpr chip8::random_generator::random_generator(uint64_t seed) noexcept :
+	m_state{}
+{
+	this->seed(seed);
+}
+
+constexpr void chip8::random_generator::seed(uint64_t seed) noexcept
+{
+	for (auto idx = size_t{0}; idx < this->m_state.size(); idx += 2)
+	{
+		seed += 0x9E37'79B9'7F4A'7C15;
+		auto mixed = seed;
+		mixed = (mixed ^ (mixed >> 30)) * 0xBF58'476D'1CE4'E5B9;
+		mixed = (mixed ^ (mixed >> 27)) * 0x94D0'49BB'1331'11EB;
+		mixed ^= mixed >> 31;
+
+		this->m_state[idx] = uint32_t(mixed);
+		this->m_state[idx + 1] = uint32_t(mixed >> 32);
+	}
+}
+
+constexpr uint32_t chip8::random_generator::next() noexcept
+{
+	auto& s = this->m_state;
+	const auto result = rotl(s[1] * 5, 7) * 9;
+	const auto t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 11);
+
+	return result;
+}
+
+constexpr std::byte chip8::random_generator::next_byte() noexcept
+{
+	return std::byte(this->next() >> 24);
+}
+
+constexpr const std::array<uint32_t, 4>& chip8::random_generator::get_state() const noexcept
+{
+	return this->m_state;
+}
+
+constexpr void chip8::random_generator::set_state(const std::array<uint32_t, 4>& state) noexcept
+{
+	this->m_state = state;
+}
+
+constexpr uint32_t chip8::random_generator::rotl(uint32_t value, int shift) noexcept
+{
+	return (value << shift) | (value >> (32 - shift));
+}
+
+#endif /* RANDOM_GENERATOR_HPP */
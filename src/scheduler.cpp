@@ -0,0 +1,75 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using namespace chip8;
+
+double scheduler_statistics::get_cpu_utilisation() const noexcept
+{
+	if (this->elapsed_time <= 0ns)
+		return 0.0;
+
+	return std::clamp(1.0 - double(this->sleep_time.count()) / double(this->elapsed_time.count()), 0.0, 1.0);
+}
+
+scheduler::scheduler(std::chrono::nanoseconds slice_period, std::chrono::nanoseconds spin_threshold) :
+	m_slice_period{slice_period},
+	m_spin_threshold{spin_threshold}
+{
+	this->start();
+}
+
+void scheduler::start()
+{
+	this->m_start_time = clock::now();
+	this->m_deadline = this->m_start_time + this->m_slice_period;
+	this->m_statistics = scheduler_statistics{};
+}
+
+void scheduler::wait_for_next_slice()
+{
+	auto now = clock::now();
+
+	// Sleep through most of the wait, the last part is spun to hit deadline precisely
+	if (this->m_deadline - now > this->m_spin_threshold)
+	{
+		std::this_thread::sleep_until(this->m_deadline - this->m_spin_threshold);
+		const auto woken_at = clock::now();
+		this->m_statistics.sleep_time += woken_at - now;
+		now = woken_at;
+	}
+
+	if (now < this->m_deadline)
+	{
+		const auto spin_start = now;
+		while (now < this->m_deadline)
+			now = clock::now();
+		this->m_statistics.spin_time += now - spin_start;
+	}
+
+	const auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(now - this->m_deadline);
+	this->m_statistics.max_lateness = std::max(this->m_statistics.max_lateness, lateness);
+	if (lateness > deadline_tolerance)
+	{
+		++this->m_statistics.deadline_miss_count;
+		this->m_deadline = now;
+	}
+
+	this->m_deadline += this->m_slice_period;
+	++this->m_statistics.slice_count;
+	this->m_statistics.elapsed_time = now - this->m_start_time;
+}
+
+void scheduler::resync(clock::time_point blocked_since) noexcept
+{
+	const auto now = clock::now();
+	this->m_statistics.sleep_time += now - blocked_since;
+	this->m_statistics.elapsed_time = now - this->m_start_time;
+	this->m_deadline = now + this->m_slice_period;
+}
+
+const scheduler_statistics& scheduler::get_statistics() const noexcept
+{
+	return this->m_statistics;
+}
@@ -0,0 +1,68 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+using namespace std::literals::chrono_literals;
+
+namespace chip8
+{
+	struct scheduler_statistics
+	{
+		size_t slice_count = 0;
+		// Slices that started more than deadline tolerance after their deadline
+		size_t deadline_miss_count = 0;
+
+		std::chrono::nanoseconds elapsed_time = 0ns;
+		std::chrono::nanoseconds sleep_time = 0ns;
+		std::chrono::nanoseconds spin_time = 0ns;
+		std::chrono::nanoseconds max_lateness = 0ns;
+
+		// Share of elapsed time the host thread was not asleep, from 0 to 1
+		[[nodiscard]] double get_cpu_utilisation() const noexcept;
+	};
+
+	/*	Paces work into fixed length slices without keeping a core busy.
+	 *	Waiting for the next slice sleeps until spin threshold before its deadline and spins for the rest,
+	 *	as sleeping alone may oversleep by a scheduler quantum. Slices that were missed are dropped instead of
+	 *	being caught up with.
+	 */
+	struct scheduler
+	{
+		static constexpr auto deadline_tolerance = std::chrono::nanoseconds{1ms};
+
+		explicit scheduler(std::chrono::nanoseconds slice_period, std::chrono::nanoseconds spin_threshold = 500us);
+
+		// Starts the first slice now and clears statistics
+		void start();
+		void wait_for_next_slice();
+
+		// Calls wait, which blocks host thread outside of the scheduler, e.g. on input. Blocked time counts as
+		// sleep and the next slice starts a full period after it, so blocking isn't reported as lateness
+		template <typename wait_function>
+		void wait_for_events(wait_function&& wait)
+		{
+			const auto blocked_since = clock::now();
+			std::forward<wait_function>(wait)();
+			this->resync(blocked_since);
+		}
+
+		[[nodiscard]] const scheduler_statistics& get_statistics() const noexcept;
+
+	private:
+		using clock = std::chrono::steady_clock;
+
+		void resync(clock::time_point blocked_since) noexcept;
+
+		const std::chrono::nanoseconds m_slice_period;
+		const std::chrono::nanoseconds m_spin_threshold;
+
+		clock::time_point m_start_time;
+		clock::time_point m_deadline;
+		scheduler_statistics m_statistics;
+	};
+}
+
+#endif /* SCHEDULER_HPP */
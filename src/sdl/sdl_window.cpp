@@ -32,6 +32,11 @@ SDL_Surface& window::get_window_surface() const
 	return *window_surface;
 }
 
+SDL_Window& window::get_native_window() const noexcept
+{
+	return *this->m_window;
+}
+
 void window::update()
 {
 	sdl::sdl_check_error(SDL_UpdateWindowSurface(this->m_window), "Failed to update window"s);
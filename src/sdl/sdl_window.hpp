@@ -21,6 +21,7 @@ namespace sdl
 		window& operator=(window&&) = delete;
 
 		[[nodiscard]] SDL_Surface& get_window_surface() const;
+		[[nodiscard]] SDL_Window& get_native_window() const noexcept;
 
 		void update();
 
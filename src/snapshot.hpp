@@ -0,0 +1,69 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "constants.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+namespace chip8::snapshot
+{
+	/*	Layout of machine state captured by interpreter::save_state. Fields are stored at fixed offsets with
+	 *	multi-byte values in little endian order, screen rows keep one bit per pixel like framebuffer_t.
+	 *	Timers are stored as their values, which restore their expiry exactly as they are aligned to machine time.
+	 */
+	static constexpr auto magic = uint32_t{0x5453'3843}; // "C8ST"
+
+	// Snapshots of any other version are rejected, so it has to change together with the layout
+	static constexpr auto version = uint16_t{1};
+
+	static constexpr auto magic_offset = size_t{0};
+	static constexpr auto version_offset = magic_offset + sizeof(uint32_t);
+	static constexpr auto state_offset = version_offset + sizeof(uint16_t);
+	static constexpr auto key_wait_register_offset = state_offset + 1;
+	static constexpr auto v_offset = key_wait_register_offset + 1;
+	static constexpr auto i_offset = v_offset + constants::v_reg_count;
+	static constexpr auto pc_offset = i_offset + sizeof(uint16_t);
+	static constexpr auto sp_offset = pc_offset + sizeof(uint16_t);
+	static constexpr auto delay_offset = sp_offset + 1;
+	static constexpr auto sound_offset = delay_offset + 1;
+	static constexpr auto machine_time_offset = sound_offset + 1;
+	static constexpr auto random_offset = machine_time_offset + sizeof(uint64_t);
+	static constexpr auto fault_kind_offset = random_offset + 4 * sizeof(uint32_t);
+	static constexpr auto fault_pc_offset = fault_kind_offset + 1;
+	static constexpr auto fault_instruction_offset = fault_pc_offset + sizeof(uint16_t);
+	static constexpr auto stack_offset = fault_instruction_offset + std::tuple_size_v<instr_t>;
+	static constexpr auto video_offset = stack_offset + constants::stack_size * sizeof(uint16_t);
+	static constexpr auto mem_offset = video_offset + size_t{constants::ch8_height} * sizeof(uint64_t);
+	static constexpr auto size = mem_offset + std::tuple_size_v<memory_t>;
+
+	using blob = std::array<std::byte, size>;
+
+	template <std::unsigned_integral T>
+	constexpr void store(blob& snapshot, size_t offset, T value) noexcept
+	{
+		for (auto idx = size_t{0}; idx < sizeof(T); ++idx)
+			snapshot[offset + idx] = std::byte(value >> (8 * idx));
+	}
+
+	template <std::unsigned_integral T>
+	[[nodiscard]] constexpr T load(const blob& snapshot, size_t offset) noexcept
+	{
+		auto value = T{0};
+		for (auto idx = size_t{0}; idx < sizeof(T); ++idx)
+			value |= T(std::to_integer<T>(snapshot[offset + idx]) << (8 * idx));
+
+		return value;
+	}
+}
+
+namespace chip8
+{
+	using snapshot_t = snapshot::blob;
+}
+
+#endif /* SNAPSHOT_HPP */
@@ -0,0 +1,109 @@
+#include "opcode_handlers.hpp"
+
+#include <limits>
+
+using namespace chip8;
+
+namespace
+{
+	static constexpr auto raw_opcode_count = size_t{std::numeric_limits<uint16_t>::max()} + 1;
+	static constexpr auto instruction_class_count = size_t{16};
+	static constexpr auto opcodes_per_class = raw_opcode_count / instruction_class_count;
+
+	[[nodiscard]] constexpr instr_t to_instruction(uint16_t raw_opcode) noexcept
+	{
+		return instr_t{std::byte(raw_opcode >> 8), std::byte(raw_opcode & 0xFF)};
+	}
+
+	// PC must be in range
+	[[nodiscard]] inline uint16_t fetch_raw_opcode(const memory_t& mem, uint16_t pc) noexcept
+	{
+		return (std::to_integer<uint16_t>(mem[pc]) << 8) | std::to_integer<uint16_t>(mem[pc + 1]);
+	}
+
+	void execute_illegal_opcode(interpreter& self)
+	{
+		opcode_handlers::illegal(self, decoded_instruction{});
+	}
+
+	// Operands of a raw opcode as compile-time constants, handlers instantiated for it don't read them at runtime
+	template <uint16_t raw_opcode>
+	struct constant_instruction
+	{
+		static constexpr auto decoded = opcode_handlers::decode(to_instruction(raw_opcode));
+
+		static constexpr auto nnn = decoded.nnn;
+		static constexpr auto x = decoded.x;
+		static constexpr auto y = decoded.y;
+		static constexpr auto n = decoded.n;
+		static constexpr auto kk = decoded.kk;
+	};
+}
+
+template <uint16_t raw_opcode>
+void opcode_handlers::execute_specialized_opcode(interpreter& self)
+{
+	// Decoding happens at compile time, so handler call is direct and gets operands as constants
+	static constexpr auto instr = decode(to_instruction(raw_opcode));
+
+	// Handlers too large to be inlined are instantiated for the operands, instead of reading them from instr
+	if constexpr (instr.op == opcode::drw)
+		drw<modern_quirks>(self, constant_instruction<raw_opcode>{});
+	else if constexpr (instr.op == opcode::ld_reg_dt)
+		ld_reg_dt(self, constant_instruction<raw_opcode>{});
+	else
+	{
+		constexpr auto handler = handler_table<modern_quirks>[static_cast<size_t>(instr.op)];
+		handler(self, instr);
+	}
+}
+
+template <uint16_t raw_opcode>
+constexpr opcode_handlers::specialized_handler opcode_handlers::select_specialized_handler() noexcept
+{
+	// Illegal opcodes all share a single handler instead of being instantiated
+	if constexpr (select_opcode(to_instruction(raw_opcode)) == opcode::illegal)
+		return &execute_illegal_opcode;
+	else
+		return &opcode_handlers::execute_specialized_opcode<raw_opcode>;
+}
+
+template <size_t instruction_class, size_t... lower_12_bits>
+constexpr auto opcode_handlers::make_specialized_class_table(std::index_sequence<lower_12_bits...>) noexcept
+{
+	return std::array<specialized_handler, sizeof...(lower_12_bits)>
+	{
+		select_specialized_handler<static_cast<uint16_t>((instruction_class << 12) | lower_12_bits)>()...
+	};
+}
+
+template <size_t... instruction_classes>
+constexpr auto opcode_handlers::make_specialized_table(std::index_sequence<instruction_classes...>) noexcept
+{
+	// Generated one instruction class at a time to keep template expansion depth manageable for compilers
+	auto table = std::array<specialized_handler, raw_opcode_count>{};
+	(std::ranges::copy(make_specialized_class_table<instruction_classes>(std::make_index_sequence<opcodes_per_class>{}),
+		table.begin() + instruction_classes * opcodes_per_class), ...);
+
+	return table;
+}
+
+size_t opcode_handlers::execute_specialized(interpreter& self, size_t max_instructions)
+{
+	// Indexed by raw opcode
+	static constexpr auto specialized_table = make_specialized_table(std::make_index_sequence<instruction_class_count>{});
+
+	for (auto executed = size_t{0}; executed < max_instructions; ++executed)
+	{
+		if (!self.check_pc_range())
+			return executed;
+
+		specialized_table[fetch_raw_opcode(self.m_mem, self.m_registers.pc)](self);
+		if (self.m_state == interpreter::machine_state::faulted)
+			return executed;
+		if (self.m_state != interpreter::machine_state::running)
+			return executed + 1;
+	}
+
+	return max_instructions;
+}
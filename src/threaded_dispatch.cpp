@@ -0,0 +1,334 @@
+#include "opcode_handlers.hpp"
+
+#include <iterator>
+
+using namespace chip8;
+
+template <quirks q>
+size_t opcode_handlers::execute_threaded(interpreter& self, size_t max_instructions)
+{
+	auto& regs = self.m_registers;
+	auto executed = size_t{0};
+
+#if defined(__GNUC__) || defined(__clang__)
+	// Indexed by opcode
+	static const void* const dispatch_table[] =
+	{
+		&&op_decode, &&op_illegal, &&op_cls, &&op_ret, &&op_jp, &&op_call, &&op_se_reg_byte,
+		&&op_sne_reg_byte, &&op_se_reg_reg, &&op_ld_reg_byte, &&op_add_reg_byte, &&op_ld_reg_reg,
+		&&op_or_reg_reg, &&op_and_reg_reg, &&op_xor_reg_reg, &&op_add_reg_reg, &&op_sub_reg_reg,
+		&&op_shr_reg_reg, &&op_subn_reg_reg, &&op_shl_reg_reg, &&op_sne_reg_reg, &&op_ld_i_addr,
+		&&op_jp_v0_addr, &&op_rnd_reg_byte, &&op_drw, &&op_skp_reg, &&op_sknp_reg, &&op_ld_reg_dt,
+		&&op_ld_reg_k, &&op_ld_dt_reg, &&op_ld_st_reg, &&op_add_i_reg, &&op_ld_f_reg, &&op_ld_b_reg,
+		&&op_str_i_reg, &&op_str_reg_i, &&op_add_reg_reg_deferred, &&op_sub_reg_reg_deferred,
+		&&op_shr_reg_reg_deferred, &&op_subn_reg_reg_deferred, &&op_shl_reg_reg_deferred, &&op_materialize_flag,
+		&&op_drw_masked, &&op_ld_b_reg_masked, &&op_str_i_reg_masked, &&op_str_reg_i_masked,
+		&&op_se_reg_byte_jp, &&op_sne_reg_byte_jp, &&op_se_reg_reg_jp, &&op_sne_reg_reg_jp, &&op_ld_i_addr_drw,
+		&&op_ld_reg_byte_add_reg_reg, &&op_add_i_reg_str_reg_i, &&op_ld_i_addr_drw_masked,
+		&&op_add_i_reg_str_reg_i_masked
+	};
+	static_assert(std::size(dispatch_table) == static_cast<size_t>(opcode::count),
+		"Dispatch table does not cover all opcodes");
+
+	const decoded_instruction* instr = nullptr;
+	auto decoded = decoded_instruction{};
+	auto second_pc = uint16_t{0};
+
+	// Every handler ends by jumping straight to the handler of the next instruction
+#define CHIP8_DISPATCH() \
+	do \
+	{ \
+		if (executed == max_instructions) \
+			return executed; \
+		if (!self.check_pc_range()) \
+			return executed; \
+		instr = &self.m_instruction_cache[regs.pc]; \
+		++executed; \
+		goto *dispatch_table[static_cast<size_t>(instr->op)]; \
+	} while (false)
+
+#define CHIP8_NEXT() \
+	regs.pc += 2; \
+	CHIP8_DISPATCH()
+
+	// Instruction stopped by a fault was not executed, skipped one goes on like any other
+#define CHIP8_RETURN_ON_FAULT() \
+	if (self.m_state == interpreter::machine_state::faulted) \
+		return executed - 1
+
+	// Fused pair goes on to its second instruction unless the first one skipped it or the budget is used up
+#define CHIP8_FUSED_FIRST(fused_op, first_handler) \
+	second_pc = uint16_t(regs.pc + 2); \
+	first_handler(self, *instr); \
+	if (regs.pc != second_pc || executed == max_instructions) \
+		CHIP8_DISPATCH(); \
+	instr = &self.m_instruction_cache[regs.pc]; \
+	++executed; \
+	++self.m_fusion_counts[get_fused_opcode_index(fused_op)]
+
+	CHIP8_DISPATCH();
+
+	// Like decode_and_execute, freshly fused pair is executed as its first instruction
+op_decode:
+	// Executed from a copy, as writes of the instruction to itself reset its cache entry
+	decoded = predecode(self, regs.pc);
+	instr = &decoded;
+	goto *dispatch_table[static_cast<size_t>(select_first_opcode(instr->op))];
+
+op_illegal:
+	illegal(self, *instr);
+	CHIP8_RETURN_ON_FAULT();
+	CHIP8_DISPATCH();
+
+op_cls:
+	cls(self, *instr);
+	CHIP8_DISPATCH();
+
+op_ret:
+	ret(self, *instr);
+	CHIP8_RETURN_ON_FAULT();
+	CHIP8_DISPATCH();
+
+op_jp:
+	jp(self, *instr);
+	if (self.m_state != interpreter::machine_state::running)
+		return executed;
+	CHIP8_DISPATCH();
+
+op_call:
+	call(self, *instr);
+	CHIP8_RETURN_ON_FAULT();
+	CHIP8_DISPATCH();
+
+op_se_reg_byte:
+	instructions::se_reg_byte(regs, instr->x, instr->kk);
+	CHIP8_NEXT();
+
+op_sne_reg_byte:
+	instructions::sne_reg_byte(regs, instr->x, instr->kk);
+	CHIP8_NEXT();
+
+op_se_reg_reg:
+	instructions::se_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_ld_reg_byte:
+	instructions::ld_reg_byte(regs, instr->x, instr->kk);
+	CHIP8_NEXT();
+
+op_add_reg_byte:
+	instructions::add_reg_byte(regs, instr->x, instr->kk);
+	CHIP8_NEXT();
+
+op_ld_reg_reg:
+	instructions::ld_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_or_reg_reg:
+	instructions::or_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_and_reg_reg:
+	instructions::and_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_xor_reg_reg:
+	instructions::xor_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_add_reg_reg:
+	instructions::add_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_sub_reg_reg:
+	instructions::sub_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_shr_reg_reg:
+	if constexpr (q.is_shift_from_vy)
+		instructions::ld_reg_reg(regs, instr->x, instr->y);
+	instructions::shr_reg_reg(regs, instr->x);
+	CHIP8_NEXT();
+
+op_subn_reg_reg:
+	instructions::subn_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_shl_reg_reg:
+	if constexpr (q.is_shift_from_vy)
+		instructions::ld_reg_reg(regs, instr->x, instr->y);
+	instructions::shl_reg_reg(regs, instr->x);
+	CHIP8_NEXT();
+
+op_sne_reg_reg:
+	instructions::sne_reg_reg(regs, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_ld_i_addr:
+	instructions::ld_i_addr(regs, instr->nnn);
+	CHIP8_NEXT();
+
+op_jp_v0_addr:
+	jp_offset<q>(self, *instr);
+	CHIP8_DISPATCH();
+
+op_rnd_reg_byte:
+	instructions::rnd_reg_byte(regs, self.m_random, instr->x, instr->kk);
+	CHIP8_NEXT();
+
+op_drw:
+	drw<q>(self, *instr);
+	CHIP8_RETURN_ON_FAULT();
+	CHIP8_DISPATCH();
+
+op_skp_reg:
+	skp_reg(self, *instr);
+	CHIP8_DISPATCH();
+
+op_sknp_reg:
+	sknp_reg(self, *instr);
+	CHIP8_DISPATCH();
+
+op_ld_reg_dt:
+	ld_reg_dt(self, *instr);
+	if (self.m_state != interpreter::machine_state::running)
+		return executed;
+	CHIP8_DISPATCH();
+
+op_ld_reg_k:
+	ld_reg_k(self, *instr);
+	if (self.m_state != interpreter::machine_state::running)
+		return executed;
+	CHIP8_DISPATCH();
+
+op_ld_dt_reg:
+	ld_dt_reg(self, *instr);
+	CHIP8_DISPATCH();
+
+op_ld_st_reg:
+	ld_st_reg(self, *instr);
+	CHIP8_DISPATCH();
+
+op_add_i_reg:
+	instructions::add_i_reg(regs, instr->x);
+	CHIP8_NEXT();
+
+op_ld_f_reg:
+	instructions::ld_f_reg(regs, instr->x);
+	CHIP8_NEXT();
+
+op_ld_b_reg:
+	ld_b_reg(self, *instr);
+	CHIP8_RETURN_ON_FAULT();
+	CHIP8_DISPATCH();
+
+op_str_i_reg:
+	str_i_reg<q>(self, *instr);
+	CHIP8_RETURN_ON_FAULT();
+	CHIP8_DISPATCH();
+
+op_str_reg_i:
+	str_reg_i<q>(self, *instr);
+	CHIP8_RETURN_ON_FAULT();
+	CHIP8_DISPATCH();
+
+op_add_reg_reg_deferred:
+	instructions::add_reg_reg(regs, self.m_deferred_flag, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_sub_reg_reg_deferred:
+	instructions::sub_reg_reg(regs, self.m_deferred_flag, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_shr_reg_reg_deferred:
+	if constexpr (q.is_shift_from_vy)
+		instructions::ld_reg_reg(regs, instr->x, instr->y);
+	instructions::shr_reg_reg(regs, self.m_deferred_flag, instr->x);
+	CHIP8_NEXT();
+
+op_subn_reg_reg_deferred:
+	instructions::subn_reg_reg(regs, self.m_deferred_flag, instr->x, instr->y);
+	CHIP8_NEXT();
+
+op_shl_reg_reg_deferred:
+	if constexpr (q.is_shift_from_vy)
+		instructions::ld_reg_reg(regs, instr->x, instr->y);
+	instructions::shl_reg_reg(regs, self.m_deferred_flag, instr->x);
+	CHIP8_NEXT();
+
+	// Instruction touching VF goes on to its own handler once VF is computed
+op_materialize_flag:
+	instructions::materialize_flag(regs, self.m_deferred_flag);
+	goto *dispatch_table[static_cast<size_t>(instr->materialized_op)];
+
+	// Masked memory instructions never fault
+op_drw_masked:
+	drw_masked<q>(self, *instr);
+	CHIP8_DISPATCH();
+
+op_ld_b_reg_masked:
+	ld_b_reg_masked(self, *instr);
+	CHIP8_DISPATCH();
+
+op_str_i_reg_masked:
+	str_i_reg_masked<q>(self, *instr);
+	CHIP8_DISPATCH();
+
+op_str_reg_i_masked:
+	str_reg_i_masked<q>(self, *instr);
+	CHIP8_DISPATCH();
+
+op_se_reg_byte_jp:
+	CHIP8_FUSED_FIRST(opcode::se_reg_byte_jp, reg_x_kk<&instructions::se_reg_byte>);
+	goto op_jp;
+
+op_sne_reg_byte_jp:
+	CHIP8_FUSED_FIRST(opcode::sne_reg_byte_jp, reg_x_kk<&instructions::sne_reg_byte>);
+	goto op_jp;
+
+op_se_reg_reg_jp:
+	CHIP8_FUSED_FIRST(opcode::se_reg_reg_jp, reg_x_y<&instructions::se_reg_reg>);
+	goto op_jp;
+
+op_sne_reg_reg_jp:
+	CHIP8_FUSED_FIRST(opcode::sne_reg_reg_jp, reg_x_y<&instructions::sne_reg_reg>);
+	goto op_jp;
+
+op_ld_i_addr_drw:
+	CHIP8_FUSED_FIRST(opcode::ld_i_addr_drw, reg_nnn<&instructions::ld_i_addr>);
+	goto op_drw;
+
+op_ld_reg_byte_add_reg_reg:
+	CHIP8_FUSED_FIRST(opcode::ld_reg_byte_add_reg_reg, reg_x_kk<&instructions::ld_reg_byte>);
+	goto op_add_reg_reg;
+
+op_add_i_reg_str_reg_i:
+	CHIP8_FUSED_FIRST(opcode::add_i_reg_str_reg_i, reg_x<&instructions::add_i_reg>);
+	goto op_str_reg_i;
+
+op_ld_i_addr_drw_masked:
+	CHIP8_FUSED_FIRST(opcode::ld_i_addr_drw_masked, reg_nnn<&instructions::ld_i_addr>);
+	goto op_drw_masked;
+
+op_add_i_reg_str_reg_i_masked:
+	CHIP8_FUSED_FIRST(opcode::add_i_reg_str_reg_i_masked, reg_x<&instructions::add_i_reg>);
+	goto op_str_reg_i_masked;
+
+#undef CHIP8_FUSED_FIRST
+#undef CHIP8_RETURN_ON_FAULT
+#undef CHIP8_NEXT
+#undef CHIP8_DISPATCH
+#else
+	// Without labels as values fall back to calling handlers through the instruction cache
+	while (executed < max_instructions && self.m_state == interpreter::machine_state::running)
+		executed += self.process_machine_tick(max_instructions - executed);
+
+	return executed;
+#endif
+}
+
+// Every quirk profile gets its own dispatch loop, interpreter picks one through get_threaded_executor
+template size_t opcode_handlers::execute_threaded<vip_quirks>(interpreter&, size_t);
+template size_t opcode_handlers::execute_threaded<chip48_quirks>(interpreter&, size_t);
+template size_t opcode_handlers::execute_threaded<schip_quirks>(interpreter&, size_t);
+template size_t opcode_handlers::execute_threaded<modern_quirks>(interpreter&, size_t);
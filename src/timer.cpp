@@ -1,49 +1,31 @@
 #include "timer.hpp"
 
-#include <SDL_log.h>
+#include <algorithm>
 
 using namespace chip8;
-using namespace std::literals::chrono_literals;
 
-timer::timer(uint8_t& timer_reg, const std::chrono::nanoseconds& update_period,
-	std::function<void()> start_callback, std::function<void()> stop_callback) :
-	m_reg{timer_reg},
+timer::timer(const std::chrono::nanoseconds& update_period) noexcept :
 	m_update_period{update_period},
-	m_accumulated_time{0ns},
-	m_start_callback{start_callback},
-	m_stop_callback{stop_callback}
+	m_expiry_tick{0}
 {}
 
-void timer::report_change() const
+void timer::set(uint8_t value, const std::chrono::nanoseconds& now) noexcept
 {
-	if (this->m_reg > 0 && this->m_start_callback)
-		this->m_start_callback();
-	else if (this->m_stop_callback)
-		this->m_stop_callback();
+	this->m_expiry_tick = now / this->m_update_period + value;
 }
 
-void timer::update(const std::chrono::nanoseconds& delta)
+uint8_t timer::get(const std::chrono::nanoseconds& now) const noexcept
 {
-	auto update_counter = size_t{0};
-	this->m_accumulated_time += delta;
-
-	while (this->m_accumulated_time >= this->m_update_period)
-	{
-		this->m_accumulated_time -= this->m_update_period;
-		process_timer();
-		++update_counter;
-	}
+	const auto remaining = this->m_expiry_tick - now / this->m_update_period;
+	return uint8_t(std::clamp<int64_t>(remaining, 0, 255));
+}
 
-	if (update_counter > 1)
-	{
-		SDL_LogWarn(SDL_LOG_CATEGORY_SYSTEM, "Timer had to do %d rounds to compensate for lag",
-			update_counter);
-	}
+std::chrono::nanoseconds timer::get_deadline() const noexcept
+{
+	return this->m_update_period * this->m_expiry_tick;
 }
 
-void timer::process_timer()
+void timer::reset() noexcept
 {
-	if (m_reg > 0)
-		if (--m_reg == 0 && this->m_stop_callback)
-			this->m_stop_callback();
+	this->m_expiry_tick = 0;
 }
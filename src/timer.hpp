@@ -2,32 +2,29 @@
 #define TIMER_HPP
 
 #include <chrono>
-#include <functional>
+#include <cstdint>
 
 namespace chip8
 {
+	/*	Countdown register decremented once every update period of machine time. Only the tick at which
+	 *	it reaches zero is stored and the value is derived from it when read, so a running timer needs no
+	 *	updates. Ticks are aligned to machine time zero, so every timer decrements at the same moment.
+	 */
 	struct timer
 	{
-		timer(
-			uint8_t& timer_reg,
-			const std::chrono::nanoseconds& update_period,
-			std::function<void()> start_callback = std::function<void()>(),
-			std::function<void()> stop_callback = std::function<void()>()
-		);
+		explicit timer(const std::chrono::nanoseconds& update_period) noexcept;
 
-		void report_change() const;
-		void update(const std::chrono::nanoseconds& delta);
+		void set(uint8_t value, const std::chrono::nanoseconds& now) noexcept;
+		[[nodiscard]] uint8_t get(const std::chrono::nanoseconds& now) const noexcept;
 
-	private:
-		void process_timer();
+		// Machine time at which the timer reaches zero. Lies in the past for a stopped timer
+		[[nodiscard]] std::chrono::nanoseconds get_deadline() const noexcept;
 
-		uint8_t& m_reg;
+		void reset() noexcept;
 
+	private:
 		const std::chrono::nanoseconds m_update_period;
-		std::chrono::nanoseconds m_accumulated_time;
-
-		std::function<void()> m_start_callback;
-		std::function<void()> m_stop_callback;
+		int64_t m_expiry_tick;
 	};
 }
 
@@ -4,12 +4,22 @@
 #include "constants.hpp"
 
 #include <array>
+#include <cstdint>
 
 namespace chip8
 {
-	using memory_t = std::array<std::byte, constants::mem_size>;
+	static constexpr auto key_count = size_t{16};
+
+	// Address space followed by a guard band, which only masked memory accesses running past 0xFFF reach
+	using memory_t = std::array<std::byte, constants::mem_size + constants::mem_guard_size>;
 	using stack_t = std::array<uint16_t, constants::stack_size>;
 	using instr_t = std::array<std::byte, 2>;
+
+	// Bit n is set while key n is pressed
+	using keyboard_state = uint16_t;
+
+	// One word per row of pixels, see framebuffer.hpp
+	using framebuffer_t = std::array<uint64_t, constants::ch8_height>;
 }
 
 #endif /* TYPES_HPP */
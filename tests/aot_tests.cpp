@@ -0,0 +1,178 @@
+#include "doctest.h"
+#include "test_helpers.hpp"
+
+#include "interpreter.hpp"
+#include "aot/code_analysis.hpp"
+#include "aot/code_generator.hpp"
+#include "aot/engine.hpp"
+#include "aot/program.hpp"
+#include "io/headless_backend.hpp"
+
+#include <span>
+#include <vector>
+
+using namespace chip8;
+
+namespace
+{
+	// Counts V1 up to V0, then calls a subroutine adding V0 to V2 and jumps to itself, same as tests/roms/loop.ch8
+	const auto loop_program = std::vector<uint16_t>{
+		0x6005, // 0x200: LD V0, 0x05
+		0x6100, // 0x202: LD V1, 0x00
+		0x7101, // 0x204: ADD V1, 0x01
+		0x5010, // 0x206: SE V0, V1
+		0x1204, // 0x208: JP 0x204
+		0x2210, // 0x20A: CALL 0x210
+		0x120C, // 0x20C: JP 0x20C
+		0x0000, // 0x20E: data
+		0x8204, // 0x210: ADD V2, V0
+		0x00EE  // 0x212: RET
+	};
+
+	// Allows every block to run to its end
+	constexpr auto unlimited_budget = size_t{aot::max_block_instructions};
+
+	[[nodiscard]] auto load(const std::vector<uint16_t>& program)
+	{
+		auto mem = memory_t{};
+		const auto content = helpers::to_rom_content(program);
+		std::ranges::copy(std::as_bytes(std::span{content}), mem.begin() + constants::code_start);
+		return mem;
+	}
+
+	// Translated from tests/roms/loop.ch8 by chip8-cpp-aot as part of the test build
+	[[nodiscard]] const aot::program& find_loop_program()
+	{
+		const auto* program = aot::find_program(load(loop_program));
+		REQUIRE_NE(program, nullptr);
+		return *program;
+	}
+}
+
+TEST_CASE("AOT code analysis")
+{
+	SUBCASE("Reachable code and leaders")
+	{
+		const auto analysis = aot::analyse_code(load(loop_program));
+		for (const auto address : {0x200, 0x202, 0x204, 0x206, 0x208, 0x20A, 0x20C, 0x210, 0x212})
+			REQUIRE(analysis.reachable[address]);
+
+		// Data after the jump to itself is never executed
+		REQUIRE_FALSE(analysis.reachable[0x20E]);
+		REQUIRE_EQ(analysis.reachable.count(), 9);
+
+		for (const auto address : {0x200, 0x204, 0x208, 0x20A, 0x20C, 0x210})
+			REQUIRE(analysis.leaders[address]);
+		REQUIRE_EQ(analysis.leaders.count(), 6);
+		REQUIRE(analysis.dynamic_jumps.empty());
+	}
+
+	SUBCASE("JP V0 is dynamic")
+	{
+		// LD V0, 0x02; JP V0, 0x204; LD V1, 0x01; RET
+		const auto analysis = aot::analyse_code(load({0x6002, 0xB204, 0x6101, 0x00EE}));
+		REQUIRE_EQ(analysis.dynamic_jumps, std::vector<uint16_t>{0x202});
+		REQUIRE_FALSE(analysis.reachable[0x204]);
+		REQUIRE_FALSE(analysis.reachable[0x206]);
+	}
+}
+
+TEST_CASE("AOT code generator")
+{
+	const auto content = helpers::to_rom_content(loop_program);
+	const auto generated = aot::generate_program("loop", std::as_bytes(std::span{content}));
+	REQUIRE_EQ(generated.block_count, 4);
+	REQUIRE_EQ(generated.reachable_instruction_count, 9);
+	REQUIRE_EQ(generated.translated_instruction_count, 6);
+	REQUIRE_EQ(generated.dynamic_jump_count, 0);
+
+	const auto& source = generated.source;
+	REQUIRE_NE(source.find("void block_0x204(registers& regs, [[maybe_unused]] stack_t& stack)"), std::string::npos);
+	REQUIRE_NE(source.find("{0x200, 0x204, 2, &block_0x200},"), std::string::npos);
+	REQUIRE_NE(source.find("{0x210, 0x212, 1, &block_0x210},"), std::string::npos);
+	REQUIRE_NE(source.find("aot::program{\"loop\", rom, blocks}"), std::string::npos);
+
+	// Jump to itself is left for idle loop detection, stack instructions for stack checks of the interpreter
+	REQUIRE_EQ(source.find("block_0x20C"), std::string::npos);
+	REQUIRE_EQ(source.find("block_0x20A"), std::string::npos);
+	REQUIRE_EQ(source.find("instructions::ret"), std::string::npos);
+}
+
+TEST_CASE("AOT engine")
+{
+	SUBCASE("Program lookup")
+	{
+		auto mem = load(loop_program);
+		REQUIRE_EQ(aot::find_program(mem), &find_loop_program());
+		REQUIRE_EQ(find_loop_program().name, "loop");
+		REQUIRE_EQ(find_loop_program().blocks.size(), 4);
+
+		mem[constants::code_start + loop_program.size() * 2] = std::byte{0x01};
+		REQUIRE_EQ(aot::find_program(mem), nullptr);
+	}
+
+	SUBCASE("Invalidation")
+	{
+		auto engine = aot::engine(find_loop_program());
+		auto regs = registers{constants::code_start};
+		auto stack = stack_t{};
+
+		REQUIRE_EQ(engine.execute(regs, stack, unlimited_budget), 2);
+		REQUIRE_EQ(regs.pc, 0x204);
+
+		engine.invalidate(0x206, 1);
+		REQUIRE_EQ(engine.execute(regs, stack, unlimited_budget), 0);
+
+		regs.pc = constants::code_start;
+		REQUIRE_EQ(engine.execute(regs, stack, unlimited_budget), 2);
+
+		engine.invalidate_all();
+		regs.pc = 0x204;
+		REQUIRE_EQ(engine.execute(regs, stack, unlimited_budget), 2);
+		REQUIRE_EQ(regs.pc, 0x208);
+	}
+
+	SUBCASE("Block longer than budget is left for interpreter")
+	{
+		auto engine = aot::engine(find_loop_program());
+		auto regs = registers{constants::code_start};
+		auto stack = stack_t{};
+
+		REQUIRE_EQ(engine.execute(regs, stack, 1), 0);
+		REQUIRE_EQ(regs.pc, constants::code_start);
+		REQUIRE_EQ(engine.execute(regs, stack, 2), 2);
+		REQUIRE_EQ(regs.pc, 0x204);
+	}
+
+	SUBCASE("Matches interpreter")
+	{
+		const auto rom = helpers::make_rom("aot", loop_program);
+		constexpr auto instruction_count = size_t{100};
+
+		auto backend = headless_backend();
+		auto reference = chip8::interpreter(rom.get_path(), backend, 0ns);
+		auto translated = chip8::interpreter(rom.get_path(), backend, 0ns, execution_engine::aot);
+
+		// Requested instruction count is never overrun by a block
+		REQUIRE_EQ(translated.run(1), 1);
+		REQUIRE_EQ(translated.get_registers().pc, 0x202);
+		REQUIRE_EQ(reference.run(1), 1);
+
+		// Single steps are mixed with budgets that fit whole blocks, so both paths are compared
+		for (auto step = size_t{1}; step < instruction_count; ++step)
+		{
+			const auto budget = step % 3 + 1;
+			REQUIRE_EQ(reference.run(budget), budget);
+			REQUIRE_EQ(translated.run(budget), budget);
+
+			const auto& expected = reference.get_registers();
+			const auto& actual = translated.get_registers();
+			REQUIRE_EQ(actual.pc, expected.pc);
+			REQUIRE_EQ(actual.sp, expected.sp);
+			for (auto idx = size_t{0}; idx < constants::v_reg_count; ++idx)
+				REQUIRE_EQ(actual.v[idx], expected.v[idx]);
+		}
+
+		REQUIRE_EQ(translated.get_registers().pc, 0x20C);
+	}
+}
@@ -0,0 +1,165 @@
+#include "doctest.h"
+#include "test_helpers.hpp"
+
+#include "batch/job.hpp"
+#include "batch/runner.hpp"
+#include "batch/work_stealing_pool.hpp"
+
+#include <atomic>
+#include <memory>
+
+using namespace chip8;
+
+namespace
+{
+	// Ten instructions per timer tick
+	constexpr auto machine_tick_period = constants::timer_tick_freq / 10;
+}
+
+TEST_CASE("Work stealing pool" *
+	doctest::description("Tests that every task is executed exactly once by a valid worker"))
+{
+	static constexpr auto task_count = size_t{1000};
+
+	for (const auto worker_count : {size_t{1}, size_t{2}, size_t{7}})
+	{
+		auto pool = batch::work_stealing_pool(worker_count);
+		REQUIRE_EQ(pool.get_worker_count(), worker_count);
+
+		auto execution_counts = std::make_unique<std::atomic<size_t>[]>(task_count);
+		auto invalid_worker_count = std::atomic<size_t>{0};
+
+		auto tasks = std::vector<batch::work_stealing_pool::task>{};
+		for (size_t idx = 0; idx < task_count; ++idx)
+		{
+			tasks.emplace_back([&, idx](size_t worker_idx)
+			{
+				++execution_counts[idx];
+				if (worker_idx >= worker_count)
+					++invalid_worker_count;
+			});
+		}
+
+		pool.run(std::move(tasks));
+
+		for (size_t idx = 0; idx < task_count; ++idx)
+			REQUIRE_EQ(execution_counts[idx].load(), 1);
+		REQUIRE_EQ(invalid_worker_count.load(), 0);
+	}
+}
+
+TEST_CASE("Batch job files")
+{
+	const auto rom = helpers::make_rom("batch", {0x1200});
+
+	SUBCASE("Jobs with and without input")
+	{
+		const auto script = helpers::temporary_file("chip8_cpp_batch_test.input",
+			"# Comment\n10 a down\n\n20 A up\n");
+		const auto job_file = helpers::temporary_file("chip8_cpp_batch_test.jobs",
+			"chip8_cpp_batch_test.ch8 100\n# Comment\nchip8_cpp_batch_test.ch8 200 chip8_cpp_batch_test.input\n");
+
+		const auto jobs = batch::load_jobs(job_file.get_path());
+		REQUIRE_EQ(jobs.size(), 2);
+		REQUIRE_EQ(jobs[0].rom_path, rom.get_path());
+		REQUIRE_EQ(jobs[0].instruction_count, 100);
+		REQUIRE(jobs[0].input.empty());
+
+		REQUIRE_EQ(jobs[1].instruction_count, 200);
+		REQUIRE_EQ(jobs[1].input.size(), 2);
+		REQUIRE_EQ(jobs[1].input[0].instruction, 10);
+		REQUIRE_EQ(jobs[1].input[0].key, 0xA);
+		REQUIRE(jobs[1].input[0].is_pressed);
+		REQUIRE_EQ(jobs[1].input[1].instruction, 20);
+		REQUIRE_FALSE(jobs[1].input[1].is_pressed);
+	}
+
+	SUBCASE("Malformed input script")
+	{
+		const auto script = helpers::temporary_file("chip8_cpp_batch_test.input", "10 1F down\n");
+		REQUIRE_THROWS(static_cast<void>(batch::load_input_script(script.get_path())));
+	}
+
+	SUBCASE("Input script out of order")
+	{
+		const auto script = helpers::temporary_file("chip8_cpp_batch_test.input", "10 1 down\n5 1 up\n");
+		REQUIRE_THROWS(static_cast<void>(batch::load_input_script(script.get_path())));
+	}
+}
+
+TEST_CASE("Batch runner" *
+	doctest::description("Runs jobs on several workers and checks that failures are reported per job"))
+{
+	// LD V0, 0x01; SKP V0; JP 0x202; JP 0x206
+	const auto waiting_rom = helpers::make_rom("batch_wait", {0x6001, 0xE09E, 0x1202, 0x1206});
+	const auto illegal_rom = helpers::make_rom("batch_illegal", {0x0000});
+
+	auto jobs = std::vector<batch::job>{};
+	for (size_t idx = 0; idx < 16; ++idx)
+		jobs.push_back(batch::job{waiting_rom.get_path(), 1000, {}});
+	jobs.push_back(batch::job{waiting_rom.get_path(), 1000, {{50, 0x1, true}}});
+	jobs.push_back(batch::job{illegal_rom.get_path(), 1000, {}});
+
+	const auto report = batch::run_jobs(jobs, 3, execution_engine::interpreter, machine_tick_period);
+	REQUIRE_EQ(report.results.size(), jobs.size());
+	REQUIRE_EQ(report.executed_instructions_per_worker.size(), 3);
+
+	for (size_t idx = 0; idx < 17; ++idx)
+	{
+		REQUIRE(report.results[idx].error.empty());
+		REQUIRE_EQ(report.results[idx].machine_ticks, 1000);
+	}
+
+	for (size_t idx = 0; idx < 16; ++idx)
+		REQUIRE_EQ(report.results[idx].executed_instructions, 1000);
+
+	// Pressed key ends polling, after which the machine idles in a jump to itself
+	REQUIRE_GE(report.results[16].executed_instructions, 50);
+	REQUIRE_LT(report.results[16].executed_instructions, 60);
+
+	REQUIRE_FALSE(report.results[17].error.empty());
+	REQUIRE_EQ(report.results[17].fault_count, 1);
+	REQUIRE_EQ(report.executed_instructions, 16 * 1000 + report.results[16].executed_instructions);
+
+	SUBCASE("Skipping faults")
+	{
+		// Illegal instruction is skipped on every pass through memory
+		const auto skipping_report = batch::run_jobs(jobs, 3, execution_engine::interpreter, machine_tick_period, 0,
+			fault_policy::skip);
+		REQUIRE(skipping_report.results[17].error.empty());
+		REQUIRE_EQ(skipping_report.results[17].machine_ticks, 1000);
+		REQUIRE_GT(skipping_report.results[17].fault_count, 0);
+	}
+}
+
+TEST_CASE("Batch timers" *
+	doctest::description("Delay timer follows machine time, so jobs reach it after the same instruction on every run"))
+{
+	// LD V0, 0x02; LD DT, V0; LD V1, DT; SE V1, 0x00; JP 0x204; illegal instruction once the timer expires
+	const auto timer_rom = helpers::make_rom("batch_timer", {0x6002, 0xF015, 0xF107, 0x3100, 0x1204, 0x0000});
+
+	auto jobs = std::vector<batch::job>{};
+	for (size_t idx = 0; idx < 8; ++idx)
+		jobs.push_back(batch::job{timer_rom.get_path(), 1000, {}});
+	jobs.push_back(batch::job{timer_rom.get_path(), 10, {}});
+
+	const auto first_report = batch::run_jobs(jobs, 3, execution_engine::interpreter, machine_tick_period);
+	const auto faulting_instruction = first_report.results[0].machine_ticks;
+
+	// Timer expires after two timer ticks, which is 20 instructions, and the loop leaves on its next pass
+	REQUIRE_GE(faulting_instruction, 20);
+	REQUIRE_LT(faulting_instruction, 30);
+
+	for (size_t run = 0; run < 2; ++run)
+	{
+		const auto report = batch::run_jobs(jobs, 3, execution_engine::interpreter, machine_tick_period);
+		for (size_t idx = 0; idx < 8; ++idx)
+		{
+			REQUIRE_FALSE(report.results[idx].error.empty());
+			REQUIRE_EQ(report.results[idx].machine_ticks, faulting_instruction);
+		}
+
+		REQUIRE(report.results[8].error.empty());
+		REQUIRE_EQ(report.results[8].machine_ticks, 10);
+	}
+}
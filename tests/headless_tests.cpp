@@ -0,0 +1,942 @@
+#include "doctest.h"
+#include "test_helpers.hpp"
+
+#include "framebuffer.hpp"
+#include "interpreter.hpp"
+#include "io/headless_backend.hpp"
+
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace chip8;
+
+namespace
+{
+	auto get_available_engines()
+	{
+		auto engines = std::vector<execution_engine>{execution_engine::interpreter};
+		if (is_threaded_dispatch_available)
+			engines.push_back(execution_engine::threaded);
+#ifdef CHIP8_ENABLE_SPECIALIZED_DISPATCH
+		engines.push_back(execution_engine::specialized);
+#endif
+#ifdef CHIP8_ENABLE_JIT
+		engines.push_back(execution_engine::jit);
+#endif
+		return engines;
+	}
+}
+
+TEST_CASE("Headless execution" *
+	doctest::description("Runs a rom with every available execution engine without any host devices"))
+{
+	// LD V0, 0x05; ADD V0, 0x03; LD I, 0x300; JP 0x206
+	const auto rom = helpers::make_rom("headless", {0x6005, 0x7003, 0xA300, 0x1206});
+
+	for (const auto engine : get_available_engines())
+	{
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine);
+
+		REQUIRE_EQ(interpreter.run(100), 100);
+		REQUIRE_EQ(interpreter.get_registers().v[0], std::byte{0x08});
+		REQUIRE_EQ(interpreter.get_registers().i, 0x300);
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x206);
+	}
+}
+
+TEST_CASE("Computed jump" *
+	doctest::description("JP V0, addr lands on nnn + V0 with every execution engine"))
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6002, // 0x200: LD V0, 0x02
+		0xB206, // 0x202: JP V0, 0x206
+		0x0000, // 0x204: data
+		0x0000, // 0x206: data
+		0x7101, // 0x208: ADD V1, 0x01
+		0x120A  // 0x20A: JP 0x20A
+	});
+
+	for (const auto engine : get_available_engines())
+	{
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine);
+
+		REQUIRE_EQ(interpreter.run(10), 10);
+		REQUIRE_EQ(interpreter.get_registers().v[1], std::byte{0x01});
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x20A);
+		REQUIRE_EQ(interpreter.get_last_fault().kind, fault::none);
+	}
+}
+
+TEST_CASE("Faults" *
+	doctest::description("Faulting instructions are handled by fault policy without exceptions"))
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6001, // 0x200: LD V0, 0x01
+		0xAFFF, // 0x202: LD I, 0xFFF
+		0xF155, // 0x204: LD [I], V1 - past the end of memory
+		0x7001, // 0x206: ADD V0, 0x01
+		0x0000, // 0x208: illegal
+		0x7001, // 0x20A: ADD V0, 0x01
+		0x120C  // 0x20C: JP 0x20C
+	});
+
+	for (const auto engine : get_available_engines())
+	{
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine);
+		REQUIRE_EQ(interpreter.get_fault_policy(), fault_policy::halt);
+
+		SUBCASE("Halt")
+		{
+			REQUIRE_EQ(interpreter.run(100), 2);
+			REQUIRE(interpreter.is_faulted());
+			REQUIRE_EQ(interpreter.get_registers().pc, 0x204);
+
+			const auto& status = interpreter.get_last_fault();
+			REQUIRE_EQ(status.kind, fault::memory_access);
+			REQUIRE_EQ(status.pc, 0x204);
+			REQUIRE_EQ(status.instruction[0], std::byte{0xF1});
+			REQUIRE_EQ(status.instruction[1], std::byte{0x55});
+			REQUIRE_EQ(describe_fault(status), "Invalid memory access 0xf155 at 0x204");
+
+			REQUIRE_EQ(interpreter.run(100), 0);
+			REQUIRE_EQ(interpreter.get_fault_count(), 1);
+
+			interpreter.reset(rom.get_path());
+			REQUIRE_FALSE(interpreter.is_faulted());
+			REQUIRE_EQ(interpreter.get_last_fault().kind, fault::none);
+			REQUIRE_EQ(interpreter.get_fault_count(), 0);
+		}
+
+		SUBCASE("Trap")
+		{
+			interpreter.set_fault_policy(fault_policy::trap);
+			REQUIRE_EQ(interpreter.run(100), 2);
+			REQUIRE(interpreter.is_faulted());
+
+			// Faulting instruction is executed again and traps again
+			REQUIRE_EQ(interpreter.run(100), 0);
+			REQUIRE_EQ(interpreter.get_fault_count(), 2);
+
+			interpreter.set_fault_policy(fault_policy::skip);
+			REQUIRE_EQ(interpreter.run(4), 4);
+			REQUIRE_FALSE(interpreter.is_faulted());
+			REQUIRE_EQ(interpreter.get_registers().v[0], std::byte{0x03});
+			REQUIRE_EQ(interpreter.get_registers().pc, 0x20C);
+			REQUIRE_EQ(interpreter.get_fault_count(), 4);
+		}
+
+		SUBCASE("Skip")
+		{
+			interpreter.set_fault_policy(fault_policy::skip);
+			REQUIRE_EQ(interpreter.run(100), 100);
+			REQUIRE_FALSE(interpreter.is_faulted());
+			REQUIRE_EQ(interpreter.get_registers().v[0], std::byte{0x03});
+			REQUIRE_EQ(interpreter.get_registers().v[1], std::byte{0x00});
+			REQUIRE_EQ(interpreter.get_fault_count(), 2);
+			REQUIRE_EQ(interpreter.get_last_fault().kind, fault::illegal_instruction);
+			REQUIRE_EQ(interpreter.get_last_fault().pc, 0x208);
+		}
+	}
+
+	SUBCASE("PC out of range")
+	{
+		// JP 0xFFF
+		const auto jump_rom = helpers::make_rom("headless_jump", {0x1FFF});
+		for (const auto engine : get_available_engines())
+		{
+			auto backend = headless_backend();
+			auto interpreter = chip8::interpreter(jump_rom.get_path(), backend, 0ns, engine);
+			interpreter.set_fault_policy(fault_policy::skip);
+
+			// There is no instruction to skip, so even skipping machine stops
+			REQUIRE_EQ(interpreter.run(10), 1);
+			REQUIRE(interpreter.is_faulted());
+			REQUIRE_EQ(interpreter.get_last_fault().kind, fault::pc_out_of_range);
+			REQUIRE_EQ(describe_fault(interpreter.get_last_fault()), "PC out of range at 0xfff");
+		}
+	}
+}
+
+TEST_CASE("Stack faults" *
+	doctest::description("CALL with a full stack and RET with an empty one fault instead of corrupting memory"))
+{
+	// Both roms are loaded at once, so they need files of their own
+	const auto overflow_rom = helpers::make_rom("stack_overflow", {
+		0x7001, // 0x200: ADD V0, 0x01
+		0x2200, // 0x202: CALL 0x200 - recurses until the stack is full
+		0x7101, // 0x204: ADD V1, 0x01
+		0x1206  // 0x206: JP 0x206
+	});
+
+	const auto underflow_rom = helpers::make_rom("stack_underflow", {
+		0x6001, // 0x200: LD V0, 0x01
+		0x00EE, // 0x202: RET - with nothing to return to
+		0x7001, // 0x204: ADD V0, 0x01
+		0x1206  // 0x206: JP 0x206
+	});
+
+	// Sixteen rounds of ADD and CALL fill the stack, ADD of the next round is the last executed instruction
+	constexpr auto overflow_executed = 2 * constants::stack_size + 1;
+
+	for (const auto engine : get_available_engines())
+	{
+		auto overflow_backend = headless_backend();
+		auto overflow = chip8::interpreter(overflow_rom.get_path(), overflow_backend, 0ns, engine);
+		auto underflow_backend = headless_backend();
+		auto underflow = chip8::interpreter(underflow_rom.get_path(), underflow_backend, 0ns, engine);
+
+		SUBCASE("Halt")
+		{
+			REQUIRE_EQ(overflow.run(100), overflow_executed);
+			REQUIRE(overflow.is_faulted());
+			REQUIRE_EQ(overflow.get_registers().sp, int(constants::stack_size) - 1);
+			REQUIRE_EQ(overflow.get_registers().v[0], std::byte{0x11});
+			REQUIRE_EQ(describe_fault(overflow.get_last_fault()), "Stack overflow 0x2200 at 0x202");
+			REQUIRE_EQ(overflow.run(100), 0);
+
+			REQUIRE_EQ(underflow.run(100), 1);
+			REQUIRE(underflow.is_faulted());
+			REQUIRE_EQ(underflow.get_registers().sp, -1);
+			REQUIRE_EQ(describe_fault(underflow.get_last_fault()), "Stack underflow 0x00ee at 0x202");
+			REQUIRE_EQ(underflow.run(100), 0);
+		}
+
+		SUBCASE("Trap")
+		{
+			overflow.set_fault_policy(fault_policy::trap);
+			REQUIRE_EQ(overflow.run(100), overflow_executed);
+			REQUIRE_EQ(overflow.run(100), 0);
+			REQUIRE_EQ(overflow.get_fault_count(), 2);
+			REQUIRE_EQ(overflow.get_last_fault().kind, fault::stack_overflow);
+			REQUIRE_EQ(overflow.get_registers().pc, 0x202);
+
+			underflow.set_fault_policy(fault_policy::trap);
+			REQUIRE_EQ(underflow.run(100), 1);
+			REQUIRE_EQ(underflow.run(100), 0);
+			REQUIRE_EQ(underflow.get_fault_count(), 2);
+			REQUIRE_EQ(underflow.get_last_fault().kind, fault::stack_underflow);
+			REQUIRE_EQ(underflow.get_registers().pc, 0x202);
+		}
+
+		SUBCASE("Skip")
+		{
+			overflow.set_fault_policy(fault_policy::skip);
+			REQUIRE_EQ(overflow.run(100), 100);
+			REQUIRE_FALSE(overflow.is_faulted());
+			REQUIRE_EQ(overflow.get_fault_count(), 1);
+			REQUIRE_EQ(overflow.get_registers().sp, int(constants::stack_size) - 1);
+			REQUIRE_EQ(overflow.get_registers().v[1], std::byte{0x01});
+			REQUIRE_EQ(overflow.get_registers().pc, 0x206);
+
+			underflow.set_fault_policy(fault_policy::skip);
+			REQUIRE_EQ(underflow.run(100), 100);
+			REQUIRE_FALSE(underflow.is_faulted());
+			REQUIRE_EQ(underflow.get_fault_count(), 1);
+			REQUIRE_EQ(underflow.get_registers().sp, -1);
+			REQUIRE_EQ(underflow.get_registers().v[0], std::byte{0x02});
+			REQUIRE_EQ(underflow.get_registers().pc, 0x206);
+		}
+	}
+}
+
+TEST_CASE("Batch size" *
+	doctest::description("Instruction limit is honoured regardless of how many instructions run per batch"))
+{
+	// ADD V0, 0x01; JP 0x200
+	const auto rom = helpers::make_rom("headless", {0x7001, 0x1200});
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+	REQUIRE_EQ(interpreter.get_batch_size(), interpreter::default_batch_size);
+	REQUIRE_THROWS_AS(interpreter.set_batch_size(0), std::invalid_argument);
+
+	for (const auto batch_size : {size_t{1}, size_t{7}, size_t{1000}})
+	{
+		interpreter.reset(rom.get_path());
+		interpreter.set_batch_size(batch_size);
+		REQUIRE_EQ(interpreter.run(101), 101);
+		REQUIRE_EQ(interpreter.get_registers().v[0], std::byte{51});
+	}
+}
+
+TEST_CASE("Virtual time" *
+	doctest::description("Timers follow executed instructions instead of host clock"))
+{
+	// LD V0, 0x3C; LD DT, V0; LD V1, DT; SE V1, 0x00; JP 0x204; JP 0x20A
+	const auto rom = helpers::make_rom("headless", {0x603C, 0xF015, 0xF107, 0x3100, 0x1204, 0x120A});
+	constexpr auto tick_period = std::chrono::duration_cast<std::chrono::nanoseconds>(1s) / 600;
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+	REQUIRE_THROWS_AS(interpreter.set_clock_source(clock_source::virtual_time), std::invalid_argument);
+
+	SUBCASE("Runs faster than real time")
+	{
+		// Delay timer needs a second of machine time to reach zero
+		auto virtual_interpreter = chip8::interpreter(rom.get_path(), backend, tick_period);
+		virtual_interpreter.set_clock_source(clock_source::virtual_time);
+
+		const auto start_time = std::chrono::steady_clock::now();
+		REQUIRE_EQ(virtual_interpreter.run(1000), 1000);
+		REQUIRE_LT(std::chrono::steady_clock::now() - start_time, 500ms);
+		REQUIRE_EQ(virtual_interpreter.get_registers().pc, 0x20A);
+		REQUIRE_EQ(virtual_interpreter.get_registers().delay, 0);
+	}
+
+	SUBCASE("Batch size does not change results")
+	{
+		auto results = std::vector<uint8_t>{};
+		for (const auto batch_size : {size_t{1}, size_t{5}, size_t{64}})
+		{
+			auto virtual_interpreter = chip8::interpreter(rom.get_path(), backend, tick_period);
+			virtual_interpreter.set_clock_source(clock_source::virtual_time);
+			virtual_interpreter.set_batch_size(batch_size);
+			REQUIRE_EQ(virtual_interpreter.run(301), 301);
+			results.push_back(virtual_interpreter.get_registers().delay);
+		}
+
+		REQUIRE_EQ(results[0], results[1]);
+		REQUIRE_EQ(results[0], results[2]);
+		REQUIRE_GE(results[0], 29);
+		REQUIRE_LE(results[0], 31);
+	}
+}
+
+TEST_CASE("Headless backend")
+{
+	SUBCASE("Stop request")
+	{
+		const auto rom = helpers::make_rom("headless", {0x1200});
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+
+		backend.request_stop();
+		REQUIRE_EQ(interpreter.run(), 0);
+	}
+
+	SUBCASE("Frames are counted")
+	{
+		// CLS; CLS; JP 0x204
+		const auto rom = helpers::make_rom("headless", {0x00E0, 0x00E0, 0x1204});
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+
+		static_cast<void>(interpreter.run(10));
+		REQUIRE_EQ(backend.get_frame_count(), 2);
+	}
+
+	SUBCASE("Coalesced frames")
+	{
+		// CLS; CLS; JP 0x204
+		const auto rom = helpers::make_rom("headless", {0x00E0, 0x00E0, 0x1204});
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, execution_engine::interpreter,
+			presentation_mode::coalesced);
+
+		// Run ends well within a single frame, so only the pending frame is presented
+		static_cast<void>(interpreter.run(10));
+		REQUIRE_EQ(backend.get_frame_count(), 1);
+
+		static_cast<void>(interpreter.run(10));
+		REQUIRE_EQ(backend.get_frame_count(), 1);
+	}
+
+	SUBCASE("Programmatic input")
+	{
+		// LD V0, 0x07; SKP V0; JP 0x204; JP 0x206
+		const auto rom = helpers::make_rom("headless", {0x6007, 0xE09E, 0x1204, 0x1206});
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+
+		SUBCASE("Key released")
+		{
+			static_cast<void>(interpreter.run(10));
+			REQUIRE_EQ(interpreter.get_registers().pc, 0x204);
+		}
+
+		SUBCASE("Key pressed")
+		{
+			backend.press_key(0x7);
+			static_cast<void>(interpreter.run(10));
+			REQUIRE_EQ(interpreter.get_registers().pc, 0x206);
+		}
+	}
+
+	SUBCASE("Sound")
+	{
+		// LD V0, 0x10; LD ST, V0; JP 0x204
+		const auto rom = helpers::make_rom("headless", {0x6010, 0xF018, 0x1204});
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+
+		static_cast<void>(interpreter.run(10));
+		REQUIRE(backend.is_sound_playing());
+		REQUIRE_EQ(interpreter.get_registers().sound, 0x10);
+	}
+
+	SUBCASE("Sound stops at timer deadline")
+	{
+		// LD V0, 0x02; LD ST, V0; JP 0x204
+		const auto rom = helpers::make_rom("headless", {0x6002, 0xF018, 0x1204});
+		constexpr auto tick_period = constants::timer_tick_freq / 10;
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, tick_period);
+		interpreter.set_clock_source(clock_source::virtual_time);
+
+		static_cast<void>(interpreter.run(15));
+		REQUIRE(backend.is_sound_playing());
+		REQUIRE_EQ(interpreter.get_registers().sound, 1);
+
+		static_cast<void>(interpreter.run(10));
+		REQUIRE_FALSE(backend.is_sound_playing());
+		REQUIRE_EQ(interpreter.get_registers().sound, 0);
+		REQUIRE_EQ(interpreter.get_missed_timer_tick_count(), 0);
+	}
+}
+
+TEST_CASE_TEMPLATE("Key wait" *
+	doctest::description("LD Vx, K stops execution until a key is pressed while timers keep running"),
+	engine_type, std::integral_constant<execution_engine, execution_engine::interpreter>,
+	std::integral_constant<execution_engine, execution_engine::threaded>,
+	std::integral_constant<execution_engine, execution_engine::specialized>)
+{
+	// LD V0, 0x02; LD DT, V0; LD V1, K; LD V2, DT; ADD V3, 0x01; JP 0x208
+	const auto rom = helpers::make_rom("headless", {0x6002, 0xF015, 0xF10A, 0xF207, 0x7301, 0x1208});
+	constexpr auto tick_period = constants::timer_tick_freq / 10;
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, tick_period, engine_type::value);
+	interpreter.set_clock_source(clock_source::virtual_time);
+
+	REQUIRE_EQ(interpreter.run(50), 50);
+	REQUIRE_EQ(interpreter.get_registers().pc, 0x204);
+	REQUIRE_EQ(interpreter.get_registers().delay, 0);
+	REQUIRE_EQ(interpreter.get_key_wait_tick_count(), 47);
+
+	backend.press_key(0xB);
+	REQUIRE_EQ(interpreter.run(3), 3);
+	const auto& regs = interpreter.get_registers();
+	REQUIRE_EQ(regs.v[1], std::byte{0xB});
+	REQUIRE_EQ(regs.v[2], std::byte{0x00});
+	REQUIRE_EQ(regs.v[3], std::byte{0x01});
+}
+
+TEST_CASE("Key wait pacing" *
+	doctest::description("Time blocked on input in LD Vx, K is accounted as sleep by the scheduler"))
+{
+	// Blocks for the whole timeout and presses key 5 after a few waits
+	struct blocking_backend final : backend
+	{
+		void draw(const framebuffer_t&) override {}
+		void play_sound() noexcept override {}
+		void pause_sound() noexcept override {}
+
+		bool process_events(keyboard_state& keys) override
+		{
+			if (wait_count >= 3)
+				keys = keyboard_state(1 << 5);
+			return true;
+		}
+
+		void wait_for_events(std::chrono::nanoseconds timeout) override
+		{
+			++wait_count;
+			std::this_thread::sleep_for(timeout);
+		}
+
+		size_t wait_count = 0;
+	};
+
+	// LD V0, K; ADD V1, 0x01; JP 0x202
+	const auto rom = helpers::make_rom("headless", {0xF00A, 0x7101, 0x1202});
+	auto backend = blocking_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 1ms);
+
+	static_cast<void>(interpreter.run(100));
+	REQUIRE_EQ(backend.wait_count, 3);
+	REQUIRE_EQ(interpreter.get_registers().v[0], std::byte{0x5});
+
+	// Blocked frames are neither late nor busy
+	const auto& stats = interpreter.get_scheduler_statistics();
+	REQUIRE_LT(stats.max_lateness, constants::frame_period);
+	REQUIRE_GE(stats.sleep_time, 3 * constants::frame_period);
+	REQUIRE_LT(stats.get_cpu_utilisation(), 0.5);
+}
+
+TEST_CASE_TEMPLATE("Idle loops" *
+	doctest::description("Loops that only wait for timers are skipped without changing results"),
+	engine_type, std::integral_constant<execution_engine, execution_engine::interpreter>,
+	std::integral_constant<execution_engine, execution_engine::threaded>,
+	std::integral_constant<execution_engine, execution_engine::specialized>,
+	std::integral_constant<execution_engine, execution_engine::jit>)
+{
+	auto backend = headless_backend();
+
+	SUBCASE("Jump to itself")
+	{
+		const auto rom = helpers::make_rom("headless", {0x1200});
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, constants::timer_tick_freq / 10,
+			engine_type::value);
+		interpreter.set_clock_source(clock_source::virtual_time);
+
+		REQUIRE_EQ(interpreter.run(10000), 10000);
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x200);
+		REQUIRE_EQ(interpreter.get_skipped_tick_count(), 9999);
+	}
+
+	SUBCASE("Delay timer polling")
+	{
+		// LD V0, 0x05; LD DT, V0; LD V1, DT; SE V1, 0x00; JP 0x204; ADD V2, 0x01; JP 0x20A
+		const auto rom = helpers::make_rom("headless", {0x6005, 0xF015, 0xF107, 0x3100, 0x1204, 0x7201, 0x120C});
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, constants::timer_tick_freq / 2,
+			engine_type::value);
+		interpreter.set_clock_source(clock_source::virtual_time);
+
+		// Delay timer reaches zero after 5 timer ticks, when 10 instructions were executed. Loop is then
+		// at its jump and needs three more instructions to reach ADD
+		REQUIRE_EQ(interpreter.run(13), 13);
+		REQUIRE_EQ(interpreter.get_registers().v[2], std::byte{0x00});
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x20A);
+		REQUIRE_EQ(interpreter.get_skipped_tick_count(), 7);
+
+		REQUIRE_EQ(interpreter.run(1), 1);
+		REQUIRE_EQ(interpreter.get_registers().v[2], std::byte{0x01});
+	}
+}
+
+TEST_CASE_TEMPLATE("Fused instructions" *
+	doctest::description("Fused instruction pairs give the same results and instruction counts as single ones"),
+	engine_type, std::integral_constant<execution_engine, execution_engine::interpreter>,
+	std::integral_constant<execution_engine, execution_engine::threaded>)
+{
+	auto backend = headless_backend();
+
+	const auto get_fusion_count = [](const chip8::interpreter& interpreter, opcode op)
+	{
+		return interpreter.get_fusion_counts()[get_fused_opcode_index(op)];
+	};
+
+	SUBCASE("Every fusion")
+	{
+		const auto rom = helpers::make_rom("headless", {
+			0x2206, // 0x200: CALL 0x206
+			0x2206, // 0x202: CALL 0x206
+			0x1204, // 0x204: JP 0x204
+			0x6100, // 0x206: LD V1, 0x00
+			0x6005, // 0x208: LD V0, 0x05
+			0x8104, // 0x20A: ADD V1, V0
+			0x3105, // 0x20C: SE V1, 0x05
+			0x1200, // 0x20E: JP 0x200
+			0x4105, // 0x210: SNE V1, 0x05
+			0x1216, // 0x212: JP 0x216
+			0x0000, // 0x214: data
+			0xA224, // 0x216: LD I, 0x224
+			0xD015, // 0x218: DRW V0, V1, 5
+			0xF21E, // 0x21A: ADD I, V2
+			0xF165, // 0x21C: LD V1, [I]
+			0x00EE, // 0x21E: RET
+			0x0000, 0x0000, // 0x220: data
+			0xF090, 0x9090, 0xF000 // 0x224: sprite
+		});
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+
+		// Pairs are fused when first decoded and executed fused from the second call on
+		REQUIRE_EQ(interpreter.run(24), 24);
+		const auto& regs = interpreter.get_registers();
+		REQUIRE_EQ(regs.pc, 0x204);
+		REQUIRE_EQ(regs.i, 0x224);
+		REQUIRE_EQ(regs.v[0x0], std::byte{0xF0});
+		REQUIRE_EQ(regs.v[0x1], std::byte{0x90});
+		REQUIRE_EQ(regs.v[0xF], std::byte{0x01});
+		REQUIRE_FALSE(framebuffer::get_pixel(interpreter.get_video_memory(), 5, 5));
+
+		// Skip taken by SE leaves its jump unexecuted, so that pair doesn't count
+		REQUIRE_EQ(get_fusion_count(interpreter, opcode::ld_reg_byte_add_reg_reg), 1);
+		REQUIRE_EQ(get_fusion_count(interpreter, opcode::se_reg_byte_jp), 0);
+		REQUIRE_EQ(get_fusion_count(interpreter, opcode::sne_reg_byte_jp), 1);
+		REQUIRE_EQ(get_fusion_count(interpreter, opcode::ld_i_addr_drw), 1);
+		REQUIRE_EQ(get_fusion_count(interpreter, opcode::add_i_reg_str_reg_i), 1);
+	}
+
+	SUBCASE("Instruction limit splits pairs")
+	{
+		// LD V0, 0x05; ADD V1, V0; JP 0x200
+		const auto rom = helpers::make_rom("headless", {0x6005, 0x8104, 0x1200});
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+		REQUIRE_EQ(interpreter.run(3), 3);
+
+		REQUIRE_EQ(interpreter.run(1), 1);
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x202);
+		REQUIRE_EQ(interpreter.get_registers().v[1], std::byte{0x05});
+
+		REQUIRE_EQ(interpreter.run(1), 1);
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x204);
+		REQUIRE_EQ(interpreter.get_registers().v[1], std::byte{0x0A});
+		REQUIRE_EQ(get_fusion_count(interpreter, opcode::ld_reg_byte_add_reg_reg), 0);
+
+		REQUIRE_EQ(interpreter.run(3), 3);
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x204);
+		REQUIRE_EQ(get_fusion_count(interpreter, opcode::ld_reg_byte_add_reg_reg), 1);
+	}
+
+	SUBCASE("Writes to the second instruction")
+	{
+		const auto rom = helpers::make_rom("headless", {
+			0x6501, // 0x200: LD V5, 0x01
+			0x8654, // 0x202: ADD V6, V5
+			0x6076, // 0x204: LD V0, 0x76
+			0x6110, // 0x206: LD V1, 0x10
+			0xA202, // 0x208: LD I, 0x202
+			0xF155, // 0x20A: LD [I], V1 - replaces ADD V6, V5 with ADD V6, 0x10
+			0x1200  // 0x20C: JP 0x200
+		});
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+
+		REQUIRE_EQ(interpreter.run(9), 9);
+		REQUIRE_EQ(interpreter.get_registers().v[6], std::byte{0x11});
+	}
+}
+
+TEST_CASE_TEMPLATE("Lazy flags" *
+	doctest::description("Deferring VF gives the same results as computing it on every ALU instruction"),
+	engine_type, std::integral_constant<execution_engine, execution_engine::interpreter>,
+	std::integral_constant<execution_engine, execution_engine::threaded>)
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6005, // 0x200: LD V0, 0x05
+		0x61FB, // 0x202: LD V1, 0xFB
+		0x8014, // 0x204: ADD V0, V1
+		0x8205, // 0x206: SUB V2, V0
+		0x8F20, // 0x208: LD VF, V2
+		0x8316, // 0x20A: SHR V3, V1
+		0x4F01, // 0x20C: SNE VF, 0x01
+		0x7401, // 0x20E: ADD V4, 0x01
+		0x8417, // 0x210: SUBN V4, V1
+		0x851E, // 0x212: SHL V5, V1
+		0x85F4, // 0x214: ADD V5, VF
+		0x8F14, // 0x216: ADD VF, V1
+		0x8614, // 0x218: ADD V6, V1
+		0xA300, // 0x21A: LD I, 0x300
+		0xFF55, // 0x21C: LD [I], VF
+		0x8714, // 0x21E: ADD V7, V1
+		0x1200  // 0x220: JP 0x200
+	});
+
+	auto backend = headless_backend();
+	auto eager = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+	auto lazy = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+	lazy.set_flag_evaluation(flag_evaluation::lazy);
+	REQUIRE_EQ(lazy.get_flag_evaluation(), flag_evaluation::lazy);
+
+	// VF is materialized whenever run returns, so runs of every length see the same registers
+	for (const auto step_count : {1, 2, 3, 5, 7, 11, 100})
+	{
+		REQUIRE_EQ(eager.run(step_count), step_count);
+		REQUIRE_EQ(lazy.run(step_count), step_count);
+
+		const auto& expected = eager.get_registers();
+		const auto& actual = lazy.get_registers();
+		REQUIRE_EQ(actual.pc, expected.pc);
+		REQUIRE_EQ(actual.i, expected.i);
+		for (auto idx = size_t{0}; idx < constants::v_reg_count; ++idx)
+			REQUIRE_EQ(actual.v[idx], expected.v[idx]);
+	}
+
+	// Switching back materializes the pending flag and keeps running from the same state
+	lazy.set_flag_evaluation(flag_evaluation::eager);
+	REQUIRE_EQ(eager.run(50), 50);
+	REQUIRE_EQ(lazy.run(50), 50);
+	REQUIRE_EQ(lazy.get_registers().v[0xF], eager.get_registers().v[0xF]);
+	REQUIRE_EQ(lazy.get_registers().v[0x7], eager.get_registers().v[0x7]);
+}
+
+TEST_CASE_TEMPLATE("Lazy flags with computed jump" *
+	doctest::description("JP VF, addr jumps with VF of a deferred ALU instruction in profiles jumping to xnn + Vx"),
+	engine_type, std::integral_constant<execution_engine, execution_engine::interpreter>,
+	std::integral_constant<execution_engine, execution_engine::threaded>)
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6F00, // 0x200: LD VF, 0x00
+		0x60FF, // 0x202: LD V0, 0xFF
+		0x6101, // 0x204: LD V1, 0x01
+		0x8014, // 0x206: ADD V0, V1 - VF is 0x01, V0 is 0x00
+		0xBF10  // 0x208: JP VF, 0xF10 - JP V0, 0xF10 when jumping to nnn + V0
+	});
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+	interpreter.set_flag_evaluation(flag_evaluation::lazy);
+	auto expected_pc = uint16_t{0xF11};
+
+	SUBCASE("CHIP-48")
+	{
+		interpreter.set_quirk_profile(quirk_profile::chip48);
+	}
+
+	SUBCASE("SUPER-CHIP")
+	{
+		interpreter.set_quirk_profile(quirk_profile::schip);
+	}
+
+	SUBCASE("Modern")
+	{
+		expected_pc = 0xF10;
+	}
+
+	REQUIRE_EQ(interpreter.run(5), 5);
+	REQUIRE_EQ(interpreter.get_registers().pc, expected_pc);
+}
+
+TEST_CASE_TEMPLATE("Memory models" *
+	doctest::description("Masked memory model wraps I and runs accesses past 0xFFF into the guard band"),
+	engine_type, std::integral_constant<execution_engine, execution_engine::interpreter>,
+	std::integral_constant<execution_engine, execution_engine::threaded>)
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6001, // 0x200: LD V0, 0x01
+		0x6102, // 0x202: LD V1, 0x02
+		0xAFFF, // 0x204: LD I, 0xFFF
+		0xF155, // 0x206: LD [I], V1 - V1 lands in the guard band
+		0x6000, // 0x208: LD V0, 0x00
+		0x6100, // 0x20A: LD V1, 0x00
+		0xF165, // 0x20C: LD V1, [I]
+		0x6201, // 0x20E: LD V2, 0x01
+		0xF21E, // 0x210: ADD I, V2 - I is 0x1000, which is masked to 0x000
+		0xF365, // 0x212: LD V3, [I]
+		0xAFFF, // 0x214: LD I, 0xFFF
+		0xD001, // 0x216: DRW V0, V0, 1
+		0x1200  // 0x218: JP 0x200
+	});
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+	REQUIRE_EQ(interpreter.get_memory_model(), memory_model::strict);
+
+	SUBCASE("Strict")
+	{
+		REQUIRE_EQ(interpreter.run(13), 3);
+		REQUIRE(interpreter.is_faulted());
+		REQUIRE_EQ(interpreter.get_last_fault().kind, fault::memory_access);
+	}
+
+	SUBCASE("Masked")
+	{
+		interpreter.set_memory_model(memory_model::masked);
+		REQUIRE_EQ(interpreter.get_memory_model(), memory_model::masked);
+
+		REQUIRE_EQ(interpreter.run(7), 7);
+		const auto& regs = interpreter.get_registers();
+		REQUIRE_EQ(regs.v[0], std::byte{0x01});
+		REQUIRE_EQ(regs.v[1], std::byte{0x02});
+
+		// "0" is loaded from the font at 0x000, then V0 stored at 0xFFF (0x01) is drawn as a sprite
+		REQUIRE_EQ(interpreter.run(6), 6);
+		REQUIRE_EQ(regs.v[0], std::byte{0xF0});
+		REQUIRE_EQ(regs.v[3], std::byte{0x90});
+		REQUIRE(framebuffer::get_pixel(interpreter.get_video_memory(), 55, 16));
+
+		// Masked memory instructions pair up like checked ones
+		REQUIRE_EQ(interpreter.run(13), 13);
+		REQUIRE_FALSE(framebuffer::get_pixel(interpreter.get_video_memory(), 55, 16));
+		REQUIRE_EQ(interpreter.get_fusion_counts()[get_fused_opcode_index(opcode::ld_i_addr_drw_masked)], 1);
+		REQUIRE_EQ(interpreter.get_fusion_counts()[get_fused_opcode_index(opcode::add_i_reg_str_reg_i_masked)], 1);
+		REQUIRE_EQ(interpreter.get_fault_count(), 0);
+	}
+}
+
+TEST_CASE_TEMPLATE("Quirk profiles" *
+	doctest::description("Shifts, LD [I], Vx, JP V0, addr and sprite edges follow the quirk profile"),
+	engine_type, std::integral_constant<execution_engine, execution_engine::interpreter>,
+	std::integral_constant<execution_engine, execution_engine::threaded>,
+	std::integral_constant<execution_engine, execution_engine::jit>)
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6002, // 0x200: LD V0, 0x02
+		0x6204, // 0x202: LD V2, 0x04
+		0xB208, // 0x204: JP V0, 0x208 - JP V2, 0x208 when jumping to xnn + Vx
+		0x1206, // 0x206: JP 0x206
+		0x1208, // 0x208: JP 0x208
+		0x6401, // 0x20A: LD V4, 0x01
+		0x6105, // 0x20C: LD V1, 0x05
+		0x6280, // 0x20E: LD V2, 0x80
+		0x8216, // 0x210: SHR V2, V1
+		0x663E, // 0x212: LD V6, 0x3E
+		0x671E, // 0x214: LD V7, 0x1E
+		0xF529, // 0x216: LD F, V5
+		0xD675, // 0x218: DRW V6, V7, 5 - "0" at the bottom right corner
+		0xA300, // 0x21A: LD I, 0x300
+		0xF155, // 0x21C: LD [I], V1
+		0x121E  // 0x21E: JP 0x21E
+	});
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine_type::value);
+	REQUIRE_EQ(interpreter.get_quirk_profile(), quirk_profile::modern);
+
+	const auto run = [&interpreter](quirk_profile profile)
+	{
+		interpreter.set_quirk_profile(profile);
+		REQUIRE_EQ(interpreter.get_quirk_profile(), profile);
+		REQUIRE_EQ(interpreter.run(20), 20);
+		REQUIRE_EQ(interpreter.get_registers().pc, 0x21E);
+		return interpreter.get_registers();
+	};
+
+	const auto& frame = interpreter.get_video_memory();
+
+	SUBCASE("VIP")
+	{
+		const auto regs = run(quirk_profile::vip);
+		REQUIRE_EQ(regs.v[4], std::byte{0x01});
+		REQUIRE_EQ(regs.v[2], std::byte{0x02});
+		REQUIRE_EQ(regs.i, 0x302);
+		REQUIRE(framebuffer::get_pixel(frame, 62, 30));
+		REQUIRE_FALSE(framebuffer::get_pixel(frame, 0, 30));
+		REQUIRE_FALSE(framebuffer::get_pixel(frame, 62, 0));
+	}
+
+	SUBCASE("VIP with lazy flags")
+	{
+		interpreter.set_flag_evaluation(flag_evaluation::lazy);
+		const auto regs = run(quirk_profile::vip);
+		REQUIRE_EQ(regs.v[2], std::byte{0x02});
+		REQUIRE_EQ(regs.v[0xF], std::byte{0x00});
+	}
+
+	SUBCASE("CHIP-48")
+	{
+		const auto regs = run(quirk_profile::chip48);
+		REQUIRE_EQ(regs.v[4], std::byte{0x00});
+		REQUIRE_EQ(regs.v[2], std::byte{0x40});
+		REQUIRE_EQ(regs.i, 0x301);
+		REQUIRE_FALSE(framebuffer::get_pixel(frame, 0, 30));
+	}
+
+	SUBCASE("SUPER-CHIP")
+	{
+		const auto regs = run(quirk_profile::schip);
+		REQUIRE_EQ(regs.v[4], std::byte{0x00});
+		REQUIRE_EQ(regs.v[2], std::byte{0x40});
+		REQUIRE_EQ(regs.i, 0x300);
+		REQUIRE_FALSE(framebuffer::get_pixel(frame, 62, 0));
+	}
+
+	SUBCASE("Modern")
+	{
+		const auto regs = run(quirk_profile::modern);
+		REQUIRE_EQ(regs.v[4], std::byte{0x01});
+		REQUIRE_EQ(regs.v[2], std::byte{0x40});
+		REQUIRE_EQ(regs.i, 0x300);
+		REQUIRE(framebuffer::get_pixel(frame, 62, 30));
+		REQUIRE(framebuffer::get_pixel(frame, 0, 30));
+		REQUIRE(framebuffer::get_pixel(frame, 62, 0));
+	}
+}
+
+TEST_CASE("Self-overwriting LD [I], Vx" *
+	doctest::description("LD [I], Vx storing over itself moves I by its own register count with every engine"))
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6012, // 0x200: LD V0, 0x12
+		0x6106, // 0x202: LD V1, 0x06
+		0xA206, // 0x204: LD I, 0x206
+		0xF155  // 0x206: LD [I], V1 - stores 0x1206 over itself
+	});
+
+	// VIP moves I past every stored register, CHIP-48 one less
+	const auto profiles = {std::pair{quirk_profile::vip, 0x208}, std::pair{quirk_profile::chip48, 0x207}};
+	for (const auto& [profile, expected_i] : profiles)
+	{
+		auto backend = headless_backend();
+		auto reference = chip8::interpreter(rom.get_path(), backend, 0ns);
+		auto threaded = chip8::interpreter(rom.get_path(), backend, 0ns, execution_engine::threaded);
+		reference.set_quirk_profile(profile);
+		threaded.set_quirk_profile(profile);
+
+		REQUIRE_EQ(reference.run(4), 4);
+		REQUIRE_EQ(threaded.run(4), 4);
+		REQUIRE_EQ(reference.get_registers().pc, 0x208);
+		REQUIRE_EQ(reference.get_registers().i, expected_i);
+		REQUIRE_EQ(threaded.get_registers().pc, 0x208);
+		REQUIRE_EQ(threaded.get_registers().i, expected_i);
+	}
+}
+
+TEST_CASE("Specialized engine fallback" *
+	doctest::description("Settings specialized engine doesn't support apply in any order by falling back to interpreter"))
+{
+	const auto rom = helpers::make_rom("headless", {
+		0x6101, // 0x200: LD V1, 0x01
+		0xAFFF, // 0x202: LD I, 0xFFF
+		0xF155, // 0x204: LD [I], V1 - V1 lands in the guard band
+		0x8016, // 0x206: SHR V0, V1 - shifts V1 into V0 under VIP quirks
+		0x1208  // 0x208: JP 0x208
+	});
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, execution_engine::specialized);
+
+	SUBCASE("Memory model first")
+	{
+		interpreter.set_memory_model(memory_model::masked);
+		interpreter.set_flag_evaluation(flag_evaluation::lazy);
+		interpreter.set_quirk_profile(quirk_profile::vip);
+	}
+
+	SUBCASE("Quirk profile first")
+	{
+		interpreter.set_quirk_profile(quirk_profile::vip);
+		interpreter.set_memory_model(memory_model::masked);
+		interpreter.set_flag_evaluation(flag_evaluation::lazy);
+	}
+
+	SUBCASE("Flag evaluation first")
+	{
+		interpreter.set_flag_evaluation(flag_evaluation::lazy);
+		interpreter.set_quirk_profile(quirk_profile::vip);
+		interpreter.set_memory_model(memory_model::masked);
+	}
+
+	REQUIRE_EQ(interpreter.get_memory_model(), memory_model::masked);
+	REQUIRE_EQ(interpreter.get_flag_evaluation(), flag_evaluation::lazy);
+	REQUIRE_EQ(interpreter.get_quirk_profile(), quirk_profile::vip);
+
+	REQUIRE_EQ(interpreter.run(10), 10);
+	REQUIRE_FALSE(interpreter.is_faulted());
+	REQUIRE_EQ(interpreter.get_registers().v[0], std::byte{0x00});
+	REQUIRE_EQ(interpreter.get_registers().v[0xF], std::byte{0x01});
+}
+
+TEST_CASE("Sprite drawing" *
+	doctest::description("Sprites wrap around screen edges and report collisions in VF"))
+{
+	// LD V0, 0x3E; LD V1, 0x1F; LD V2, 0x00; LD F, V2; DRW V0, V1, 2; JP 0x20A
+	const auto rom = helpers::make_rom("headless", {0x603E, 0x611F, 0x6200, 0xF229, 0xD012, 0x120A});
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+	static_cast<void>(interpreter.run(5));
+
+	// Top line of "0" is 0xF0, second one is 0x90
+	const auto& frame = interpreter.get_video_memory();
+	REQUIRE_EQ(frame[31], 0xC000'0000'0000'0003);
+	REQUIRE_EQ(frame[0], 0x4000'0000'0000'0002);
+	REQUIRE_EQ(interpreter.get_registers().v[0xF], std::byte{0x00});
+
+	SUBCASE("Drawing again clears sprite and sets VF")
+	{
+		// LD V0, 0x3E; LD V1, 0x1F; LD V2, 0x00; LD F, V2; DRW V0, V1, 2; DRW V0, V1, 2; JP 0x20C
+		const auto redraw_rom = helpers::make_rom("headless_redraw",
+			{0x603E, 0x611F, 0x6200, 0xF229, 0xD012, 0xD012, 0x120C});
+		interpreter.reset(redraw_rom.get_path());
+		static_cast<void>(interpreter.run(6));
+
+		for (const auto row : interpreter.get_video_memory())
+			REQUIRE_EQ(row, 0);
+		REQUIRE_EQ(interpreter.get_registers().v[0xF], std::byte{0x01});
+	}
+}
@@ -0,0 +1,106 @@
+#include "doctest.h"
+#include "instruction_cache.hpp"
+
+using namespace chip8;
+
+namespace
+{
+	void decode_stub(interpreter&, const decoded_instruction&) {}
+	void test_handler(interpreter&, const decoded_instruction&) {}
+
+	constexpr auto get_test_instruction() noexcept
+	{
+		return decoded_instruction{&test_handler, 0x123, 0x1, 0x2, 0x3, std::byte{0x23}, opcode::jp, opcode::decode};
+	}
+}
+
+TEST_CASE("Instruction cache starts invalidated")
+{
+	const auto cache = instruction_cache(&decode_stub);
+	for (size_t addr = 0; addr < constants::mem_size; ++addr)
+		CHECK_EQ(cache[uint16_t(addr)].handler, &decode_stub);
+}
+
+TEST_CASE("Instruction cache store")
+{
+	auto cache = instruction_cache(&decode_stub);
+	cache.store(0x200, get_test_instruction());
+
+	REQUIRE_EQ(cache[0x200].handler, &test_handler);
+	REQUIRE_EQ(cache[0x200].nnn, 0x123);
+	REQUIRE_EQ(cache[0x200].x, 0x1);
+	REQUIRE_EQ(cache[0x200].y, 0x2);
+	REQUIRE_EQ(cache[0x200].n, 0x3);
+	REQUIRE_EQ(cache[0x200].kk, std::byte{0x23});
+	REQUIRE_EQ(cache[0x202].handler, &decode_stub);
+}
+
+TEST_CASE("Instruction cache invalidation" *
+	doctest::description("Tests that only instructions overlapping the written range are invalidated"))
+{
+	auto cache = instruction_cache(&decode_stub);
+	for (size_t addr = 0; addr < constants::mem_size; ++addr)
+		cache.store(uint16_t(addr), get_test_instruction());
+
+	SUBCASE("Single byte write")
+	{
+		cache.invalidate(0x300, 1);
+		CHECK_EQ(cache[0x2FE].handler, &test_handler);
+		CHECK_EQ(cache[0x2FF].handler, &decode_stub);
+		CHECK_EQ(cache[0x300].handler, &decode_stub);
+		CHECK_EQ(cache[0x301].handler, &test_handler);
+	}
+
+	SUBCASE("Multi byte write")
+	{
+		cache.invalidate(0x300, 3);
+		CHECK_EQ(cache[0x2FE].handler, &test_handler);
+		for (uint16_t addr = 0x2FF; addr < 0x303; ++addr)
+			CHECK_EQ(cache[addr].handler, &decode_stub);
+		CHECK_EQ(cache[0x303].handler, &test_handler);
+	}
+
+	SUBCASE("Write at the start of memory")
+	{
+		cache.invalidate(0x000, 2);
+		CHECK_EQ(cache[0x000].handler, &decode_stub);
+		CHECK_EQ(cache[0x001].handler, &decode_stub);
+		CHECK_EQ(cache[0x002].handler, &test_handler);
+	}
+
+	SUBCASE("Write past the end of memory")
+	{
+		cache.invalidate(0xFFE, 16);
+		CHECK_EQ(cache[0xFFC].handler, &test_handler);
+		CHECK_EQ(cache[0xFFD].handler, &decode_stub);
+		CHECK_EQ(cache[0xFFE].handler, &decode_stub);
+		CHECK_EQ(cache[0xFFF].handler, &decode_stub);
+	}
+
+	SUBCASE("Invalidate everything")
+	{
+		cache.invalidate_all();
+		for (size_t addr = 0; addr < constants::mem_size; ++addr)
+			CHECK_EQ(cache[uint16_t(addr)].handler, &decode_stub);
+	}
+}
+
+TEST_CASE("Instruction cache fused pair invalidation" *
+	doctest::description("Tests that fused pairs are invalidated by writes to their second instruction"))
+{
+	auto cache = instruction_cache(&decode_stub);
+	auto fused = get_test_instruction();
+	fused.op = opcode::ld_i_addr_drw;
+
+	cache.store(0x2FC, fused);
+	cache.store(0x2FD, fused);
+	cache.store(0x2FE, get_test_instruction());
+
+	cache.invalidate(0x300, 1);
+	CHECK_EQ(cache[0x2FC].handler, &test_handler);
+	CHECK_EQ(cache[0x2FD].handler, &decode_stub);
+	CHECK_EQ(cache[0x2FE].handler, &test_handler);
+
+	cache.invalidate(0x2FF, 1);
+	CHECK_EQ(cache[0x2FC].handler, &decode_stub);
+}
@@ -14,13 +14,23 @@ TEST_CASE("RET instruction")
 		regs.sp = uint16_t(cnt);
 		stack[cnt] = uint16_t{1337};
 
-		instructions::ret(regs, stack);
+		REQUIRE(instructions::ret(regs, stack));
 
 		CHECK_EQ(regs.sp, int16_t(cnt) - 1);
 		CHECK_EQ(regs.pc, uint16_t{1337});
 	}
 }
 
+TEST_CASE("RET instruction with empty stack")
+{
+	auto stack = stack_t();
+	auto regs = registers(0x200);
+
+	REQUIRE_FALSE(instructions::ret(regs, stack));
+	REQUIRE_EQ(regs.sp, -1);
+	REQUIRE_EQ(regs.pc, 0x200);
+}
+
 TEST_CASE("JP instruction")
 {
 	auto regs = registers(0);
@@ -58,7 +68,7 @@ TEST_CASE("Nested CALL instruction")
 	// First call
 	instr[0] = std::byte{0x0A};
 	instr[1] = std::byte{0xBF};
-	instructions::call(regs, stack, instr);
+	REQUIRE(instructions::call(regs, stack, instr));
 	REQUIRE_EQ(regs.sp, 0);
 	REQUIRE_EQ(stack[0], 1337);
 	REQUIRE_EQ(regs.pc, 0xABF);
@@ -66,7 +76,7 @@ TEST_CASE("Nested CALL instruction")
 	// Second call
 	instr[0] = std::byte{0x08};
 	instr[1] = std::byte{0xAA};
-	instructions::call(regs, stack, instr);
+	REQUIRE(instructions::call(regs, stack, instr));
 	REQUIRE_EQ(regs.sp, 1);
 	REQUIRE_EQ(stack[1], 0xABF);
 	REQUIRE_EQ(regs.pc, 0x8AA);
@@ -74,12 +84,24 @@ TEST_CASE("Nested CALL instruction")
 	// Third call
 	instr[0] = std::byte{0x01};
 	instr[1] = std::byte{0x23};
-	instructions::call(regs, stack, instr);
+	REQUIRE(instructions::call(regs, stack, instr));
 	REQUIRE_EQ(regs.sp, 2);
 	REQUIRE_EQ(stack[2], 0x8AA);
 	REQUIRE_EQ(regs.pc, 0x123);
 }
 
+TEST_CASE("CALL instruction with full stack")
+{
+	auto stack = stack_t();
+	auto regs = registers(0x200);
+	for (size_t cnt = 0; cnt < constants::stack_size; ++cnt)
+		REQUIRE(instructions::call(regs, stack, uint16_t{0x300}));
+
+	REQUIRE_FALSE(instructions::call(regs, stack, uint16_t{0x400}));
+	REQUIRE_EQ(regs.sp, int(constants::stack_size) - 1);
+	REQUIRE_EQ(regs.pc, 0x300);
+}
+
 TEST_CASE("JP V0 addr instruction")
 {
 	auto regs = registers(0);
@@ -109,3 +131,23 @@ TEST_CASE("JP V0 addr instruction")
 		REQUIRE_EQ(regs.pc, uint16_t{0x8F0});
 	}
 }
+
+TEST_CASE("JP Vx addr instruction")
+{
+	auto regs = registers(0);
+
+	SUBCASE("Jump to 0x2F0 + V2")
+	{
+		regs.v[0] = std::byte{0x01};
+		regs.v[2] = std::byte{0x0F};
+		instructions::jp_vx_addr(regs, 0x2, 0x2F0);
+		REQUIRE_EQ(regs.pc, uint16_t{0x2FF});
+	}
+
+	SUBCASE("Jump wraps past 0xFFF")
+	{
+		regs.v[0xF] = std::byte{0x02};
+		instructions::jp_vx_addr(regs, 0xF, 0xFFF);
+		REQUIRE_EQ(regs.pc, uint16_t{0x001});
+	}
+}
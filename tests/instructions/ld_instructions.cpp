@@ -158,7 +158,7 @@ TEST_CASE("LD B reg instruction")
 		for (size_t reg_idx = 0; reg_idx < 10; ++reg_idx)
 		{
 			instr[0] = std::byte(reg_idx);
-			instructions::ld_b_reg(regs, mem, instr);
+			REQUIRE(instructions::ld_b_reg(regs, mem, instr));
 
 			CHECK(std::all_of(mem.begin() + default_i_reg, mem.begin() + default_i_reg + 1,
 				[](auto data) -> bool
@@ -179,13 +179,21 @@ TEST_CASE("LD B reg instruction")
 		for (size_t reg_idx = 0; reg_idx < regs.v.size(); ++reg_idx)
 		{
 			instr[0] = std::byte(reg_idx);
-			instructions::ld_b_reg(regs, mem, instr);
+			REQUIRE(instructions::ld_b_reg(regs, mem, instr));
 
 			CHECK_EQ(mem[default_i_reg], std::byte{1});
 			CHECK_EQ(mem[default_i_reg + 1], std::byte{2});
 			CHECK_EQ(mem[default_i_reg + 2], std::byte{3});
 		}
 	}
+
+	SUBCASE("Out of bounds")
+	{
+		regs.i = 4;
+		REQUIRE_FALSE(instructions::ld_b_reg(regs, mem, instr));
+		REQUIRE_EQ(mem[4], std::byte{0xFF});
+		REQUIRE_EQ(mem[5], std::byte{0xFF});
+	}
 }
 
 TEST_CASE("LD [I] reg instruction")
@@ -202,10 +210,17 @@ TEST_CASE("LD [I] reg instruction")
 		return std::byte(cnt++);
 	});
 
-	instructions::str_i_reg(regs, mem, instr);
+	REQUIRE(instructions::str_i_reg(regs, mem, instr));
 	REQUIRE_EQ(mem[0], std::byte{0xFF});
 	for (size_t idx = 0; idx < test_regs; ++idx)
 		CHECK_EQ(mem[idx + 1], std::byte(idx));
+
+	SUBCASE("Out of bounds")
+	{
+		regs.i = 2;
+		REQUIRE_FALSE(instructions::str_i_reg(regs, mem, instr));
+		REQUIRE_EQ(mem[2], std::byte{0x01});
+	}
 }
 
 TEST_CASE("LD reg [I] instruction")
@@ -223,7 +238,7 @@ TEST_CASE("LD reg [I] instruction")
 		return std::byte(cnt++);
 	});
 
-	instructions::str_reg_i(regs, mem, instr);
+	REQUIRE(instructions::str_reg_i(regs, mem, instr));
 	REQUIRE_EQ(mem[0], std::byte{0xFF});
 	for (size_t idx = 0; idx < test_regs; ++idx)
 		CHECK_EQ(regs.v[idx], std::byte(idx));
@@ -231,3 +246,48 @@ TEST_CASE("LD reg [I] instruction")
 	for (auto idx = test_regs; idx < regs.v.size(); ++idx)
 		CHECK_EQ(regs.v[idx], std::byte{0xFF});
 }
+
+TEST_CASE("Masked memory instructions")
+{
+	auto regs = registers(0);
+	auto mem = memory_t{};
+	std::generate(regs.v.begin(), regs.v.end(), [cnt = size_t{1}]() mutable
+	{
+		return std::byte(cnt++);
+	});
+
+	SUBCASE("I is masked to 12 bits")
+	{
+		regs.i = 0x1100;
+		instructions::str_i_reg_masked(regs, mem, 2);
+		REQUIRE_EQ(mem[0x100], std::byte{1});
+		REQUIRE_EQ(mem[0x101], std::byte{2});
+		REQUIRE_EQ(mem[0x102], std::byte{3});
+		REQUIRE_EQ(mem[0x103], std::byte{0});
+		REQUIRE_EQ(regs.i, 0x1100);
+	}
+
+	SUBCASE("Access running past 0xFFF lands in guard band")
+	{
+		regs.i = 0xFFF;
+		instructions::str_i_reg_masked(regs, mem, 0xF);
+		REQUIRE_EQ(mem[0xFFF], std::byte{1});
+		REQUIRE_EQ(mem[0xFFF + 0xF], std::byte{16});
+		REQUIRE_EQ(mem[0], std::byte{0});
+
+		regs.v.fill(std::byte{0});
+		instructions::str_reg_i_masked(regs, mem, 0xF);
+		for (size_t idx = 0; idx < regs.v.size(); ++idx)
+			CHECK_EQ(regs.v[idx], std::byte(idx + 1));
+	}
+
+	SUBCASE("LD B")
+	{
+		regs.i = 0xFFE;
+		regs.v[0] = std::byte(123);
+		instructions::ld_b_reg_masked(regs, mem, 0);
+		REQUIRE_EQ(mem[0xFFE], std::byte{1});
+		REQUIRE_EQ(mem[0xFFF], std::byte{2});
+		REQUIRE_EQ(mem[0x1000], std::byte{3});
+	}
+}
@@ -3,6 +3,9 @@
 
 #include "instructions.hpp"
 
+#include <array>
+#include <vector>
+
 using namespace chip8;
 
 TEST_CASE("ADD reg byte instruction")
@@ -351,3 +354,52 @@ TEST_CASE("ADD F reg instruction")
 		CHECK_EQ(regs.i, digit * 5);
 	}
 }
+
+TEST_CASE("Deferred flag instructions" *
+	doctest::description("Deferred ALU instructions followed by flag materialization match eager ones"))
+{
+	const auto operands = std::array{std::byte{0x00}, std::byte{0x01}, std::byte{0x7F}, std::byte{0x80},
+		std::byte{0xFE}, std::byte{0xFF}};
+
+	for (const auto vx : operands)
+		for (const auto vy : operands)
+		{
+			auto expected = std::vector<registers>(5, registers(0));
+			for (auto& regs : expected)
+			{
+				regs.v[0] = vx;
+				regs.v[1] = vy;
+				regs.v[0xF] = std::byte{0xAA};
+			}
+			auto actual = expected;
+
+			instructions::add_reg_reg(expected[0], 0, 1);
+			instructions::sub_reg_reg(expected[1], 0, 1);
+			instructions::shr_reg_reg(expected[2], 0);
+			instructions::subn_reg_reg(expected[3], 0, 1);
+			instructions::shl_reg_reg(expected[4], 0);
+
+			auto flag = deferred_flag{};
+			instructions::add_reg_reg(actual[0], flag, 0, 1);
+			REQUIRE_EQ(actual[0].v[0xF], std::byte{0xAA});
+			instructions::materialize_flag(actual[0], flag);
+			instructions::sub_reg_reg(actual[1], flag, 0, 1);
+			instructions::materialize_flag(actual[1], flag);
+			instructions::shr_reg_reg(actual[2], flag, 0);
+			instructions::materialize_flag(actual[2], flag);
+			instructions::subn_reg_reg(actual[3], flag, 0, 1);
+			instructions::materialize_flag(actual[3], flag);
+			instructions::shl_reg_reg(actual[4], flag, 0);
+			instructions::materialize_flag(actual[4], flag);
+
+			for (auto idx = size_t{0}; idx < expected.size(); ++idx)
+			{
+				REQUIRE_EQ(actual[idx].v[0], expected[idx].v[0]);
+				REQUIRE_EQ(actual[idx].v[0xF], expected[idx].v[0xF]);
+			}
+
+			// Materializing without a deferred instruction leaves VF alone
+			instructions::materialize_flag(actual[0], flag);
+			REQUIRE_EQ(actual[0].v[0xF], expected[0].v[0xF]);
+		}
+}
@@ -10,6 +10,7 @@ using namespace chip8;
 TEST_CASE("RND Vx, byte")
 {
 	auto regs = registers(0);
+	auto rng = random_generator(1234);
 	auto instr = helpers::get_zero_instruction();
 
 	SUBCASE("Lower nibble mask")
@@ -18,7 +19,7 @@ TEST_CASE("RND Vx, byte")
 		for (size_t reg_idx = 0; reg_idx < regs.v.size(); ++reg_idx)
 		{
 			instr[0] = std::byte(reg_idx);
-			instructions::rnd_reg_byte(regs, instr);
+			instructions::rnd_reg_byte(regs, rng, instr);
 		}
 
 		REQUIRE(std::all_of(regs.v.begin(), regs.v.end() - 1, [](std::byte reg)
@@ -33,7 +34,7 @@ TEST_CASE("RND Vx, byte")
 		for (size_t reg_idx = 0; reg_idx < regs.v.size(); ++reg_idx)
 		{
 			instr[0] = std::byte(reg_idx);
-			instructions::rnd_reg_byte(regs, instr);
+			instructions::rnd_reg_byte(regs, rng, instr);
 		}
 
 		REQUIRE(std::all_of(regs.v.begin(), regs.v.end() - 1, [](std::byte reg)
@@ -41,4 +42,82 @@ TEST_CASE("RND Vx, byte")
 			return (reg & std::byte{0x0F}) == std::byte{0x00};
 		}));
 	}
+
+	SUBCASE("Same seed gives same sequence")
+	{
+		instr[1] = std::byte{0xFF};
+		auto other_regs = registers(0);
+		auto other_rng = random_generator(1234);
+		for (size_t cnt = 0; cnt < 100; ++cnt)
+		{
+			instructions::rnd_reg_byte(regs, rng, instr);
+			instructions::rnd_reg_byte(other_regs, other_rng, instr);
+			REQUIRE_EQ(regs.v[0], other_regs.v[0]);
+		}
+
+		// Adjacent seed starts a different sequence
+		auto values = std::array<std::byte, 8>{};
+		auto other_values = std::array<std::byte, 8>{};
+		rng.seed(1);
+		other_rng.seed(2);
+		for (auto& value : values)
+			value = rng.next_byte();
+		for (auto& value : other_values)
+			value = other_rng.next_byte();
+
+		REQUIRE_NE(values, other_values);
+	}
+}
+
+TEST_CASE("SKP/SKNP Vx")
+{
+	auto regs = registers(0);
+	auto keys = keyboard_state{};
+	regs.v[0x3] = std::byte{0xA};
+
+	SUBCASE("Key released")
+	{
+		instructions::skp_reg(regs, keys, 0x3);
+		REQUIRE_EQ(regs.pc, 0);
+
+		instructions::sknp_reg(regs, keys, 0x3);
+		REQUIRE_EQ(regs.pc, 2);
+	}
+
+	SUBCASE("Key pressed")
+	{
+		keys = keyboard_state{1 << 0xA};
+		instructions::skp_reg(regs, keys, 0x3);
+		REQUIRE_EQ(regs.pc, 2);
+
+		instructions::sknp_reg(regs, keys, 0x3);
+		REQUIRE_EQ(regs.pc, 2);
+	}
+
+	SUBCASE("Upper nibble of key register is ignored")
+	{
+		keys = keyboard_state{1 << 0xA};
+		regs.v[0x3] = std::byte{0xFA};
+		instructions::skp_reg(regs, keys, 0x3);
+		REQUIRE_EQ(regs.pc, 2);
+	}
+}
+
+TEST_CASE("LD Vx, K")
+{
+	auto regs = registers(0);
+	auto keys = keyboard_state{};
+
+	SUBCASE("No key pressed")
+	{
+		REQUIRE_FALSE(instructions::ld_reg_k(regs, keys, 0x5));
+		REQUIRE_EQ(regs.v[0x5], std::byte{0x00});
+	}
+
+	SUBCASE("Lowest pressed key is stored")
+	{
+		keys = keyboard_state{1 << 0xC | 1 << 0x9};
+		REQUIRE(instructions::ld_reg_k(regs, keys, 0x5));
+		REQUIRE_EQ(regs.v[0x5], std::byte{0x09});
+	}
 }
@@ -0,0 +1,279 @@
+#include "doctest.h"
+#include "test_helpers.hpp"
+
+#include "instructions.hpp"
+#include "interpreter.hpp"
+#include "io/headless_backend.hpp"
+#include "jit/engine.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace chip8;
+
+namespace
+{
+	// Allows every block to run to its end
+	constexpr auto unlimited_budget = size_t{jit::max_block_instructions};
+
+	void write_program(memory_t& mem, uint16_t address, const std::vector<uint16_t>& program)
+	{
+		for (const auto opcode : program)
+		{
+			mem[address++] = std::byte(opcode >> 8);
+			mem[address++] = std::byte(opcode & 0xFF);
+		}
+	}
+
+	// Executes a single translatable instruction the same way the interpreter does
+	void execute_reference(registers& regs, const memory_t& mem)
+	{
+		const auto instr = instructions::fetch(mem, regs.pc);
+		switch (std::to_integer<uint8_t>(instructions::extract_instruction_class(instr)))
+		{
+			case 0x1: instructions::jp(regs, instr); return;
+			case 0x3: instructions::se_reg_byte(regs, instr); break;
+			case 0x4: instructions::sne_reg_byte(regs, instr); break;
+			case 0x5: instructions::se_reg_reg(regs, instr); break;
+			case 0x6: instructions::ld_reg_byte(regs, instr); break;
+			case 0x7: instructions::add_reg_byte(regs, instr); break;
+			case 0x8:
+			{
+				switch (instructions::get_lower_nibble<uint8_t>(instr[1]))
+				{
+					case 0x0: instructions::ld_reg_reg(regs, instr); break;
+					case 0x1: instructions::or_reg_reg(regs, instr); break;
+					case 0x2: instructions::and_reg_reg(regs, instr); break;
+					case 0x3: instructions::xor_reg_reg(regs, instr); break;
+					case 0x4: instructions::add_reg_reg(regs, instr); break;
+					case 0x5: instructions::sub_reg_reg(regs, instr); break;
+					case 0x6: instructions::shr_reg_reg(regs, instr); break;
+					case 0x7: instructions::subn_reg_reg(regs, instr); break;
+					case 0xE: instructions::shl_reg_reg(regs, instr); break;
+				}
+				break;
+			}
+			case 0x9: instructions::sne_reg_reg(regs, instr); break;
+			case 0xA: instructions::ld_i_addr(regs, instr); break;
+			case 0xB: instructions::jp_v0_addr(regs, instr); return;
+			case 0xF:
+			{
+				switch (std::to_integer<uint8_t>(instr[1]))
+				{
+					case 0x07: instructions::ld_reg_dt(regs, instr); break;
+					case 0x1E: instructions::add_i_reg(regs, instr); break;
+					case 0x29: instructions::ld_f_reg(regs, instr); break;
+				}
+				break;
+			}
+		}
+
+		regs.pc += 2;
+	}
+
+	void randomize(registers& regs, std::mt19937& rng)
+	{
+		auto dist = std::uniform_int_distribution<int>(0, 255);
+		for (auto& reg : regs.v)
+			reg = std::byte(dist(rng));
+
+		regs.i = uint16_t(dist(rng) << 8 | dist(rng));
+		regs.delay = uint8_t(dist(rng));
+	}
+
+	void require_same_registers(const registers& lhs, const registers& rhs)
+	{
+		for (size_t idx = 0; idx < lhs.v.size(); ++idx)
+			REQUIRE_EQ(lhs.v[idx], rhs.v[idx]);
+
+		REQUIRE_EQ(lhs.i, rhs.i);
+		REQUIRE_EQ(lhs.pc, rhs.pc);
+		REQUIRE_EQ(lhs.sp, rhs.sp);
+		REQUIRE_EQ(lhs.delay, rhs.delay);
+		REQUIRE_EQ(lhs.sound, rhs.sound);
+	}
+}
+
+TEST_CASE("JIT matches interpreter for single instructions" *
+	doctest::description("Translates every supported instruction with every register combination and compares "
+		"the result with instruction handlers"))
+{
+	static constexpr auto opcode_templates = std::array<uint16_t, 19>
+	{
+		0x3000, 0x4000, 0x5000, 0x6000, 0x7000, 0x8000, 0x8001, 0x8002, 0x8003, 0x8004,
+		0x8005, 0x8006, 0x8007, 0x800E, 0x9000, 0xA000, 0xB000, 0xF01E, 0xF029
+	};
+
+	auto rng = std::mt19937{1337};
+	auto mem = memory_t{};
+
+	for (const auto opcode_template : opcode_templates)
+	{
+		for (uint16_t x = 0; x < 16; ++x)
+		{
+			for (uint16_t y = 0; y < 16; ++y)
+			{
+				// Fx instructions are selected by their lower byte, so y can only be added to other instructions
+				const auto opcode = uint16_t(opcode_template | x << 8 |
+					((opcode_template & 0xF000) != 0xF000 ? y << 4 : 0));
+				mem.fill(std::byte{0x00});
+				write_program(mem, 0x200, {opcode, 0x1200});
+
+				auto jit_engine = jit::engine(mem);
+				for (size_t cnt = 0; cnt < 4; ++cnt)
+				{
+					auto expected = registers(0x200);
+					randomize(expected, rng);
+
+					// Make sure that both outcomes of comparisons are covered
+					if (cnt == 0)
+						expected.v[x] = expected.v[y];
+					else if (cnt == 1)
+						expected.v[x] = std::byte(opcode & 0xFF);
+
+					auto actual = expected;
+
+					execute_reference(expected, mem);
+					if (expected.pc == 0x202)
+						execute_reference(expected, mem);
+
+					auto executed = jit_engine.execute(actual, unlimited_budget);
+					REQUIRE_GT(executed, 0);
+					if (actual.pc == 0x202)
+						executed += jit_engine.execute(actual, unlimited_budget);
+
+					require_same_registers(actual, expected);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("JIT block boundaries")
+{
+	auto mem = memory_t{};
+
+	SUBCASE("Untranslatable first instruction is left for interpreter")
+	{
+		write_program(mem, 0x200, {0x00E0});
+		auto jit_engine = jit::engine(mem);
+		auto regs = registers(0x200);
+
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 0);
+		REQUIRE_EQ(regs.pc, 0x200);
+	}
+
+	SUBCASE("Block stops before untranslatable instruction")
+	{
+		write_program(mem, 0x200, {0x6001, 0x7102, 0xD015});
+		auto jit_engine = jit::engine(mem);
+		auto regs = registers(0x200);
+
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 2);
+		REQUIRE_EQ(regs.pc, 0x204);
+		REQUIRE_EQ(regs.v[0], std::byte{0x01});
+		REQUIRE_EQ(regs.v[1], std::byte{0x02});
+	}
+
+	SUBCASE("Block ends at jump")
+	{
+		write_program(mem, 0x200, {0x6001, 0x1300, 0x6102});
+		auto jit_engine = jit::engine(mem);
+		auto regs = registers(0x200);
+
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 2);
+		REQUIRE_EQ(regs.pc, 0x300);
+		REQUIRE_EQ(regs.v[1], std::byte{0x00});
+	}
+
+	SUBCASE("Block longer than budget is left for interpreter")
+	{
+		write_program(mem, 0x200, {0x6001, 0x7102, 0x1200});
+		auto jit_engine = jit::engine(mem);
+		auto regs = registers(0x200);
+
+		REQUIRE_EQ(jit_engine.execute(regs, 2), 0);
+		REQUIRE_EQ(regs.pc, 0x200);
+		REQUIRE_EQ(regs.v[0], std::byte{0x00});
+
+		REQUIRE_EQ(jit_engine.execute(regs, 3), 3);
+		REQUIRE_EQ(regs.pc, 0x200);
+	}
+
+	SUBCASE("Block does not run past the end of memory")
+	{
+		write_program(mem, 0xFFC, {0x6001, 0x6102});
+		auto jit_engine = jit::engine(mem);
+		auto regs = registers(0xFFC);
+
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 2);
+		REQUIRE_EQ(regs.pc, 0x1000);
+	}
+}
+
+TEST_CASE("JIT block invalidation" *
+	doctest::description("Tests that writes to translated memory cause retranslation"))
+{
+	auto mem = memory_t{};
+	write_program(mem, 0x200, {0x6001, 0x7001, 0x1200});
+	auto jit_engine = jit::engine(mem);
+	auto regs = registers(0x200);
+
+	REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 3);
+	REQUIRE_EQ(regs.v[0], std::byte{0x02});
+
+	SUBCASE("Write outside of block keeps it")
+	{
+		write_program(mem, 0x202, {0x7005});
+		jit_engine.invalidate(0x300, 2);
+
+		regs.pc = 0x200;
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 3);
+		REQUIRE_EQ(regs.v[0], std::byte{0x02});
+	}
+
+	SUBCASE("Write inside of block causes retranslation")
+	{
+		write_program(mem, 0x202, {0x7005});
+		jit_engine.invalidate(0x203, 1);
+
+		regs.pc = 0x200;
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 3);
+		REQUIRE_EQ(regs.v[0], std::byte{0x06});
+	}
+
+	SUBCASE("Write over untranslatable instruction causes translation")
+	{
+		write_program(mem, 0x300, {0x00E0, 0x1300});
+		regs.pc = 0x300;
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 0);
+
+		write_program(mem, 0x300, {0x6007});
+		jit_engine.invalidate(0x301, 1);
+
+		REQUIRE_EQ(jit_engine.execute(regs, unlimited_budget), 2);
+		REQUIRE_EQ(regs.v[0], std::byte{0x07});
+		REQUIRE_EQ(regs.pc, 0x300);
+	}
+}
+
+TEST_CASE("JIT engine respects instruction budget" *
+	doctest::description("Tests that running the machine never executes more instructions than requested"))
+{
+	// LD V0, 0x01; ADD V0, 0x01; ADD V0, 0x01; JP 0x202
+	const auto rom = helpers::make_rom("jit_budget", {0x6001, 0x7001, 0x7001, 0x1202});
+	auto backend = headless_backend();
+	auto reference = chip8::interpreter(rom.get_path(), backend, 0ns);
+	auto translated = chip8::interpreter(rom.get_path(), backend, 0ns, execution_engine::jit);
+
+	for (size_t step = 0; step < 10; ++step)
+	{
+		REQUIRE_EQ(reference.run(1), 1);
+		REQUIRE_EQ(translated.run(1), 1);
+		require_same_registers(translated.get_registers(), reference.get_registers());
+	}
+
+	REQUIRE_EQ(translated.run(5), 5);
+	REQUIRE_EQ(reference.run(5), 5);
+	require_same_registers(translated.get_registers(), reference.get_registers());
+}
@@ -0,0 +1,236 @@
+#include "doctest.h"
+#include "test_helpers.hpp"
+
+#include "framebuffer.hpp"
+#include "interpreter.hpp"
+#include "io/headless_backend.hpp"
+#include "lockstep/engine.hpp"
+
+#include <type_traits>
+#include <vector>
+
+using namespace chip8;
+
+namespace
+{
+	// Register only program that loops forever and touches VF with every flag setting instruction
+	const auto alu_program = std::vector<uint16_t>{
+		0x6005, // LD V0, 0x05
+		0x61FB, // LD V1, 0xFB
+		0x8014, // ADD V0, V1
+		0x8205, // SUB V2, V0
+		0x8316, // SHR V3, V1
+		0x8417, // SUBN V4, V1
+		0x851E, // SHL V5, V1
+		0x8F14, // ADD VF, V1
+		0x8F15, // SUB VF, V1
+		0x8F1E, // SHL VF, V1
+		0x8612, // AND V6, V1
+		0x8713, // XOR V7, V1
+		0x8871, // OR V8, V7
+		0x7907, // ADD V9, 0x07
+		0x39FC, // SE V9, 0xFC
+		0x1200, // JP 0x200
+		0x7A01, // ADD VA, 0x01
+		0x1200  // JP 0x200
+	};
+}
+
+TEST_CASE_TEMPLATE("Lockstep engine matches interpreter" *
+	doctest::description("Every lane runs the same program as a single interpreter"),
+	lane_count, std::integral_constant<size_t, 8>, std::integral_constant<size_t, 16>,
+	std::integral_constant<size_t, 32>)
+{
+	const auto rom = helpers::make_rom("lockstep", alu_program);
+	constexpr auto step_count = size_t{1000};
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+	REQUIRE_EQ(interpreter.run(step_count), step_count);
+
+	auto engine = lockstep::engine<lane_count::value>(rom.get_path(), 0);
+	engine.run(step_count);
+
+	const auto& expected = interpreter.get_registers();
+	for (auto lane = size_t{0}; lane < lane_count::value; ++lane)
+	{
+		const auto regs = engine.get_registers(lane);
+		REQUIRE_EQ(regs.pc, expected.pc);
+		REQUIRE_EQ(regs.i, expected.i);
+		for (auto idx = size_t{0}; idx < constants::v_reg_count; ++idx)
+			REQUIRE_EQ(regs.v[idx], expected.v[idx]);
+	}
+
+	// No lane ever diverges, so only jumps run on scalar path
+	REQUIRE_GT(engine.get_vector_lane_steps(), engine.get_scalar_lane_steps());
+}
+
+TEST_CASE("Lockstep engine")
+{
+	SUBCASE("Divergent lanes")
+	{
+		// LD V0, 0x05; SKP V0; LD V1, 0x01; ADD V2, 0x01; JP 0x206
+		const auto rom = helpers::make_rom("lockstep", {0x6005, 0xE09E, 0x6101, 0x7201, 0x1206});
+		auto engine = lockstep::engine<8>(rom.get_path(), 0);
+
+		for (auto lane = size_t{1}; lane < 8; lane += 2)
+			engine.set_keyboard_state(lane, keyboard_state{1 << 5});
+
+		engine.run(9);
+		for (auto lane = size_t{0}; lane < 8; ++lane)
+		{
+			const auto is_key_pressed = (lane % 2 == 1);
+			const auto regs = engine.get_registers(lane);
+			REQUIRE_EQ(regs.v[1], is_key_pressed ? std::byte{0x00} : std::byte{0x01});
+			REQUIRE_EQ(regs.v[2], is_key_pressed ? std::byte{0x04} : std::byte{0x03});
+		}
+	}
+
+	SUBCASE("Sprites match interpreter")
+	{
+		// LD V0, 0x3C; LD V1, 0x1E; LD V2, 0x08; LD F, V2; DRW V0, V1, 5; DRW V1, V1, 5; JP 0x20C
+		const auto rom = helpers::make_rom("lockstep", {0x603C, 0x611E, 0x6208, 0xF229, 0xD015, 0xD115, 0x120C});
+
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+		static_cast<void>(interpreter.run(10));
+
+		auto engine = lockstep::engine<8>(rom.get_path(), 0);
+		engine.run(10);
+
+		const auto& video = interpreter.get_video_memory();
+		for (auto y = size_t{0}; y < constants::ch8_height; ++y)
+			for (auto x = size_t{0}; x < constants::ch8_width; ++x)
+				REQUIRE_EQ(engine.get_pixel(7, x, y), framebuffer::get_pixel(video, x, y));
+
+		const auto regs = engine.get_registers(7);
+		REQUIRE_EQ(regs.v[0xF], interpreter.get_registers().v[0xF]);
+	}
+
+	SUBCASE("Computed jump matches interpreter")
+	{
+		// LD V0, 0x02; JP V0, 0x206; data; data; ADD V1, 0x01; JP 0x20A
+		const auto rom = helpers::make_rom("lockstep", {0x6002, 0xB206, 0x0000, 0x0000, 0x7101, 0x120A});
+
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+		static_cast<void>(interpreter.run(10));
+
+		auto engine = lockstep::engine<8>(rom.get_path(), 0);
+		engine.run(10);
+
+		const auto regs = engine.get_registers(0);
+		REQUIRE_EQ(regs.pc, interpreter.get_registers().pc);
+		REQUIRE_EQ(regs.v[1], interpreter.get_registers().v[1]);
+		REQUIRE_EQ(regs.v[1], std::byte{0x01});
+	}
+
+	SUBCASE("Memory and subroutines")
+	{
+		// LD V0, 0xFE; LD I, 0x300; CALL 0x20A; LD V1, [I]; JP 0x208; LD B, V0; RET
+		const auto rom = helpers::make_rom("lockstep", {0x60FE, 0xA300, 0x220A, 0xF165, 0x1208, 0xF033, 0x00EE});
+		auto engine = lockstep::engine<16>(rom.get_path(), 0);
+
+		engine.run(10);
+		for (auto lane = size_t{0}; lane < 16; ++lane)
+		{
+			REQUIRE_EQ(engine.read_memory(lane, 0x300), std::byte{2});
+			REQUIRE_EQ(engine.read_memory(lane, 0x301), std::byte{5});
+			REQUIRE_EQ(engine.read_memory(lane, 0x302), std::byte{4});
+			const auto regs = engine.get_registers(lane);
+			REQUIRE_EQ(regs.v[1], std::byte{5});
+			REQUIRE_EQ(regs.sp, -1);
+		}
+	}
+
+	SUBCASE("Seeded random numbers")
+	{
+		// RND V0, 0xFF; JP 0x202
+		const auto rom = helpers::make_rom("lockstep", {0xC0FF, 0x1202});
+		auto engine = lockstep::engine<8>(rom.get_path(), 0);
+		engine.set_seed(0, 1234);
+		engine.set_seed(1, 1234);
+
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+		interpreter.set_seed(1234);
+
+		for (auto cnt = size_t{0}; cnt < 8; ++cnt)
+		{
+			engine.run(2);
+			REQUIRE_EQ(interpreter.run(2), 2);
+
+			const auto first = engine.get_registers(0);
+			const auto same_seed = engine.get_registers(1);
+			REQUIRE_EQ(first.v[0], same_seed.v[0]);
+			REQUIRE_EQ(first.v[0], interpreter.get_registers().v[0]);
+		}
+
+		const auto first = engine.get_registers(0);
+		const auto default_seed = engine.get_registers(2);
+		REQUIRE_NE(first.v[0], default_seed.v[0]);
+	}
+
+	SUBCASE("Timers count steps")
+	{
+		// LD V0, 0x0A; LD DT, V0; JP 0x204
+		const auto rom = helpers::make_rom("lockstep", {0x600A, 0xF015, 0x1204});
+		auto engine = lockstep::engine<8>(rom.get_path(), 2);
+
+		engine.run(2);
+		REQUIRE_EQ(engine.get_registers(3).delay, 9);
+		engine.run(2);
+		REQUIRE_EQ(engine.get_registers(3).delay, 8);
+		engine.run(100);
+		REQUIRE_EQ(engine.get_registers(3).delay, 0);
+	}
+
+	SUBCASE("Faulting lanes")
+	{
+		const auto rom = helpers::make_rom("lockstep", {
+			0x6005, // 0x200: LD V0, 0x05
+			0xE09E, // 0x202: SKP V0
+			0x120A, // 0x204: JP 0x20A
+			0x00EE, // 0x206: RET - reached by lanes with key 5 pressed, stack is empty
+			0x0000, // 0x208: data
+			0x7101, // 0x20A: ADD V1, 0x01
+			0x120A  // 0x20C: JP 0x20A
+		});
+		auto engine = lockstep::engine<8>(rom.get_path(), 0);
+		for (auto lane = size_t{1}; lane < 8; lane += 2)
+			engine.set_keyboard_state(lane, keyboard_state{1 << 5});
+
+		engine.run(10);
+		REQUIRE_EQ(engine.get_faulted_lane_count(), 4);
+		for (auto lane = size_t{0}; lane < 8; ++lane)
+		{
+			const auto regs = engine.get_registers(lane);
+			const auto& status = engine.get_fault(lane);
+			if (lane % 2 == 0)
+			{
+				REQUIRE_EQ(status.kind, fault::none);
+				REQUIRE_EQ(regs.v[1], std::byte{0x04});
+				continue;
+			}
+
+			REQUIRE_EQ(status.kind, fault::stack_underflow);
+			REQUIRE_EQ(status.pc, 0x206);
+			REQUIRE_EQ(regs.pc, 0x206);
+			REQUIRE_EQ(regs.sp, -1);
+		}
+
+		// Lanes executing the faulting instruction aren't counted
+		REQUIRE_EQ(engine.get_vector_lane_steps() + engine.get_scalar_lane_steps(), 4 * 10 + 4 * 2);
+	}
+
+	SUBCASE("Illegal instruction")
+	{
+		const auto rom = helpers::make_rom("lockstep", {0x0000});
+		auto engine = lockstep::engine<8>(rom.get_path(), 0);
+		engine.run(2);
+		REQUIRE_EQ(engine.get_faulted_lane_count(), 8);
+		REQUIRE_EQ(engine.get_fault(0).kind, fault::illegal_instruction);
+		REQUIRE_EQ(engine.get_registers(0).pc, 0x200);
+		REQUIRE_EQ(engine.get_scalar_lane_steps(), 0);
+	}
+}
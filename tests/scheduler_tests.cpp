@@ -0,0 +1,64 @@
+#include "doctest.h"
+#include "scheduler.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace std::literals::chrono_literals;
+
+TEST_CASE("Scheduler pacing" *
+	doctest::description("Tests if scheduler waits for slice deadlines and accounts for waiting time"))
+{
+	const auto start_time = std::chrono::steady_clock::now();
+	auto scheduler = chip8::scheduler(2ms);
+
+	for (size_t cnt = 0; cnt < 10; ++cnt)
+		scheduler.wait_for_next_slice();
+
+	const auto& stats = scheduler.get_statistics();
+	REQUIRE_GE(std::chrono::steady_clock::now() - start_time, 20ms);
+	REQUIRE_EQ(stats.slice_count, 10);
+	REQUIRE_GE(stats.elapsed_time, 20ms);
+	REQUIRE_LE(stats.sleep_time + stats.spin_time, stats.elapsed_time);
+	REQUIRE_GE(stats.get_cpu_utilisation(), 0.0);
+	REQUIRE_LE(stats.get_cpu_utilisation(), 1.0);
+}
+
+TEST_CASE("Scheduler deadline misses" *
+	doctest::description("Tests if overrunning a slice is reported and missed slices are dropped"))
+{
+	auto scheduler = chip8::scheduler(1ms);
+
+	const auto busy_until = std::chrono::steady_clock::now() + 5ms;
+	while (std::chrono::steady_clock::now() < busy_until)
+		continue;
+
+	scheduler.wait_for_next_slice();
+	REQUIRE_EQ(scheduler.get_statistics().deadline_miss_count, 1);
+	REQUIRE_GE(scheduler.get_statistics().max_lateness, 3ms);
+
+	// Next deadline is a full slice after the late one, so there is nothing to catch up with
+	const auto wait_start = std::chrono::steady_clock::now();
+	scheduler.wait_for_next_slice();
+	REQUIRE_GE(std::chrono::steady_clock::now() - wait_start, 500us);
+
+	SUBCASE("Restart clears statistics")
+	{
+		scheduler.start();
+		REQUIRE_EQ(scheduler.get_statistics().slice_count, 0);
+		REQUIRE_EQ(scheduler.get_statistics().deadline_miss_count, 0);
+	}
+}
+
+TEST_CASE("Scheduler blocking" *
+	doctest::description("Tests if time blocked outside of scheduler counts as sleep instead of lateness"))
+{
+	auto scheduler = chip8::scheduler(1ms);
+	scheduler.wait_for_events([] { std::this_thread::sleep_for(20ms); });
+	scheduler.wait_for_next_slice();
+
+	const auto& stats = scheduler.get_statistics();
+	REQUIRE_LT(stats.max_lateness, 10ms);
+	REQUIRE_GE(stats.sleep_time, 20ms);
+	REQUIRE_LT(stats.get_cpu_utilisation(), 0.5);
+}
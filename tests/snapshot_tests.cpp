@@ -0,0 +1,157 @@
+#include "doctest.h"
+#include "test_helpers.hpp"
+
+#include "interpreter.hpp"
+#include "snapshot.hpp"
+#include "io/headless_backend.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+using namespace chip8;
+
+namespace
+{
+	void require_same_machine(const interpreter& lhs, const interpreter& rhs)
+	{
+		const auto& lhs_regs = lhs.get_registers();
+		const auto& rhs_regs = rhs.get_registers();
+		REQUIRE_EQ(lhs_regs.v, rhs_regs.v);
+		REQUIRE_EQ(lhs_regs.i, rhs_regs.i);
+		REQUIRE_EQ(lhs_regs.pc, rhs_regs.pc);
+		REQUIRE_EQ(lhs_regs.sp, rhs_regs.sp);
+		REQUIRE_EQ(lhs_regs.delay, rhs_regs.delay);
+		REQUIRE_EQ(lhs_regs.sound, rhs_regs.sound);
+		REQUIRE_EQ(lhs.get_video_memory(), rhs.get_video_memory());
+	}
+}
+
+TEST_CASE("Snapshot format")
+{
+	REQUIRE_LT(snapshot::size, size_t{5 * 1024});
+
+	auto blob = snapshot_t{};
+	snapshot::store(blob, 2, uint32_t{0x1234'5678});
+	REQUIRE_EQ(blob[2], std::byte{0x78});
+	REQUIRE_EQ(blob[5], std::byte{0x12});
+	REQUIRE_EQ(snapshot::load<uint32_t>(blob, 2), 0x1234'5678);
+}
+
+TEST_CASE("Snapshots" *
+	doctest::description("Restored machine continues exactly like the one it was captured from"))
+{
+	const auto rom = helpers::make_rom("snapshot", {
+		0x6A0A, // 0x200: LD VA, 0x0A
+		0xFA15, // 0x202: LD DT, VA
+		0xFA18, // 0x204: LD ST, VA
+		0xC0FF, // 0x206: RND V0, 0xFF
+		0xA300, // 0x208: LD I, 0x300
+		0xF055, // 0x20A: LD [I], V0
+		0x2214, // 0x20C: CALL 0x214
+		0x7101, // 0x20E: ADD V1, 0x01
+		0xD121, // 0x210: DRW V1, V2, 1
+		0x1206, // 0x212: JP 0x206
+		0xF207, // 0x214: LD V2, DT
+		0x00EE  // 0x216: RET
+	});
+	constexpr auto tick_period = std::chrono::duration_cast<std::chrono::nanoseconds>(1s) / 600;
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, tick_period);
+	interpreter.set_clock_source(clock_source::virtual_time);
+	interpreter.set_seed(7);
+
+	REQUIRE_EQ(interpreter.run(53), 53);
+	const auto snapshot = interpreter.save_state();
+	REQUIRE_EQ(interpreter.run(200), 200);
+
+	SUBCASE("Same interpreter")
+	{
+		auto reference = chip8::interpreter(rom.get_path(), backend, tick_period);
+		reference.set_clock_source(clock_source::virtual_time);
+		reference.set_seed(7);
+		REQUIRE_EQ(reference.run(253), 253);
+
+		interpreter.load_state(snapshot);
+		REQUIRE_EQ(interpreter.run(200), 200);
+		require_same_machine(interpreter, reference);
+	}
+
+	SUBCASE("Forked interpreters")
+	{
+		for (const auto engine : {execution_engine::interpreter, execution_engine::threaded})
+		{
+			auto fork_backend = headless_backend();
+			auto fork = chip8::interpreter(rom.get_path(), fork_backend, tick_period, engine);
+			fork.set_clock_source(clock_source::virtual_time);
+			fork.load_state(snapshot);
+			REQUIRE_EQ(fork.get_registers().sound, 5);
+			REQUIRE(fork_backend.is_sound_playing());
+			REQUIRE_EQ(fork.run(200), 200);
+			require_same_machine(fork, interpreter);
+		}
+	}
+
+	SUBCASE("Invalid snapshots are rejected")
+	{
+		auto invalid = snapshot;
+		invalid[snapshot::version_offset] = std::byte{0xFF};
+		REQUIRE_THROWS_AS(interpreter.load_state(invalid), std::invalid_argument);
+
+		invalid = snapshot;
+		invalid[snapshot::key_wait_register_offset] = std::byte{0x10};
+		REQUIRE_THROWS_AS(interpreter.load_state(invalid), std::invalid_argument);
+
+		invalid = snapshot;
+		for (auto idx = size_t{0}; idx < 4; ++idx)
+			snapshot::store(invalid, snapshot::random_offset + idx * sizeof(uint32_t), uint32_t{0});
+		REQUIRE_THROWS_AS(interpreter.load_state(invalid), std::invalid_argument);
+	}
+}
+
+TEST_CASE("Snapshot memory" *
+	doctest::description("Code changed after a snapshot was taken is decoded again once it is restored"))
+{
+	const auto rom = helpers::make_rom("snapshot", {
+		0x7301, // 0x200: ADD V3, 0x01
+		0x6073, // 0x202: LD V0, 0x73
+		0x6105, // 0x204: LD V1, 0x05
+		0xA200, // 0x206: LD I, 0x200
+		0xF155, // 0x208: LD [I], V1 - 0x200 becomes ADD V3, 0x05
+		0x1200  // 0x20A: JP 0x200
+	});
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, execution_engine::threaded);
+	const auto snapshot = interpreter.save_state();
+
+	REQUIRE_EQ(interpreter.run(7), 7);
+	REQUIRE_EQ(interpreter.get_registers().v[3], std::byte{0x06});
+
+	interpreter.load_state(snapshot);
+	REQUIRE_EQ(interpreter.run(1), 1);
+	REQUIRE_EQ(interpreter.get_registers().v[3], std::byte{0x01});
+}
+
+TEST_CASE("Snapshot key wait" *
+	doctest::description("Machine waiting for a key keeps waiting once restored"))
+{
+	// LD V0, 0x01; LD V1, K; ADD V0, V1; JP 0x206
+	const auto rom = helpers::make_rom("snapshot", {0x6001, 0xF10A, 0x8014, 0x1206});
+
+	auto backend = headless_backend();
+	auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns);
+	REQUIRE_EQ(interpreter.run(10), 10);
+	const auto snapshot = interpreter.save_state();
+
+	auto fork_backend = headless_backend();
+	auto fork = chip8::interpreter(rom.get_path(), fork_backend, 0ns);
+	fork.load_state(snapshot);
+	REQUIRE_EQ(fork.run(10), 10);
+	REQUIRE_EQ(fork.get_registers().pc, 0x202);
+
+	fork_backend.press_key(0x4);
+	REQUIRE_EQ(fork.run(2), 2);
+	REQUIRE_EQ(fork.get_registers().v[0], std::byte{0x05});
+}
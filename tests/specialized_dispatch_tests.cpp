@@ -0,0 +1,117 @@
+#include "doctest.h"
+#include "test_helpers.hpp"
+
+#include "interpreter.hpp"
+#include "io/headless_backend.hpp"
+
+#include <array>
+#include <tuple>
+#include <vector>
+
+using namespace chip8;
+
+namespace
+{
+	// Gives every register a different value, V0 and V1 are equal for register comparisons
+	constexpr auto register_values = std::array<uint8_t, constants::v_reg_count>{
+		0x05, 0x05, 0xF3, 0x80, 0x01, 0x7F, 0xFF, 0x10, 0x00, 0x99, 0x3C, 0x0E, 0x42, 0xA5, 0x01, 0x00
+	};
+
+	[[nodiscard]] auto make_program(const std::vector<uint16_t>& instructions)
+	{
+		auto program = std::vector<uint16_t>{};
+		for (auto idx = size_t{0}; idx < register_values.size(); ++idx)
+			program.push_back(uint16_t(0x6000 | idx << 8 | register_values[idx]));
+
+		program.push_back(0xA300); // LD I, 0x300
+		program.insert(program.end(), instructions.begin(), instructions.end());
+		return program;
+	}
+
+	[[nodiscard]] auto run(const helpers::temporary_file& rom, execution_engine engine, size_t instruction_count)
+	{
+		auto backend = headless_backend();
+		auto interpreter = chip8::interpreter(rom.get_path(), backend, 0ns, engine);
+		interpreter.set_seed(42);
+		backend.press_key(0x5);
+
+		const auto executed = interpreter.run(instruction_count);
+		return std::tuple{executed, interpreter.get_registers(), interpreter.get_last_fault().kind,
+			interpreter.get_video_memory()};
+	}
+}
+
+TEST_CASE("Specialized dispatch matches interpreter" *
+	doctest::description("Every opcode class and illegal encodings behave the same through the 64K handler table"))
+{
+	// Instructions executed after registers are set up, each case ends with a jump to itself
+	const auto cases = std::vector<std::vector<uint16_t>>{
+		{0x00E0},         // CLS
+		{0x00EE},         // RET with an empty stack
+		{0x0000},         // illegal
+		{0x0123},         // SYS addr, illegal
+		{0x1ABC},         // JP addr
+		{0x2ABC},         // CALL addr
+		{0x3005, 0x0000}, // SE Vx, byte - taken
+		{0x3006},         // SE Vx, byte - not taken
+		{0x4005},         // SNE Vx, byte
+		{0x5010, 0x0000}, // SE Vx, Vy
+		{0x5011},         // illegal
+		{0x6A77},         // LD Vx, byte
+		{0x76F0},         // ADD Vx, byte
+		{0x8230},         // LD Vx, Vy
+		{0x8231},         // OR Vx, Vy
+		{0x8232},         // AND Vx, Vy
+		{0x8233},         // XOR Vx, Vy
+		{0x8564},         // ADD Vx, Vy - carry
+		{0x8235},         // SUB Vx, Vy
+		{0x8326},         // SHR Vx
+		{0x8237},         // SUBN Vx, Vy
+		{0x836E},         // SHL Vx
+		{0x8238},         // illegal
+		{0x9010},         // SNE Vx, Vy
+		{0x9011},         // illegal
+		{0xABCD},         // LD I, addr
+		{0xB210},         // JP V0, addr
+		{0xC3A5},         // RND Vx, byte
+		{0xD235},         // DRW Vx, Vy, nibble
+		{0xE59E},         // SKP Vx - pressed
+		{0xE5A1},         // SKNP Vx
+		{0xE09E},         // SKP Vx - released
+		{0xE000},         // illegal
+		{0xF307, 0xF315}, // LD Vx, DT; LD DT, Vx
+		{0xF50A},         // LD Vx, K
+		{0xF318},         // LD ST, Vx
+		{0xF31E},         // ADD I, Vx
+		{0xF229},         // LD F, Vx
+		{0xF633},         // LD B, Vx
+		{0xF755},         // LD [I], Vx
+		{0xF765},         // LD Vx, [I]
+		{0xAFFE, 0xF755}, // LD [I], Vx past the end of memory
+		{0xAFFF, 0xD235}, // DRW past the end of memory
+		{0xF0FF}          // illegal
+	};
+
+	for (const auto& instructions : cases)
+	{
+		CAPTURE(instructions.front());
+
+		auto program = make_program(instructions);
+		const auto end = uint16_t(constants::code_start + program.size() * 2);
+		program.push_back(uint16_t(0x1000 | end)); // JP to itself
+
+		const auto rom = helpers::make_rom("specialized", program);
+		const auto instruction_count = program.size() + 4;
+		const auto [expected_executed, expected, expected_fault, expected_video] =
+			run(rom, execution_engine::interpreter, instruction_count);
+		const auto [executed, actual, actual_fault, video] = run(rom, execution_engine::specialized, instruction_count);
+
+		REQUIRE_EQ(executed, expected_executed);
+		REQUIRE_EQ(actual.v, expected.v);
+		REQUIRE_EQ(actual.i, expected.i);
+		REQUIRE_EQ(actual.pc, expected.pc);
+		REQUIRE_EQ(actual.sp, expected.sp);
+		REQUIRE_EQ(actual_fault, expected_fault);
+		REQUIRE_EQ(video, expected_video);
+	}
+}
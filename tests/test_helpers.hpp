@@ -1,6 +1,11 @@
 #include "constants.hpp"
 #include "instructions.hpp"
 
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
 using namespace chip8;
 
 namespace helpers
@@ -11,4 +16,49 @@ namespace helpers
 	{
 		return instr_t{std::byte{0x00}, std::byte{0x00}};
 	}
+
+	inline std::string to_rom_content(const std::vector<uint16_t>& program)
+	{
+		auto content = std::string{};
+		for (const auto opcode : program)
+		{
+			content.push_back(char(opcode >> 8));
+			content.push_back(char(opcode & 0xFF));
+		}
+
+		return content;
+	}
+
+	// File in temporary directory, which is removed when going out of scope
+	struct temporary_file
+	{
+		temporary_file(const std::string& name, const std::string& content) :
+			m_path{std::filesystem::temp_directory_path() / name}
+		{
+			auto writer = std::ofstream(this->m_path, std::ios_base::binary | std::ios_base::trunc);
+			writer << content;
+		}
+
+		~temporary_file()
+		{
+			std::filesystem::remove(this->m_path);
+		}
+
+		temporary_file(const temporary_file&) = delete;
+		temporary_file& operator=(const temporary_file&) = delete;
+
+		const std::filesystem::path& get_path() const noexcept
+		{
+			return this->m_path;
+		}
+
+	private:
+		std::filesystem::path m_path;
+	};
+
+	// Rom with program in a temporary file, roms loaded at the same time need different names
+	inline temporary_file make_rom(const std::string& name, const std::vector<uint16_t>& program)
+	{
+		return temporary_file("chip8_cpp_" + name + "_test.ch8", to_rom_content(program));
+	}
 }
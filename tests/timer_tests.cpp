@@ -4,138 +4,68 @@
 using namespace std::literals::chrono_literals;
 
 TEST_CASE("Timer at zero" *
-	doctest::description("Tests if timer does not change during update when it has already reached zero"))
+	doctest::description("Tests if timer stays at zero when it was never started"))
 {
-	auto test_reg = uint8_t{0};
-	auto timer = chip8::timer(test_reg, 10ms);
+	auto timer = chip8::timer(10ms);
 
 	for (size_t cnt = 0; cnt < 100; ++cnt)
-	{
-		timer.update(3ms);
-		REQUIRE_EQ(test_reg, 0);
-	}
+		REQUIRE_EQ(timer.get(cnt * 3ms), 0);
+
+	REQUIRE_EQ(timer.get_deadline(), 0ms);
 }
 
 TEST_CASE("Timer decrement" *
-	doctest::description("Tests timer behaviour when it is decremented"))
+	doctest::description("Tests timer value derived from machine time"))
 {
-	auto test_reg = uint8_t{0};
-
 	SUBCASE("Decrement once")
 	{
-		test_reg = 3;
-		auto timer = chip8::timer(test_reg, 5ms);
-		timer.update(6ms);
-		REQUIRE_EQ(test_reg, 2);
+		auto timer = chip8::timer(5ms);
+		timer.set(3, 0ms);
+		REQUIRE_EQ(timer.get(4ms), 3);
+		REQUIRE_EQ(timer.get(6ms), 2);
 	}
 
 	SUBCASE("Decrement five times")
 	{
-		test_reg = 10;
-		auto timer = chip8::timer(test_reg, 1ms);
+		auto timer = chip8::timer(1ms);
+		timer.set(10, 0ms);
 
 		for (size_t cnt = 0; cnt < 5; ++cnt)
-		{
-			timer.update(1ms);
-			REQUIRE_EQ(test_reg, 9 - cnt);
-		}
+			REQUIRE_EQ(timer.get((cnt + 1) * 1ms), 9 - cnt);
 	}
 
 	SUBCASE("Decrement to zero and beyond")
 	{
-		test_reg = 7;
-		auto timer = chip8::timer(test_reg, 1ms);
+		auto timer = chip8::timer(1ms);
+		timer.set(7, 0ms);
 
 		// First decrement to zero
 		for (size_t cnt = 0; cnt < 7; ++cnt)
-		{
-			timer.update(1ms);
-			REQUIRE_EQ(test_reg, 6 - cnt);
-		}
-
-		// Then continue doing so
-		for (size_t cnt = 0; cnt < 10; ++cnt)
-		{
-			timer.update(1ms);
-			REQUIRE_EQ(test_reg, 0);
-		}
-	}
-}
-
-TEST_CASE("Timer callbacks" *
-	doctest::description("Tests callbacks issued by timer"))
-{
-	auto test_reg = uint8_t{0};
-	auto is_start_called = false;
-	auto is_stop_called = false;
-
-	auto start_callback = [&is_start_called] {is_start_called = true;};
-	auto stop_callback = [&is_stop_called] {is_stop_called = true;};
+			REQUIRE_EQ(timer.get((cnt + 1) * 1ms), 6 - cnt);
 
-	SUBCASE("No callbacks at zero")
-	{
-		auto timer = chip8::timer(test_reg, 1ms, start_callback, stop_callback);
-		for (size_t cnt = 0; cnt < 10; ++cnt)
-		{
-			timer.update(500us);
-			REQUIRE_FALSE(is_start_called);
-			REQUIRE_FALSE(is_start_called);
-		}
-	}
-
-	SUBCASE("Stop callback at zero")
-	{
-		test_reg = 1;
-		auto timer = chip8::timer(test_reg, 1ms, start_callback, stop_callback);
-		timer.update(1ms);
-		REQUIRE_FALSE(is_start_called);
-		REQUIRE(is_stop_called);
-	}
+		// Then stay there
+		for (size_t cnt = 7; cnt < 17; ++cnt)
+			REQUIRE_EQ(timer.get((cnt + 1) * 1ms), 0);
 
-	SUBCASE("Stop callback at zero after multiple decrements")
-	{
-		test_reg = 3;
-		auto timer = chip8::timer(test_reg, 1ms, start_callback, stop_callback);
-		
-		// First two decrements should not invoke callbacks
-		for (size_t cnt = 0; cnt < 2; ++cnt)
-		{
-			timer.update(1ms);
-			REQUIRE_FALSE(is_start_called);
-			REQUIRE_FALSE(is_stop_called);
-		}
-
-		// Next decrement should trigger stop callback
-		timer.update(1ms);
-		REQUIRE_FALSE(is_start_called);
-		REQUIRE(is_stop_called);
-		is_stop_called = false;
-
-		// Following callbacks should not call any additional callbacks
-		for (size_t cnt = 0; cnt < 10; ++cnt)
-		{
-			timer.update(1ms);
-			REQUIRE_FALSE(is_start_called);
-			REQUIRE_FALSE(is_stop_called);
-		}
+		REQUIRE_EQ(timer.get_deadline(), 7ms);
 	}
 
-	SUBCASE("Stop callback at register update report, when register is == 0")
+	SUBCASE("Ticks are aligned to machine time")
 	{
-		auto timer = chip8::timer(test_reg, 1ms, start_callback, stop_callback);
-		timer.report_change();
-
-		REQUIRE_FALSE(is_start_called);
-		REQUIRE(is_stop_called);
+		// Setting timer in the middle of a tick period shortens its first decrement
+		auto timer = chip8::timer(10ms);
+		timer.set(2, 7ms);
+		REQUIRE_EQ(timer.get(9ms), 2);
+		REQUIRE_EQ(timer.get(10ms), 1);
+		REQUIRE_EQ(timer.get(20ms), 0);
+		REQUIRE_EQ(timer.get_deadline(), 20ms);
 	}
 
-	SUBCASE("Start callback at register update report, when register is > 0")
+	SUBCASE("Reset")
 	{
-		auto timer = chip8::timer(test_reg, 1ms, start_callback, stop_callback);
-		test_reg = 255;
-		timer.report_change();
-
-		REQUIRE(is_start_called);
-		REQUIRE_FALSE(is_stop_called);
+		auto timer = chip8::timer(1ms);
+		timer.set(255, 0ms);
+		timer.reset();
+		REQUIRE_EQ(timer.get(0ms), 0);
 	}
 }